@@ -0,0 +1,6 @@
+WRAP_CLASS("itk::ComponentTreeContainer" POINTER)
+  FOREACH(t ${WRAP_ITK_SCALAR})
+    WRAP_TEMPLATE("CTN${ITKM_${t}}SL${ITKM_UL}" "itk::ComponentTreeNode< ${ITKT_${t}}, signed long, ${ITKT_UL} >")
+    WRAP_TEMPLATE("CTN${ITKM_${t}}SL${ITKM_D}" "itk::ComponentTreeNode< ${ITKT_${t}}, signed long, ${ITKT_D} >")
+  ENDFOREACH(t)
+END_WRAP_CLASS()
@@ -0,0 +1,168 @@
+#include "itkImageFileReader.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkComponentTreeAccumulator.h"
+#include "itkFixedArray.h"
+#include <cmath>
+
+const int dim = 2;
+typedef unsigned char PType;
+typedef itk::Image< PType, dim > IType;
+
+typedef itk::ComponentTree< PType, dim, itk::FixedArray< long, 2 * dim > > BoxTreeType;
+typedef itk::ComponentTree< PType, dim, itk::FixedArray< double, dim > > MomentsTreeType;
+
+// compute the bounding box of a node and of its children by walking their
+// pixels, and compare it to the accumulated one
+int CheckBoundingBox( const BoxTreeType * tree, const BoxTreeType::NodeType * node, BoxTreeType::AttributeType & box )
+{
+  typedef BoxTreeType::NodeType NodeType;
+  int errors = 0;
+
+  for( int i=0; i<dim; i++ )
+    {
+    box[i] = itk::NumericTraits< long >::max();
+    box[ i + dim ] = itk::NumericTraits< long >::NonpositiveMin();
+    }
+
+  const NodeType::ChildrenListType & children = node->GetChildren();
+  for( NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+    {
+    BoxTreeType::AttributeType childBox;
+    errors += CheckBoundingBox( tree, *it, childBox );
+    for( int i=0; i<dim; i++ )
+      {
+      box[i] = std::min( box[i], childBox[i] );
+      box[ i + dim ] = std::max( box[ i + dim ], childBox[ i + dim ] );
+      }
+    }
+
+  for( NodeType::IndexType current=node->GetFirstIndex();
+     current != NodeType::EndIndex;
+     current = tree->GetLinkedListArray()[ current ] )
+    {
+    const BoxTreeType::IndexType idx = tree->ComputeIndex( current );
+    for( int i=0; i<dim; i++ )
+      {
+      box[i] = std::min( box[i], (long)idx[i] );
+      box[ i + dim ] = std::max( box[ i + dim ], (long)idx[i] );
+      }
+    }
+
+  if( box != node->GetAttribute() )
+    {
+    std::cerr << "Wrong bounding box at level " << (int)node->GetPixel() << ": "
+              << node->GetAttribute() << " instead of " << box << std::endl;
+    errors++;
+    }
+  return errors;
+}
+
+// same for the first moments
+int CheckFirstMoments( const MomentsTreeType * tree, const MomentsTreeType::NodeType * node, MomentsTreeType::AttributeType & moments )
+{
+  typedef MomentsTreeType::NodeType NodeType;
+  int errors = 0;
+
+  moments.Fill( 0 );
+
+  const NodeType::ChildrenListType & children = node->GetChildren();
+  for( NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+    {
+    MomentsTreeType::AttributeType childMoments;
+    errors += CheckFirstMoments( tree, *it, childMoments );
+    for( int i=0; i<dim; i++ )
+      {
+      moments[i] += childMoments[i];
+      }
+    }
+
+  for( NodeType::IndexType current=node->GetFirstIndex();
+     current != NodeType::EndIndex;
+     current = tree->GetLinkedListArray()[ current ] )
+    {
+    MomentsTreeType::PointType physicalPosition;
+    tree->TransformIndexToPhysicalPoint( tree->ComputeIndex( current ), physicalPosition );
+    for( int i=0; i<dim; i++ )
+      {
+      moments[i] += physicalPosition[i];
+      }
+    }
+
+  for( int i=0; i<dim; i++ )
+    {
+    // the sums are not done in the same order
+    if( std::fabs( moments[i] - node->GetAttribute()[i] ) > 1e-9 * std::max( 1.0, std::fabs( moments[i] ) ) )
+      {
+      std::cerr << "Wrong first moments at level " << (int)node->GetPixel() << ": "
+                << node->GetAttribute() << " instead of " << moments << std::endl;
+      errors++;
+      break;
+      }
+    }
+  return errors;
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 4 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity algorithm" << std::endl;
+    std::cerr << "  inputImage: an input image (dim=2)." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  algorithm: the algorithm used to build the tree" << std::endl;
+    std::cerr << "Compute the bounding box and the first moments of the nodes while the max" << std::endl;
+    std::cerr << "tree is built, and check them against the pixels of the nodes." << std::endl;
+    exit(1);
+    }
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::Functor::BoundingBoxComponentTreeAccumulator< BoxTreeType > BoxAccumulatorType;
+  typedef itk::ImageToMaximumTreeFilter< IType, BoxTreeType, BoxAccumulatorType > BoxMaxTreeType;
+  BoxMaxTreeType::Pointer boxMaxtree = BoxMaxTreeType::New();
+  boxMaxtree->SetInput( reader->GetOutput() );
+  boxMaxtree->SetFullyConnected( atoi( argv[2] ) );
+  boxMaxtree->SetAlgorithm( argv[3] );
+  itk::SimpleFilterWatcher watcher(boxMaxtree, "bounding box max-tree");
+  boxMaxtree->Update();
+
+  typedef itk::Functor::FirstMomentsComponentTreeAccumulator< MomentsTreeType > MomentsAccumulatorType;
+  typedef itk::ImageToMaximumTreeFilter< IType, MomentsTreeType, MomentsAccumulatorType > MomentsMaxTreeType;
+  MomentsMaxTreeType::Pointer momentsMaxtree = MomentsMaxTreeType::New();
+  momentsMaxtree->SetInput( reader->GetOutput() );
+  momentsMaxtree->SetFullyConnected( atoi( argv[2] ) );
+  momentsMaxtree->SetAlgorithm( argv[3] );
+  itk::SimpleFilterWatcher watcher2(momentsMaxtree, "first moments max-tree");
+  momentsMaxtree->Update();
+
+  int errors = 0;
+
+  BoxTreeType::AttributeType box;
+  errors += CheckBoundingBox( boxMaxtree->GetOutput(), boxMaxtree->GetOutput()->GetRoot(), box );
+
+  // the root contains all the pixels
+  const IType::RegionType & region = reader->GetOutput()->GetLargestPossibleRegion();
+  for( int i=0; i<dim; i++ )
+    {
+    if( box[i] != region.GetIndex()[i] || box[ i + dim ] != (long)( region.GetIndex()[i] + region.GetSize()[i] - 1 ) )
+      {
+      std::cerr << "The bounding box of the root " << box << " is not the image region." << std::endl;
+      errors++;
+      break;
+      }
+    }
+
+  MomentsTreeType::AttributeType moments;
+  errors += CheckFirstMoments( momentsMaxtree->GetOutput(), momentsMaxtree->GetOutput()->GetRoot(), moments );
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+#include "itkRGBPixel.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToAlphaTreeFilter.h"
+#include "itkComponentTreeAccumulator.h"
+#include "itkAttributeFilteringComponentTreeToImageFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc != 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity size" << std::endl;
+    std::cerr << "  inputImage: an input color image (up to dim=3)." << std::endl;
+    std::cerr << "  outputImage: the alpha level of the smallest component of each pixel with at least size pixels." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  size: the minimum size of the components" << std::endl;
+    exit(1);
+    }
+    
+  const int dim = 3;
+  
+  typedef unsigned char PType;
+  typedef itk::RGBPixel< PType > RGBPType;
+  typedef itk::Image< RGBPType, dim > RGBIType;
+  typedef itk::Image< PType, dim > IType;
+
+  // the value of the nodes is the alpha level, not a pixel value
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< RGBIType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  // a single tree for the three channels
+  typedef itk::Functor::NumberOfPixelsComponentTreeAccumulator< TreeType::NodeType > AccumulatorType;
+  typedef itk::Functor::MaximumComponentDifference< RGBPType, PType > DissimilarityType;
+  typedef itk::ImageToAlphaTreeFilter< RGBIType, TreeType, DissimilarityType, AccumulatorType > AlphaTreeType;
+  AlphaTreeType::Pointer alphatree = AlphaTreeType::New();
+  alphatree->SetInput( reader->GetOutput() );
+  alphatree->SetFullyConnected( atoi( argv[3] ) );
+  itk::SimpleFilterWatcher watcher(alphatree, "alpha tree");
+
+  typedef itk::AttributeFilteringComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer filter2 = T2IType::New();
+  filter2->SetInput( alphatree->GetOutput() );
+  filter2->SetLambda( atoi( argv[4] ) );
+  filter2->SetFilteringType( T2IType::DIRECT );
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( filter2->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  return 0;
+}
+
@@ -0,0 +1,187 @@
+#include "itkImage.h"
+#include "itkRGBPixel.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToAlphaTreeFilter.h"
+#include "itkComponentTreeAccumulator.h"
+#include "itkAttributeFilteringComponentTreeToImageFilter.h"
+#include <vector>
+
+int main(int argc, char * argv[])
+{
+  if( argc != 2 )
+    {
+    std::cerr << "usage: " << argv[0] << " connectivity" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "Build the alpha tree of a small synthetic color image, and check it" << std::endl;
+    std::cerr << "against the known tree." << std::endl;
+    exit(1);
+    }
+    
+  const int dim = 3;
+  const bool fullyConnected = atoi( argv[1] );
+  
+  typedef unsigned char PType;
+  typedef itk::RGBPixel< PType > RGBPType;
+  typedef itk::Image< RGBPType, dim > RGBIType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  // three vertical stripes of 3 pixels, A, B and C. A and B differ by 20 on
+  // the green channel, B and C by 5 on the blue channel and 2 on the red
+  // channel. Two pixels of A touching only by a corner, D, differ from A by
+  // 50 on the blue channel. A has 10 pixels, B and C 12, and D 2.
+  // zone:  A A A B B B C C C
+  //        D A A B B B C C C
+  //        A D A B B B C C C
+  //        A A A B B B C C C
+  enum { A=0, B=1, C=2, D=3 };
+  RGBPType colors[4];
+  colors[A].Set( 10, 0, 0 );
+  colors[B].Set( 10, 20, 0 );
+  colors[C].Set( 12, 20, 5 );
+  colors[D].Set( 10, 0, 50 );
+
+  RGBIType::IndexType idx;
+  idx.Fill( 0 );
+  RGBIType::SizeType size;
+  size[0] = 9;
+  size[1] = 4;
+  size[2] = 1;
+  RGBIType::RegionType region( idx, size );
+
+  RGBIType::Pointer image = RGBIType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::Image< int, dim >::Pointer zones = itk::Image< int, dim >::New();
+  zones->SetRegions( region );
+  zones->Allocate();
+  for( itk::ImageRegionIteratorWithIndex< RGBIType > it( image, region ); !it.IsAtEnd(); ++it )
+    {
+    const RGBIType::IndexType & i = it.GetIndex();
+    int zone = i[0] / 3;
+    if( zone == A && i[0] + 1 == i[1] && i[1] < 3 )
+      {
+      zone = D;
+      }
+    it.Set( colors[zone] );
+    zones->SetPixel( i, zone );
+    }
+
+  typedef itk::Functor::NumberOfPixelsComponentTreeAccumulator< TreeType::NodeType > AccumulatorType;
+  typedef itk::Functor::MaximumComponentDifference< RGBPType, PType > DissimilarityType;
+  typedef itk::ImageToAlphaTreeFilter< RGBIType, TreeType, DissimilarityType, AccumulatorType > AlphaTreeType;
+  AlphaTreeType::Pointer alphatree = AlphaTreeType::New();
+  alphatree->SetInput( image );
+  alphatree->SetFullyConnected( fullyConnected );
+  alphatree->Update();
+  const TreeType * tree = alphatree->GetOutput();
+
+  int errors = 0;
+
+  // the root is the whole image, at the largest dissimilarity
+  const TreeType::NodeType * root = tree->GetRoot();
+  if( root->GetPixel() != 50 || root->GetAttribute() != region.GetNumberOfPixels() )
+    {
+    std::cerr << "Wrong root: alpha " << (int)root->GetPixel() << ", size " << root->GetAttribute() << std::endl;
+    errors++;
+    }
+
+  // the leaves are the flat zones: the two pixels of D are a single flat
+  // zone only with the full connectivity
+  const unsigned long expectedLeaves = fullyConnected ? 4 : 5;
+  unsigned long leaves = 0;
+  unsigned long nodes = 0;
+  std::vector< const TreeType::NodeType * > stack;
+  stack.push_back( root );
+  while( !stack.empty() )
+    {
+    const TreeType::NodeType * node = stack.back();
+    stack.pop_back();
+    nodes++;
+    const TreeType::NodeType::ChildrenListType & children = node->GetChildren();
+    for( TreeType::NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+      {
+      stack.push_back( *it );
+      }
+    if( !node->IsLeaf() )
+      {
+      if( node->GetFirstIndex() != TreeType::NodeType::EndIndex )
+        {
+        std::cerr << "A node which is not a leaf has some pixels." << std::endl;
+        errors++;
+        }
+      continue;
+      }
+    leaves++;
+    if( node->GetPixel() != 0 )
+      {
+      std::cerr << "A leaf has the alpha level " << (int)node->GetPixel() << std::endl;
+      errors++;
+      }
+    // all the pixels of a leaf have the same color
+    const RGBPType & color = image->GetPixel( tree->ComputeIndex( node->GetFirstIndex() ) );
+    for( TreeType::NodeType::IndexType current=node->GetFirstIndex();
+         current != TreeType::NodeType::EndIndex;
+         current = tree->GetLinkedListArray()[ current ] )
+      {
+      if( image->GetPixel( tree->ComputeIndex( current ) ) != color )
+        {
+        std::cerr << "A leaf is not a flat zone." << std::endl;
+        errors++;
+        break;
+        }
+      }
+    }
+  if( leaves != expectedLeaves )
+    {
+    std::cerr << "Wrong number of leaves: " << leaves << " instead of " << expectedLeaves << std::endl;
+    errors++;
+    }
+  // the leaves, B+C at 5, A+B+C at 20 and the root
+  if( nodes != expectedLeaves + 3 )
+    {
+    std::cerr << "Wrong number of nodes: " << nodes << " instead of " << expectedLeaves + 3 << std::endl;
+    errors++;
+    }
+
+  // the alpha level of each zone, in the smallest component with at least
+  // lambda pixels. A has 10 pixels, B and C 12, and D 2.
+  const unsigned long lambdas[6] = { 1, 3, 11, 13, 25, 35 };
+  const PType expected[6][4] = {
+    {  0,  0,  0,  0 },
+    {  0,  0,  0, 50 },
+    { 20,  0,  0, 50 },
+    { 20,  5,  5, 50 },
+    { 20, 20, 20, 50 },
+    { 50, 50, 50, 50 } };
+
+  typedef itk::AttributeFilteringComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer filter2 = T2IType::New();
+  filter2->SetInput( tree );
+  filter2->SetFilteringType( T2IType::DIRECT );
+  for( int l=0; l<6; l++ )
+    {
+    filter2->SetLambda( lambdas[l] );
+    filter2->Update();
+    for( itk::ImageRegionIteratorWithIndex< IType > it( filter2->GetOutput(), region ); !it.IsAtEnd(); ++it )
+      {
+      const int zone = zones->GetPixel( it.GetIndex() );
+      if( it.Get() != expected[l][zone] )
+        {
+        std::cerr << "Wrong alpha level at " << it.GetIndex() << " with lambda " << lambdas[l] << ": "
+                  << (int)it.Get() << " instead of " << (int)expected[l][zone] << std::endl;
+        errors++;
+        }
+      }
+    }
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}
+
@@ -0,0 +1,60 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+#include "itkVectorImage.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkAttributeProfileComponentTreeToImageFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc < 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity lambda [lambda ...]" << std::endl;
+    std::cerr << "  inputImage: an input image." << std::endl;
+    std::cerr << "  outputImage: the output image, with a component per lambda." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  lambda: the minimum number of pixels of the regional maxima" << std::endl;
+    exit(1);
+    }
+
+  const int dim = 2;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+  typedef itk::VectorImage< PType, dim > VIType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[3] ) );
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType > IIType;
+  IIType::Pointer ii = IIType::New();
+  ii->SetInput( maxtree->GetOutput() );
+
+  typedef itk::AttributeProfileComponentTreeToImageFilter< TreeType, VIType > ProfileType;
+  ProfileType::Pointer profile = ProfileType::New();
+  profile->SetInput( ii->GetOutput() );
+  for( int i=4; i<argc; i++ )
+    {
+    profile->AddLambda( atoi( argv[i] ) );
+    }
+  itk::SimpleFilterWatcher watcher(profile, "filter");
+
+  typedef itk::ImageFileWriter< VIType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( profile->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkVectorImage.h"
+#include "itkVectorIndexSelectionCastImageFilter.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkAttributeProfileComponentTreeToImageFilter.h"
+#include "itkAttributeFilteringComponentTreeToImageFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc < 4 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity lambda [lambda ...]" << std::endl;
+    std::cerr << "  inputImage: an input image." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  lambda: the minimum number of pixels of the regional maxima" << std::endl;
+    std::cerr << "Compute the attribute profile of an image, and check each component against" << std::endl;
+    std::cerr << "the attribute opening with the same lambda." << std::endl;
+    exit(1);
+    }
+
+  const int dim = 2;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+  typedef itk::VectorImage< PType, dim > VIType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[2] ) );
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType > IIType;
+  IIType::Pointer ii = IIType::New();
+  ii->SetInput( maxtree->GetOutput() );
+
+  // the lambdas are kept in the user order, which doesn't need to be sorted
+  typedef itk::AttributeProfileComponentTreeToImageFilter< TreeType, VIType > ProfileType;
+  ProfileType::Pointer profile = ProfileType::New();
+  profile->SetInput( ii->GetOutput() );
+  for( int i=3; i<argc; i++ )
+    {
+    profile->AddLambda( atoi( argv[i] ) );
+    }
+  profile->Update();
+
+  if( profile->GetOutput()->GetNumberOfComponentsPerPixel() != profile->GetLambdas().size() )
+    {
+    std::cerr << "Wrong number of components: " << profile->GetOutput()->GetNumberOfComponentsPerPixel()
+              << " instead of " << profile->GetLambdas().size() << std::endl;
+    return 1;
+    }
+
+  typedef itk::VectorIndexSelectionCastImageFilter< VIType, IType > SelectionType;
+  typedef itk::AttributeFilteringComponentTreeToImageFilter< TreeType, IType > T2IType;
+
+  int errors = 0;
+  for( unsigned int i=0; i<profile->GetLambdas().size(); i++ )
+    {
+    SelectionType::Pointer selection = SelectionType::New();
+    selection->SetInput( profile->GetOutput() );
+    selection->SetIndex( i );
+    selection->Update();
+
+    T2IType::Pointer opening = T2IType::New();
+    opening->SetInput( ii->GetOutput() );
+    opening->SetLambda( profile->GetLambdas()[i] );
+    opening->SetFilteringType( T2IType::MAXIMUM );
+    opening->Update();
+
+    unsigned long differences = 0;
+    itk::ImageRegionConstIterator< IType > oit( opening->GetOutput(), opening->GetOutput()->GetLargestPossibleRegion() );
+    for( itk::ImageRegionConstIterator< IType > sit( selection->GetOutput(), selection->GetOutput()->GetLargestPossibleRegion() ); !sit.IsAtEnd(); ++sit, ++oit )
+      {
+      if( sit.Get() != oit.Get() )
+        {
+        differences++;
+        }
+      }
+    if( differences != 0 )
+      {
+      std::cerr << "The component " << i << " differs from the opening with lambda "
+                << profile->GetLambdas()[i] << " on " << differences << " pixels." << std::endl;
+      errors++;
+      }
+    }
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include "itkImageFileReader.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkLocalIntensityComponentTreeFilter.h"
+#include "itkComponentTreeAttributeStatisticsFilter.h"
+
+namespace itk
+{
+
+namespace Functor {
+
+template< class TComponentTreeNode, class TAttribute, int VIndex >
+class ITK_EXPORT ArrayAttributeComponentTreeNodeAccessor
+{
+public:
+  typedef TComponentTreeNode ComponentTreeNodeType;
+  typedef TAttribute AttributeType;
+  itkStaticConstMacro(Index, unsigned int, VIndex);
+
+  inline const AttributeType operator()( const ComponentTreeNodeType * node )
+    {
+    return node->GetAttribute()[ Index ];
+    }
+
+  inline void operator()( ComponentTreeNodeType * node, const AttributeType & value )
+    {
+    node->GetAttribute()[ Index ] = value;
+    }
+};
+
+}
+
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 4 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity bins" << std::endl;
+    std::cerr << "  inputImage: an input image." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  bins: the number of bins of the histograms" << std::endl;
+    exit(1);
+    }
+
+  const int dim = 2;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, itk::FixedArray< double, 2 > > TreeType;
+  typedef TreeType::NodeType NodeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[2] ) );
+
+  typedef itk::Functor::ArrayAttributeComponentTreeNodeAccessor< NodeType, double, 0 > SizeAccessor;
+  typedef itk::Functor::ArrayAttributeComponentTreeNodeAccessor< NodeType, double, 1 > ContrastAccessor;
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType, SizeAccessor > SizeType;
+  SizeType::Pointer size = SizeType::New();
+  size->SetInput( maxtree->GetOutput() );
+
+  typedef itk::LocalIntensityComponentTreeFilter< TreeType, ContrastAccessor > ContrastType;
+  ContrastType::Pointer contrast = ContrastType::New();
+  contrast->SetInput( size->GetOutput() );
+  contrast->SetUseZeroLeaves( true );
+
+  typedef itk::Functor::ArrayMeasurementComponentTreeNodeAccessor< NodeType > MeasurementAccessorType;
+  typedef itk::ComponentTreeAttributeStatisticsFilter< TreeType, MeasurementAccessorType > StatisticsType;
+  StatisticsType::Pointer stats = StatisticsType::New();
+  stats->SetInput( contrast->GetOutput() );
+  stats->SetNumberOfBins( atoi( argv[3] ) );
+  unsigned int joint = stats->AddJointHistogram( 0, 1 );
+  itk::SimpleFilterWatcher watcher(stats, "filter");
+  stats->Update();
+
+  const char * names[] = { "size", "contrast" };
+  std::cout << "nodes: " << stats->GetNumberOfNodes() << std::endl;
+  for( unsigned int i=0; i<2; i++ )
+    {
+    std::cout << names[i] << ":"
+              << "  min: " << stats->GetMinimum( i )
+              << "  max: " << stats->GetMaximum( i )
+              << "  mean: " << stats->GetMean( i );
+    for( unsigned int q=0; q<stats->GetQuantiles().size(); q++ )
+      {
+      std::cout << "  q" << stats->GetQuantiles()[q] << ": " << stats->GetQuantile( i, q );
+      }
+    std::cout << std::endl;
+    }
+
+  const StatisticsType::HistogramType * histogram = stats->GetJointHistogram( joint );
+  std::cout << "size/contrast joint histogram: " << histogram->GetTotalFrequency() << " nodes in "
+            << histogram->Size() << " bins" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,213 @@
+#include "itkImageFileReader.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkLocalIntensityComponentTreeFilter.h"
+#include "itkComponentTreeAttributeStatisticsFilter.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+namespace Functor {
+
+template< class TComponentTreeNode, class TAttribute, int VIndex >
+class ITK_EXPORT ArrayAttributeComponentTreeNodeAccessor
+{
+public:
+  typedef TComponentTreeNode ComponentTreeNodeType;
+  typedef TAttribute AttributeType;
+  itkStaticConstMacro(Index, unsigned int, VIndex);
+
+  inline const AttributeType operator()( const ComponentTreeNodeType * node )
+    {
+    return node->GetAttribute()[ Index ];
+    }
+
+  inline void operator()( ComponentTreeNodeType * node, const AttributeType & value )
+    {
+    node->GetAttribute()[ Index ] = value;
+    }
+};
+
+}
+
+}
+
+const int dim = 2;
+typedef unsigned char PType;
+typedef itk::Image< PType, dim > IType;
+typedef itk::ComponentTree< PType, dim, itk::FixedArray< double, 2 > > TreeType;
+typedef TreeType::NodeType NodeType;
+
+// the values of a component of the attribute of all the nodes
+void CollectValues( const NodeType * node, unsigned int component, std::vector< double > & values )
+{
+  values.push_back( node->GetAttribute()[ component ] );
+  const NodeType::ChildrenListType & children = node->GetChildren();
+  for( NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+    {
+    CollectValues( *it, component, values );
+    }
+}
+
+// the bin of a value, with the bins spread uniformly between the minimum and
+// the maximum
+unsigned int ComputeBin( double value, double minimum, double maximum, unsigned int nbOfBins )
+{
+  const double range = maximum - minimum;
+  if( range <= 0 )
+    {
+    return 0;
+    }
+  return std::min( static_cast< unsigned int >( ( value - minimum ) / range * nbOfBins ), nbOfBins - 1 );
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity bins threads" << std::endl;
+    std::cerr << "  inputImage: an input image." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  bins: the number of bins of the histograms" << std::endl;
+    std::cerr << "  threads: the number of threads used to compute the statistics" << std::endl;
+    std::cerr << "Compute the statistics of the size and of the contrast of the nodes, and" << std::endl;
+    std::cerr << "check them against the values of the nodes." << std::endl;
+    exit(1);
+    }
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[2] ) );
+
+  typedef itk::Functor::ArrayAttributeComponentTreeNodeAccessor< NodeType, double, 0 > SizeAccessor;
+  typedef itk::Functor::ArrayAttributeComponentTreeNodeAccessor< NodeType, double, 1 > ContrastAccessor;
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType, SizeAccessor > SizeType;
+  SizeType::Pointer size = SizeType::New();
+  size->SetInput( maxtree->GetOutput() );
+
+  typedef itk::LocalIntensityComponentTreeFilter< TreeType, ContrastAccessor > ContrastType;
+  ContrastType::Pointer contrast = ContrastType::New();
+  contrast->SetInput( size->GetOutput() );
+  contrast->SetUseZeroLeaves( true );
+  contrast->Update();
+
+  const unsigned int nbOfBins = atoi( argv[3] );
+
+  typedef itk::Functor::ArrayMeasurementComponentTreeNodeAccessor< NodeType > MeasurementAccessorType;
+  typedef itk::ComponentTreeAttributeStatisticsFilter< TreeType, MeasurementAccessorType > StatisticsType;
+  StatisticsType::Pointer stats = StatisticsType::New();
+  stats->SetInput( contrast->GetOutput() );
+  stats->SetNumberOfBins( nbOfBins );
+  stats->SetNumberOfThreads( atoi( argv[4] ) );
+  unsigned int joint = stats->AddJointHistogram( 0, 1 );
+  stats->Update();
+
+  const char * names[] = { "size", "contrast" };
+  int errors = 0;
+
+  std::vector< double > values[2];
+  for( unsigned int i=0; i<2; i++ )
+    {
+    CollectValues( contrast->GetOutput()->GetRoot(), i, values[i] );
+    const unsigned long n = values[i].size();
+    if( stats->GetNumberOfNodes() != n )
+      {
+      std::cerr << "Wrong number of nodes: " << stats->GetNumberOfNodes() << " instead of " << n << std::endl;
+      return 1;
+      }
+
+    std::vector< double > sorted = values[i];
+    std::sort( sorted.begin(), sorted.end() );
+    double sum = 0;
+    for( unsigned long v=0; v<n; v++ )
+      {
+      sum += sorted[v];
+      }
+
+    if( stats->GetMinimum( i ) != sorted.front() || stats->GetMaximum( i ) != sorted.back() )
+      {
+      std::cerr << names[i] << ": wrong range [" << stats->GetMinimum( i ) << ", " << stats->GetMaximum( i )
+                << "] instead of [" << sorted.front() << ", " << sorted.back() << "]" << std::endl;
+      errors++;
+      }
+
+    // the sums are not done in the same order
+    const double mean = sum / n;
+    if( std::fabs( stats->GetMean( i ) - mean ) > 1e-9 * std::max( 1.0, std::fabs( mean ) ) )
+      {
+      std::cerr << names[i] << ": wrong mean " << stats->GetMean( i ) << " instead of " << mean << std::endl;
+      errors++;
+      }
+
+    for( unsigned int q=0; q<stats->GetQuantiles().size(); q++ )
+      {
+      const double quantile = sorted[ static_cast< unsigned long >( stats->GetQuantiles()[q] * ( n - 1 ) ) ];
+      if( stats->GetQuantile( i, q ) != quantile )
+        {
+        std::cerr << names[i] << ": wrong quantile " << stats->GetQuantiles()[q] << ": "
+                  << stats->GetQuantile( i, q ) << " instead of " << quantile << std::endl;
+        errors++;
+        }
+      }
+
+    std::vector< unsigned long > frequencies( nbOfBins, 0 );
+    for( unsigned long v=0; v<n; v++ )
+      {
+      frequencies[ ComputeBin( values[i][v], sorted.front(), sorted.back(), nbOfBins ) ]++;
+      }
+    const StatisticsType::HistogramType * histogram = stats->GetHistogram( i );
+    for( unsigned int b=0; b<nbOfBins; b++ )
+      {
+      if( histogram->GetFrequency( b ) != frequencies[b] )
+        {
+        std::cerr << names[i] << ": wrong frequency in bin " << b << ": " << histogram->GetFrequency( b )
+                  << " instead of " << frequencies[b] << std::endl;
+        errors++;
+        }
+      }
+    }
+
+  // the joint histogram
+  std::vector< unsigned long > frequencies( nbOfBins * nbOfBins, 0 );
+  for( unsigned long v=0; v<values[0].size(); v++ )
+    {
+    const unsigned int b0 = ComputeBin( values[0][v], stats->GetMinimum( 0 ), stats->GetMaximum( 0 ), nbOfBins );
+    const unsigned int b1 = ComputeBin( values[1][v], stats->GetMinimum( 1 ), stats->GetMaximum( 1 ), nbOfBins );
+    frequencies[ b0 + b1 * nbOfBins ]++;
+    }
+  const StatisticsType::HistogramType * histogram = stats->GetJointHistogram( joint );
+  StatisticsType::HistogramType::IndexType index;
+  index.SetSize( 2 );
+  for( unsigned int b1=0; b1<nbOfBins; b1++ )
+    {
+    for( unsigned int b0=0; b0<nbOfBins; b0++ )
+      {
+      index[0] = b0;
+      index[1] = b1;
+      if( histogram->GetFrequency( histogram->GetInstanceIdentifier( index ) ) != frequencies[ b0 + b1 * nbOfBins ] )
+        {
+        std::cerr << "Wrong frequency in the joint histogram at " << b0 << ", " << b1 << ": "
+                  << histogram->GetFrequency( histogram->GetInstanceIdentifier( index ) )
+                  << " instead of " << frequencies[ b0 + b1 * nbOfBins ] << std::endl;
+        errors++;
+        }
+      }
+    }
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}
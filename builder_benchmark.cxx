@@ -0,0 +1,65 @@
+#include "itkImageFileReader.h"
+#include "itkTimeProbe.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc < 3 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity [nbOfRuns]" << std::endl;
+    std::cerr << "  inputImage: an input image (up to dim=3)" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  nbOfRuns: the number of times the tree is built with each algorithm. Default is 10." << std::endl;
+    exit(1);
+    }
+    
+  const int dim = 3;
+  
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  reader->Update();
+
+  int nbOfRuns = 10;
+  if( argc > 3 )
+    {
+    nbOfRuns = atoi( argv[3] );
+    }
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( reader->GetOutput() );
+  filter->SetFullyConnected( atoi( argv[2] ) );
+
+  const int algorithms[] = { FilterType::UNION_FIND, FilterType::FLOODING, FilterType::RANK_TRANSFORM, FilterType::FLAT_ZONES, FilterType::AUTO };
+  const int nbOfAlgorithms = sizeof( algorithms ) / sizeof( int );
+
+  std::cout << "algorithm" << "\t" << "mean time (s)" << std::endl;
+  for( int a=0; a<nbOfAlgorithms; a++ )
+    {
+    filter->SetAlgorithm( algorithms[a] );
+    itk::TimeProbe time;
+    for( int i=0; i<nbOfRuns; i++ )
+      {
+      filter->Modified();
+      time.Start();
+      filter->Update();
+      time.Stop();
+      }
+    std::cout << FilterType::GetNameFromAlgorithm( algorithms[a] );
+    if( algorithms[a] == FilterType::AUTO )
+      {
+      std::cout << " (" << FilterType::GetNameFromAlgorithm( filter->GetSelectedAlgorithm() ) << ")";
+      }
+    std::cout << "\t" << time.GetMeanTime() << std::endl;
+    }
+
+  return 0;
+}
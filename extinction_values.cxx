@@ -0,0 +1,78 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkLocalIntensityComponentTreeFilter.h"
+#include "itkExtinctionValuesComponentTreeFilter.h"
+#include "itkComponentTreeAttributeToImageFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc != 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity attribute" << std::endl;
+    std::cerr << "  inputImage: an input image." << std::endl;
+    std::cerr << "  outputImage: the extinction values on the regional maxima, and 0 elsewhere." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  attribute: Area or Dynamics" << std::endl;
+    exit(1);
+    }
+
+  const int dim = 2;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef unsigned long RType;
+  typedef itk::Image< RType, dim > RIType;
+
+  typedef itk::ComponentTree< PType, dim, RType > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[3] ) );
+
+  typedef itk::InPlaceComponentTreeFilter< TreeType > AttributeType;
+  AttributeType::Pointer attribute;
+  std::string attributeName = argv[4];
+  if( attributeName == "Area" )
+    {
+    attribute = itk::NumberOfPixelsComponentTreeFilter< TreeType >::New().GetPointer();
+    }
+  else if( attributeName == "Dynamics" )
+    {
+    attribute = itk::LocalIntensityComponentTreeFilter< TreeType >::New().GetPointer();
+    }
+  else
+    {
+    std::cerr << "Unknown attribute: " << attributeName << std::endl;
+    exit(1);
+    }
+  attribute->SetInput( maxtree->GetOutput() );
+
+  typedef itk::ExtinctionValuesComponentTreeFilter< TreeType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( attribute->GetOutput() );
+  itk::SimpleFilterWatcher watcher(filter, "filter");
+
+  typedef itk::ComponentTreeAttributeToImageFilter< TreeType, RIType > T2IType;
+  T2IType::Pointer filter2 = T2IType::New();
+  filter2->SetInput( filter->GetOutput() );
+
+  typedef itk::ImageFileWriter< RIType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( filter2->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  return 0;
+}
+
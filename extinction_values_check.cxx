@@ -0,0 +1,133 @@
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkLocalIntensityComponentTreeFilter.h"
+#include "itkExtinctionValuesComponentTreeFilter.h"
+#include "itkNumericTraits.h"
+
+const int dim = 2;
+typedef unsigned char PType;
+typedef itk::Image< PType, dim > IType;
+typedef unsigned long RType;
+typedef itk::ComponentTree< PType, dim, RType > TreeType;
+
+// compare the attribute of the node of a pixel to the expected one
+int CheckPixel( const TreeType * tree, long x, long y, RType expected, const char * name )
+{
+  TreeType::IndexType idx;
+  idx[0] = x;
+  idx[1] = y;
+  const RType value = tree->GetNode( idx )->GetAttribute();
+  if( value != expected )
+    {
+    std::cerr << name << ": wrong extinction value at " << idx << ": " << value
+              << " instead of " << expected << std::endl;
+    return 1;
+    }
+  return 0;
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 2 )
+    {
+    std::cerr << "usage: " << argv[0] << " connectivity" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "Compute the extinction values of the area and of the dynamics on a small" << std::endl;
+    std::cerr << "synthetic image, and check them against the known ones." << std::endl;
+    exit(1);
+    }
+
+  // three regional maxima on a background at 0: a pixel at 100 and a line
+  // of 3 pixels at 80 on the same plateau at 50, and a line of 2 pixels at
+  // 120 on its own
+  IType::IndexType idx;
+  idx.Fill( 0 );
+  IType::SizeType size;
+  size[0] = 20;
+  size[1] = 5;
+  IType::RegionType region( idx, size );
+
+  IType::Pointer image = IType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  for( itk::ImageRegionIteratorWithIndex< IType > it( image, region ); !it.IsAtEnd(); ++it )
+    {
+    const IType::IndexType & i = it.GetIndex();
+    PType value = 0;
+    if( i[0] >= 1 && i[0] <= 8 && i[1] >= 1 && i[1] <= 3 )
+      {
+      value = 50;
+      }
+    if( i[0] == 2 && i[1] == 2 )
+      {
+      value = 100;
+      }
+    if( i[0] >= 5 && i[0] <= 7 && i[1] == 2 )
+      {
+      value = 80;
+      }
+    if( i[0] >= 14 && i[0] <= 15 && i[1] == 2 )
+      {
+      value = 120;
+      }
+    it.Set( value );
+    }
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( image );
+  maxtree->SetFullyConnected( atoi( argv[1] ) );
+
+  typedef itk::ExtinctionValuesComponentTreeFilter< TreeType > FilterType;
+  int errors = 0;
+
+  // area: the leaf at 80 is the greatest one on the plateau and survives up
+  // to the root, so it gets the area of the image. The two other ones
+  // disappear with their own area.
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType > AreaType;
+  AreaType::Pointer area = AreaType::New();
+  area->SetInput( maxtree->GetOutput() );
+  // the max tree is used by the two attributes
+  area->SetInPlace( false );
+
+  FilterType::Pointer areaExtinction = FilterType::New();
+  areaExtinction->SetInput( area->GetOutput() );
+  areaExtinction->Update();
+
+  const TreeType * tree = areaExtinction->GetOutput();
+  errors += CheckPixel( tree, 2, 2, 1, "Area" );
+  errors += CheckPixel( tree, 6, 2, region.GetNumberOfPixels(), "Area" );
+  errors += CheckPixel( tree, 14, 2, 2, "Area" );
+  // the nodes which are not leaves
+  errors += CheckPixel( tree, 1, 1, 0, "Area" );
+  errors += CheckPixel( tree, 0, 0, 0, "Area" );
+
+  // dynamics: the leaf at 120 is the global maximum, with the attribute of
+  // the root. The leaf at 100 must go down to 0 to reach it, and the leaf
+  // at 80 must go down to 50 to reach the leaf at 100.
+  typedef itk::LocalIntensityComponentTreeFilter< TreeType > DynamicsType;
+  DynamicsType::Pointer dynamics = DynamicsType::New();
+  dynamics->SetInput( maxtree->GetOutput() );
+  dynamics->SetInPlace( false );
+
+  FilterType::Pointer dynamicsExtinction = FilterType::New();
+  dynamicsExtinction->SetInput( dynamics->GetOutput() );
+  dynamicsExtinction->Update();
+
+  tree = dynamicsExtinction->GetOutput();
+  errors += CheckPixel( tree, 2, 2, 100, "Dynamics" );
+  errors += CheckPixel( tree, 6, 2, 30, "Dynamics" );
+  errors += CheckPixel( tree, 14, 2, itk::NumericTraits< RType >::max(), "Dynamics" );
+  errors += CheckPixel( tree, 1, 1, 0, "Dynamics" );
+  errors += CheckPixel( tree, 0, 0, 0, "Dynamics" );
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}
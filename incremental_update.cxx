@@ -0,0 +1,236 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkComponentTreeAccumulator.h"
+#include "itkComponentTreeIncrementalUpdater.h"
+#include "itkComponentTreeToImageFilter.h"
+#include "itkAttributeFilteringComponentTreeToImageFilter.h"
+#include "itkNumericTraits.h"
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+const int dim = 3;
+typedef unsigned char PType;
+typedef itk::Image< PType, dim > IType;
+typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+typedef itk::Functor::NumberOfPixelsComponentTreeAccumulator< TreeType::NodeType > AccumulatorType;
+typedef itk::ImageToMaximumTreeFilter< IType, TreeType, AccumulatorType > MaxTreeType;
+typedef itk::Functor::SumComponentTreeAccumulator< TreeType::NodeType > SumAccumulatorType;
+typedef itk::ImageToMaximumTreeFilter< IType, TreeType, SumAccumulatorType > SumMaxTreeType;
+
+unsigned long CountNodes( const TreeType * tree )
+{
+  unsigned long count = 0;
+  std::vector< const TreeType::NodeType * > stack;
+  stack.push_back( tree->GetRoot() );
+  while( !stack.empty() )
+    {
+    const TreeType::NodeType * node = stack.back();
+    stack.pop_back();
+    count++;
+    stack.insert( stack.end(), node->GetChildren().begin(), node->GetChildren().end() );
+    }
+  return count;
+}
+
+// the level and the attribute of all the nodes, sorted
+std::vector< std::pair< PType, unsigned long > > NodeAttributes( const TreeType * tree )
+{
+  std::vector< std::pair< PType, unsigned long > > attributes;
+  std::vector< const TreeType::NodeType * > stack;
+  stack.push_back( tree->GetRoot() );
+  while( !stack.empty() )
+    {
+    const TreeType::NodeType * node = stack.back();
+    stack.pop_back();
+    attributes.push_back( std::make_pair( node->GetPixel(), node->GetAttribute() ) );
+    stack.insert( stack.end(), node->GetChildren().begin(), node->GetChildren().end() );
+    }
+  std::sort( attributes.begin(), attributes.end() );
+  return attributes;
+}
+
+// compare the sums of the updated tree, including the ones of the kept
+// ancestors of the rebuilt nodes, with the ones of a tree built again from
+// the image
+bool CheckSums( IType * image, const TreeType * tree, bool fullyConnected )
+{
+  SumMaxTreeType::Pointer maxtree = SumMaxTreeType::New();
+  maxtree->SetInput( image );
+  maxtree->SetFullyConnected( fullyConnected );
+  maxtree->Update();
+
+  if( NodeAttributes( tree ) != NodeAttributes( maxtree->GetOutput() ) )
+    {
+    std::cerr << "The sums of the updated tree don't match the ones of a new tree." << std::endl;
+    return false;
+    }
+  return true;
+}
+
+// compare the updated tree with a tree built again from the image: same
+// number of nodes, and same size opening
+bool CheckTree( IType * image, const TreeType * tree, bool fullyConnected )
+{
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( image );
+  maxtree->SetFullyConnected( fullyConnected );
+  maxtree->Update();
+
+  const unsigned long nodes = CountNodes( tree );
+  const unsigned long expectedNodes = CountNodes( maxtree->GetOutput() );
+  if( nodes != expectedNodes )
+    {
+    std::cerr << "The updated tree has " << nodes << " nodes instead of " << expectedNodes << std::endl;
+    return false;
+    }
+
+  typedef itk::AttributeFilteringComponentTreeToImageFilter< TreeType, IType > OpeningType;
+  OpeningType::Pointer opening = OpeningType::New();
+  opening->SetInput( tree );
+  opening->SetLambda( 100 );
+  opening->SetFilteringType( OpeningType::DIRECT );
+  opening->Update();
+  OpeningType::Pointer expectedOpening = OpeningType::New();
+  expectedOpening->SetInput( maxtree->GetOutput() );
+  expectedOpening->SetLambda( 100 );
+  expectedOpening->SetFilteringType( OpeningType::DIRECT );
+  expectedOpening->Update();
+
+  typedef itk::ImageRegionConstIterator< IType > ConstIteratorType;
+  ConstIteratorType oIt( opening->GetOutput(), image->GetLargestPossibleRegion() );
+  ConstIteratorType eIt( expectedOpening->GetOutput(), image->GetLargestPossibleRegion() );
+  for( oIt.GoToBegin(), eIt.GoToBegin(); !oIt.IsAtEnd(); ++oIt, ++eIt )
+    {
+    if( oIt.Get() != eIt.Get() )
+      {
+      std::cerr << "The size opening of the updated tree doesn't match the one of a new tree." << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 4 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity" << std::endl;
+    std::cerr << "  inputImage: an input image (up to dim=3)." << std::endl;
+    std::cerr << "  outputImage: the image reconstructed from the updated tree" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    exit(1);
+    }
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  reader->Update();
+  IType::Pointer image = reader->GetOutput();
+  image->DisconnectPipeline();
+
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( image );
+  maxtree->SetFullyConnected( atoi( argv[3] ) );
+  maxtree->Update();
+  TreeType::Pointer tree = maxtree->GetOutput();
+  tree->DisconnectPipeline();
+
+  // the image and the tree are updated in place
+  typedef itk::ComponentTreeIncrementalUpdater< IType, TreeType, std::greater< PType >, AccumulatorType > UpdaterType;
+  UpdaterType::Pointer updater = UpdaterType::New();
+  updater->SetImage( image );
+  updater->SetComponentTree( tree );
+  updater->SetFullyConnected( atoi( argv[3] ) );
+  updater->Initialize();
+
+  // a second tree, with the sum of the pixel values as attribute, updated
+  // the same way
+  SumMaxTreeType::Pointer sumMaxtree = SumMaxTreeType::New();
+  sumMaxtree->SetInput( image );
+  sumMaxtree->SetFullyConnected( atoi( argv[3] ) );
+  sumMaxtree->Update();
+  TreeType::Pointer sumTree = sumMaxtree->GetOutput();
+  sumTree->DisconnectPipeline();
+
+  typedef itk::ComponentTreeIncrementalUpdater< IType, TreeType, std::greater< PType >, SumAccumulatorType > SumUpdaterType;
+  SumUpdaterType::Pointer sumUpdater = SumUpdaterType::New();
+  sumUpdater->SetImage( image );
+  sumUpdater->SetComponentTree( sumTree );
+  sumUpdater->SetFullyConnected( atoi( argv[3] ) );
+  sumUpdater->Initialize();
+
+  typedef itk::ComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer tree2image = T2IType::New();
+  tree2image->SetInput( tree );
+
+  // paint a square in the middle of the image, and keep the previous values
+  const IType::RegionType & largest = image->GetLargestPossibleRegion();
+  IType::IndexType idx;
+  IType::SizeType size;
+  for( int d=0; d<dim; d++ )
+    {
+    size[d] = std::max( 1ul, static_cast< unsigned long >( largest.GetSize()[d] / 4 ) );
+    idx[d] = largest.GetIndex()[d] + largest.GetSize()[d] / 2 - size[d] / 2;
+    }
+  IType::RegionType region( idx, size );
+  std::vector< PType > previous;
+  typedef itk::ImageRegionIterator< IType > IteratorType;
+  IteratorType it( image, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    previous.push_back( it.Get() );
+    it.Set( itk::NumericTraits< PType >::max() );
+    }
+  updater->UpdateRegion( region );
+  sumUpdater->UpdateRegion( region );
+
+  // the updated tree must give the painted image
+  tree2image->Update();
+  IteratorType oIt( tree2image->GetOutput(), image->GetLargestPossibleRegion() );
+  IteratorType iIt( image, image->GetLargestPossibleRegion() );
+  for( oIt.GoToBegin(), iIt.GoToBegin(); !oIt.IsAtEnd(); ++oIt, ++iIt )
+    {
+    if( oIt.Get() != iIt.Get() )
+      {
+      std::cerr << "The updated tree doesn't match the painted image at " << iIt.GetIndex() << std::endl;
+      return 1;
+      }
+    }
+  if( tree->GetRoot()->GetAttribute() != image->GetLargestPossibleRegion().GetNumberOfPixels() )
+    {
+    std::cerr << "The number of pixels of the root is wrong: " << tree->GetRoot()->GetAttribute() << std::endl;
+    return 1;
+    }
+  if( !CheckTree( image, tree, atoi( argv[3] ) ) || !CheckSums( image, sumTree, atoi( argv[3] ) ) )
+    {
+    return 1;
+    }
+
+  // then restore the previous values, to get the input image again
+  unsigned long i = 0;
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( previous[ i++ ] );
+    }
+  updater->UpdateRegion( region );
+  sumUpdater->UpdateRegion( region );
+  if( !CheckTree( image, tree, atoi( argv[3] ) ) || !CheckSums( image, sumTree, atoi( argv[3] ) ) )
+    {
+    return 1;
+    }
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( tree2image->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  return 0;
+}
+
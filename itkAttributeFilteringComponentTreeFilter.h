@@ -18,6 +18,7 @@
 #define __itkAttributeFilteringComponentTreeFilter_h
 
 #include "itkInPlaceComponentTreeFilter.h"
+#include "itkAttributeFilteringTypes.h"
 
 namespace itk {
 /** \class AttributeFilteringComponentTreeFilter
@@ -41,6 +42,9 @@ namespace itk {
  * - Maximum: the nodes with appropriate values are removed as well as their children, independently of the
  * attribute values of the children.
  *
+ * AttributeFilteringComponentTreeToImageFilter produces the same images, with the same
+ * filtering types, without modifying the tree.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
@@ -95,11 +99,11 @@ public:
   itkGetMacro(Lambda, AttributeType);
   
 
-  static const int MAXIMUM=0;
-  static const int MINIMUM=1;
-  static const int DIRECT=2;
-  static const int SUBTRACT=3;
-  
+  /** The filtering types. See AttributeFilteringTypes. */
+  itkStaticConstMacro(MAXIMUM, int, AttributeFilteringTypes::MAXIMUM);
+  itkStaticConstMacro(MINIMUM, int, AttributeFilteringTypes::MINIMUM);
+  itkStaticConstMacro(DIRECT, int, AttributeFilteringTypes::DIRECT);
+  itkStaticConstMacro(SUBTRACT, int, AttributeFilteringTypes::SUBTRACT);
 
   itkSetMacro(ReverseOrdering, bool);
   itkGetConstReferenceMacro(ReverseOrdering, bool);
@@ -107,45 +111,12 @@ public:
 
   static int GetFilteringTypeFromName( const std::string & s )
     {
-    if( s == "Maximum" )
-      {
-      return MAXIMUM;
-      }
-    else if( s == "Minimum" )
-      {
-      return MINIMUM;
-      }
-    else if( s == "Direct" )
-      {
-      return DIRECT;
-      }
-    else if( s == "Subtract" )
-      {
-      return SUBTRACT;
-      }
-    // can't recognize the namespace
-    itkGenericExceptionMacro( << "Unknown filtering type." );
+    return AttributeFilteringTypes::GetFilteringTypeFromName( s );
     }
 
   static std::string GetNameFromFilteringType( const int & a )
     {
-    switch( a )
-      {
-      case MAXIMUM:
-        return "Maximum";
-        break;
-      case MINIMUM:
-        return "Minimum";
-        break;
-      case DIRECT:
-        return "Direct";
-        break;
-      case SUBTRACT:
-        return "Subtract";
-        break;
-      }
-    // can't recognize the namespace
-    itkGenericExceptionMacro( << "Unknown filtering type." );
+    return AttributeFilteringTypes::GetNameFromFilteringType( a );
     }
 
 //   itkSetMacro(FilteringType, int);
@@ -184,6 +155,16 @@ protected:
   
   void SubtractFiltering( NodeType*, const RealPixelType & );
   
+  /** Return the attribute used to decide whether a node is removed.
+   * The attribute is only read for the nodes visited by the filtering
+   * algorithm, so subclasses can override this method to compute it
+   * on demand. */
+  virtual AttributeType GetNodeAttribute( NodeType * node )
+    {
+    AttributeAccessorType accessor;
+    return accessor( node );
+    }
+  
   inline bool Compare( const AttributeType & a1, const AttributeType & a2 )
     {
     if( m_ReverseOrdering )
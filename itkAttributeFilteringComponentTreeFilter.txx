@@ -75,13 +75,11 @@ AttributeFilteringComponentTreeFilter<TInputImage, TAccessor>
 {
   assert(node != NULL);
 
-  AttributeAccessorType accessor;
-
   typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
   typename NodeType::ChildrenListType::iterator it=childrenList->begin();
   while( it!=childrenList->end() )
     {
-    if( this->Compare( accessor(*it), m_Lambda ) )
+    if( this->Compare( this->GetNodeAttribute( *it ), m_Lambda ) )
       {
       this->GetOutput()->NodeFlatten( *it );
       this->GetOutput()->NodeMerge( node, *it );
@@ -108,13 +106,11 @@ AttributeFilteringComponentTreeFilter<TInputImage, TAccessor>
 {
   assert(node != NULL);
 
-  AttributeAccessorType accessor;
-
   typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
   typename NodeType::ChildrenListType::iterator it=childrenList->begin();
   while( it!=childrenList->end() )
     {
-    if( this->Compare( accessor(*it), m_Lambda ) )
+    if( this->Compare( this->GetNodeAttribute( *it ), m_Lambda ) )
       {
       this->GetOutput()->NodeMerge( node, *it );
       // must store the iterator, because once the element
@@ -140,8 +136,6 @@ AttributeFilteringComponentTreeFilter<TInputImage, TAccessor>
 {
   assert(node != NULL);
 
-  AttributeAccessorType accessor;
-
   typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
   typename NodeType::ChildrenListType::iterator it=childrenList->begin();
   
@@ -166,7 +160,7 @@ AttributeFilteringComponentTreeFilter<TInputImage, TAccessor>
       }
     }
     
-    return nodeCanBeMerged && this->Compare( accessor(node), m_Lambda );
+    return nodeCanBeMerged && this->Compare( this->GetNodeAttribute( node ), m_Lambda );
 }
 
 
@@ -177,8 +171,6 @@ AttributeFilteringComponentTreeFilter<TInputImage, TAccessor>
 {
   assert(node != NULL);
 
-  AttributeAccessorType accessor;
-
   typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
   typename NodeType::ChildrenListType::iterator it=childrenList->begin();
   
@@ -186,7 +178,7 @@ AttributeFilteringComponentTreeFilter<TInputImage, TAccessor>
   
   while( it!=childrenList->end() )
     {
-    if( this->Compare( accessor(*it), m_Lambda ) )
+    if( this->Compare( this->GetNodeAttribute( *it ), m_Lambda ) )
       {
       this->SubtractFiltering( *it, sub + (*it)->GetPixel() - node->GetPixel() );
       
@@ -18,13 +18,23 @@
 #define __itkAttributeFilteringComponentTreeToImageFilter_h
 
 #include "itkInPlaceComponentTreeFilter.h"
-#include "itkProgressReporter.h"
+#include "itkAttributeFilteringTypes.h"
+#include "itkThreadedComponentTreeToImageFilter.h"
+#include <vector>
 
 namespace itk {
 /** \class AttributeFilteringComponentTreeToImageFilter
  * \brief Filter and convert an itk::ComponentTree to an itk::Image
  *
- * A single filtering method is available, equivalent to the MAXIMUM method of AttributeFilteringComponentTreeFilter.
+ * The nodes are filtered with the same methods than AttributeFilteringComponentTreeFilter -
+ * MAXIMUM (the default), MINIMUM, DIRECT and SUBTRACT - but the tree is never modified:
+ * the output level of each node is computed during the reconstruction of the image, from
+ * the output level of its parent and from whether the node is removed. The MINIMUM method
+ * needs to know if a whole subtree can be removed before writing it, so a removal mask is
+ * first computed for all the nodes, and stored in the filter.
+ *
+ * Because the input tree is only read, a single tree can be filtered by several
+ * filters, with different lambdas or filtering types, without cloning it.
  *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
@@ -32,12 +42,12 @@ namespace itk {
  */
 template<class TInputImage, class TOutputImage,class TCompare=std::less< typename TInputImage::AttributeType > >
 class ITK_EXPORT AttributeFilteringComponentTreeToImageFilter : 
-    public ImageToImageFilter<TInputImage, TOutputImage>
+    public ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
 {
 public:
   /** Standard class typedefs. */
   typedef AttributeFilteringComponentTreeToImageFilter Self;
-  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage> Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
 
@@ -66,7 +76,7 @@ public:
 
   /** Runtime information support. */
   itkTypeMacro(AttributeFilteringComponentTreeToImageFilter, 
-               ImageToImageFilter);
+               ThreadedComponentTreeToImageFilter);
 
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
@@ -82,18 +92,66 @@ public:
   itkSetMacro(Lambda, AttributeType);
   itkGetMacro(Lambda, AttributeType);
 
+  typedef typename NumericTraits<InputImagePixelType>::RealType RealPixelType;
+
+  /** The filtering types. See AttributeFilteringTypes. */
+  itkStaticConstMacro(MAXIMUM, int, AttributeFilteringTypes::MAXIMUM);
+  itkStaticConstMacro(MINIMUM, int, AttributeFilteringTypes::MINIMUM);
+  itkStaticConstMacro(DIRECT, int, AttributeFilteringTypes::DIRECT);
+  itkStaticConstMacro(SUBTRACT, int, AttributeFilteringTypes::SUBTRACT);
+
+  static int GetFilteringTypeFromName( const std::string & s )
+    {
+    return AttributeFilteringTypes::GetFilteringTypeFromName( s );
+    }
+
+  static std::string GetNameFromFilteringType( const int & a )
+    {
+    return AttributeFilteringTypes::GetNameFromFilteringType( a );
+    }
+
+  itkGetMacro(FilteringType, int);
+
+  void SetFilteringType( std::string type )
+    {
+    this->SetFilteringType( GetFilteringTypeFromName( type ) );
+    }
+
+  void SetFilteringType( const int & type )
+    {
+    if( m_FilteringType != type )
+      {
+      GetNameFromFilteringType( type ); // to validate the filtering type
+      m_FilteringType = type;
+      this->Modified();
+      }
+    }
+
 protected:
   AttributeFilteringComponentTreeToImageFilter();
   ~AttributeFilteringComponentTreeToImageFilter() {};
   void PrintSelf(std::ostream& os, Indent indent) const;
 
-  /** Single-threaded version of GenerateData.  This filter delegates
-   * to GrayscaleGeodesicErodeImageFilter. */
-  void GenerateData();
-  
-  void LambdaComponents( const NodeType* );
+  /** Compute the output value of all the nodes */
+  void CollectNodes( const NodeType* );
+
+  /** Return the pixel value of the node. Not used: the output values are
+   * computed by CollectNodes(). */
+  OutputImagePixelType GetNodeValue( const NodeType * node )
+    {
+    return static_cast<OutputImagePixelType>( node->GetPixel() );
+    }
 
-  void WriteNodes( const NodeType*, OutputImagePixelType & p );
+  /** Add the node, with the output value v, and its subtree to the nodes to
+   * write. sub is the value to subtract to the kept nodes with the SUBTRACT
+   * method. */
+  void LambdaComponents( const NodeType*, const OutputImagePixelType & v, const RealPixelType & sub );
+
+  void WriteNodes( const NodeType*, const OutputImagePixelType & p );
+
+  /** Compute the removal mask of the MINIMUM method for the subtree, and
+   * return true if the node can be removed */
+  bool ComputeMinimumMask( const NodeType* );
 
 private:
   AttributeFilteringComponentTreeToImageFilter(const Self&); //purposely not implemented
@@ -101,7 +159,12 @@ private:
 
   AttributeType m_Lambda;
 
-  ProgressReporter * m_Progress;
+  int m_FilteringType;
+
+  // the removal mask of the MINIMUM method, indexed by the position of the
+  // nodes in a depth first traversal of the tree
+  std::vector< bool > m_RemovalMask;
+  unsigned long m_Position;
 
 } ; // end of class
 
@@ -27,56 +27,130 @@ AttributeFilteringComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare
 ::AttributeFilteringComponentTreeToImageFilter()
 {
   m_Lambda = itk::NumericTraits< AttributeType >::Zero;
+  m_FilteringType = MAXIMUM;
+  m_Position = 0;
 }
 
 
 template<class TInputImage, class TOutputImage, class TCompare>
 void
 AttributeFilteringComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
-::GenerateData()
+::CollectNodes( const NodeType * root )
 {
-  // Allocate the output
-  this->AllocateOutputs();
+  // validate the filtering type before doing anything
+  GetNameFromFilteringType( m_FilteringType );
 
-  m_Progress = new ProgressReporter(this, 0, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels());
-  this->LambdaComponents( this->GetInput()->GetRoot() );
-  delete m_Progress;
-  m_Progress = NULL;
+  if( m_FilteringType == MINIMUM )
+    {
+    m_RemovalMask.clear();
+    m_Position = 0;
+    this->ComputeMinimumMask( root );
+    }
+
+  m_Position = 0;
+  this->LambdaComponents( root, static_cast<OutputImagePixelType>( root->GetPixel() ), NumericTraits< RealPixelType >::Zero );
+
+  m_RemovalMask.clear();
 }
 
 
 template<class TInputImage, class TOutputImage, class TCompare>
-void
+bool
 AttributeFilteringComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
-::LambdaComponents( const NodeType* node )
+::ComputeMinimumMask( const NodeType* node )
 {
   assert(node != NULL);
-  OutputImagePixelType v = static_cast<OutputImagePixelType>( node->GetPixel() );
 
-  // write the pixels of the current node to ouput image
-  OutputImageType* output = this->GetOutput();
-  for( typename NodeType::IndexType current=node->GetFirstIndex();
-       current != NodeType::EndIndex;
-       current = this->GetInput()->GetLinkedListArray()[ current ] )
+  // the position is given in the same order than in LambdaComponents()
+  const unsigned long position = m_Position++;
+  m_RemovalMask.push_back( false );
+
+  bool nodeCanBeMerged = true;
+  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
     {
-    // std::cout << *it << ": " << v << std::endl;
-    output->SetPixel( output->ComputeIndex( current ), v );
-    m_Progress->CompletedPixel();
+    // all the children must be visited to compute their mask
+    if( !this->ComputeMinimumMask( *it ) )
+      {
+      nodeCanBeMerged = false;
+      }
     }
-  
+
+  CompareType compare;
+  const bool removed = nodeCanBeMerged && compare( node->GetAttribute(), m_Lambda );
+  m_RemovalMask[ position ] = removed;
+  return removed;
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare>
+void
+AttributeFilteringComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::LambdaComponents( const NodeType* node, const OutputImagePixelType & v, const RealPixelType & sub )
+{
+  assert(node != NULL);
+  m_Position++;
+
+  // the pixels of the current node are written with the value v
+  this->AddNode( node, v );
+
 
   CompareType compare;
   const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
   for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
     {
-    if( compare( (*it)->GetAttribute(), m_Lambda ) )
+    const NodeType * child = *it;
+    const OutputImagePixelType cv = static_cast<OutputImagePixelType>( child->GetPixel() );
+    if( m_FilteringType == MAXIMUM )
       {
-      // write this subtree to the output image with the pixel value of the current node
-      this->WriteNodes( *it, v );
+      if( compare( child->GetAttribute(), m_Lambda ) )
+        {
+        // write this subtree to the output image with the pixel value of the current node
+        this->WriteNodes( child, v );
+        }
+      else
+        {
+        this->LambdaComponents( child, cv, sub );
+        }
       }
-    else
+    else if( m_FilteringType == DIRECT )
       {
-      this->LambdaComponents( *it );
+      // a removed node takes the value of its parent, but its children are
+      // still considered
+      if( compare( child->GetAttribute(), m_Lambda ) )
+        {
+        this->LambdaComponents( child, v, sub );
+        }
+      else
+        {
+        this->LambdaComponents( child, cv, sub );
+        }
+      }
+    else if( m_FilteringType == MINIMUM )
+      {
+      // the mask of the child is at the position it will get in its call
+      if( m_RemovalMask[ m_Position ] )
+        {
+        this->LambdaComponents( child, v, sub );
+        }
+      else
+        {
+        this->LambdaComponents( child, cv, sub );
+        }
+      }
+    else // SUBTRACT
+      {
+      if( compare( child->GetAttribute(), m_Lambda ) )
+        {
+        // the contrast of the removed node is subtracted to its kept descendants
+        this->LambdaComponents( child, v,
+          sub + static_cast<RealPixelType>( child->GetPixel() ) - static_cast<RealPixelType>( node->GetPixel() ) );
+        }
+      else
+        {
+        this->LambdaComponents( child,
+          static_cast<OutputImagePixelType>( static_cast<RealPixelType>( child->GetPixel() ) - sub ), sub );
+        }
       }
     }
 }
@@ -85,21 +159,12 @@ AttributeFilteringComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare
 template<class TInputImage, class TOutputImage, class TCompare>
 void
 AttributeFilteringComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
-::WriteNodes( const NodeType* node, OutputImagePixelType & v )
+::WriteNodes( const NodeType* node, const OutputImagePixelType & v )
 {
   assert(node != NULL);
 
-  OutputImageType* output = this->GetOutput();
+  this->AddNode( node, v );
 
-  for( typename NodeType::IndexType current=node->GetFirstIndex();
-       current != NodeType::EndIndex;
-       current = this->GetInput()->GetLinkedListArray()[ current ] )
-    {
-    // std::cout << *it << ": " << v << std::endl;
-    output->SetPixel( output->ComputeIndex( current ), v );
-    m_Progress->CompletedPixel();
-    }
-  
   const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
   for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
     {
@@ -116,6 +181,7 @@ AttributeFilteringComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare
   Superclass::PrintSelf(os, indent);
   os << indent << "Lambda: " 
      << static_cast<typename NumericTraits< AttributeType >::PrintType>( m_Lambda ) << std::endl;
+  os << indent << "FilteringType: "  << GetNameFromFilteringType(m_FilteringType) << " (" << m_FilteringType << ")" << std::endl;
 }
   
 }// end namespace itk
@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkAttributeFilteringTypes.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkAttributeFilteringTypes_h
+#define __itkAttributeFilteringTypes_h
+
+#include "itkMacro.h"
+#include <string>
+
+namespace itk {
+/** \class AttributeFilteringTypes
+ * \brief The filtering types of the attribute filters, and their names
+ *
+ * The filtering types are shared by AttributeFilteringComponentTreeFilter and
+ * AttributeFilteringComponentTreeToImageFilter, so both can be configured
+ * with the same values or the same names: "Maximum", "Minimum", "Direct" and
+ * "Subtract".
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa AttributeFilteringComponentTreeFilter AttributeFilteringComponentTreeToImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+class AttributeFilteringTypes
+{
+public:
+  enum
+    {
+    MAXIMUM=0,
+    MINIMUM=1,
+    DIRECT=2,
+    SUBTRACT=3
+    };
+
+  static int GetFilteringTypeFromName( const std::string & s )
+    {
+    if( s == "Maximum" )
+      {
+      return MAXIMUM;
+      }
+    else if( s == "Minimum" )
+      {
+      return MINIMUM;
+      }
+    else if( s == "Direct" )
+      {
+      return DIRECT;
+      }
+    else if( s == "Subtract" )
+      {
+      return SUBTRACT;
+      }
+    // can't recognize the namespace
+    itkGenericExceptionMacro( << "Unknown filtering type." );
+    }
+
+  static std::string GetNameFromFilteringType( const int & a )
+    {
+    switch( a )
+      {
+      case MAXIMUM:
+        return "Maximum";
+        break;
+      case MINIMUM:
+        return "Minimum";
+        break;
+      case DIRECT:
+        return "Direct";
+        break;
+      case SUBTRACT:
+        return "Subtract";
+        break;
+      }
+    // can't recognize the namespace
+    itkGenericExceptionMacro( << "Unknown filtering type." );
+    }
+} ; // end of class
+
+} // end namespace itk
+
+#endif
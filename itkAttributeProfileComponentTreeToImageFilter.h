@@ -0,0 +1,169 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkAttributeProfileComponentTreeToImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkAttributeProfileComponentTreeToImageFilter_h
+#define __itkAttributeProfileComponentTreeToImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkProgressReporter.h"
+#include <vector>
+
+namespace itk {
+/** \class AttributeProfileComponentTreeToImageFilter
+ * \brief Filter a component tree with several lambdas, and produce a multi-component image
+ *
+ * This filter produces in a single traversal of the tree the images that
+ * AttributeFilteringComponentTreeToImageFilter would produce for each of the
+ * lambdas given with SetLambdas(). The output is an itk::VectorImage, with
+ * a component per lambda, in the order given by the user. The filtering is
+ * done with the MAXIMUM method.
+ *
+ * For a given node, the lambdas for which the node is kept are the ones
+ * lower than the attribute of the node and of all its ancestors. Once the
+ * lambdas are sorted, they form a prefix of the sorted lambdas, which is
+ * found with a binary search and can only shrink when going down in the
+ * tree. The components of the pixel are updated only for that prefix, and
+ * the whole subtree is written at once when the prefix becomes empty.
+ *
+ * Only the requested region of the output is produced, so the output can
+ * be streamed.
+ *
+ * The output is sometimes called an attribute profile, or a
+ * granulometry by reconstruction when the attribute is a size.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa AttributeFilteringComponentTreeToImageFilter, VectorIndexSelectionCastImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TInputImage, class TOutputImage,class TCompare=std::less< typename TInputImage::AttributeType > >
+class ITK_EXPORT AttributeProfileComponentTreeToImageFilter :
+    public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef AttributeProfileComponentTreeToImageFilter Self;
+  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TCompare CompareType;
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename InputImageType::Pointer         InputImagePointer;
+  typedef typename InputImageType::ConstPointer    InputImageConstPointer;
+  typedef typename InputImageType::RegionType      InputImageRegionType;
+  typedef typename InputImageType::PixelType       InputImagePixelType;
+  typedef typename OutputImageType::Pointer        OutputImagePointer;
+  typedef typename OutputImageType::ConstPointer   OutputImageConstPointer;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+  typedef typename OutputImageType::InternalPixelType OutputImageInternalPixelType;
+  typedef typename InputImageType::NodeType        NodeType;
+  typedef typename InputImageType::IndexType       IndexType;
+  typedef typename InputImageType::AttributeType   AttributeType;
+
+  typedef std::vector< AttributeType > LambdasType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(AttributeProfileComponentTreeToImageFilter,
+               ImageToImageFilter);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+/*  itkConceptMacro(InputEqualityComparableCheck,
+    (Concept::EqualityComparable<InputImagePixelType>));
+  itkConceptMacro(IntConvertibleToInputCheck,
+    (Concept::Convertible<int, InputImagePixelType>));
+  itkConceptMacro(InputOStreamWritableCheck,
+    (Concept::OStreamWritable<InputImagePixelType>));*/
+  /** End concept checking */
+#endif
+
+  /** Set/Get the lambdas. The component i of the output is the image
+   * filtered with the lambda i. */
+  void SetLambdas( const LambdasType & lambdas )
+    {
+    m_Lambdas = lambdas;
+    this->Modified();
+    }
+  itkGetConstReferenceMacro(Lambdas, LambdasType);
+
+  /** Add a lambda at the end of the list */
+  void AddLambda( const AttributeType & lambda )
+    {
+    m_Lambdas.push_back( lambda );
+    this->Modified();
+    }
+
+protected:
+  AttributeProfileComponentTreeToImageFilter();
+  ~AttributeProfileComponentTreeToImageFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** AttributeProfileComponentTreeToImageFilter needs the entire input be
+   * available. Thus, it needs to provide an implementation of
+   * GenerateInputRequestedRegion(). */
+  void GenerateInputRequestedRegion() ;
+
+  /** Set the number of components of the output */
+  void GenerateOutputInformation();
+
+  /** Single-threaded version of GenerateData.  This filter delegates
+   * to GrayscaleGeodesicErodeImageFilter. */
+  void GenerateData();
+
+  /** Write the node and its subtree. The first nbOfKept sorted lambdas keep
+   * the node, and values must already contain the pixel value of the node. */
+  void ProfileComponents( const NodeType* node, unsigned int nbOfKept, OutputImagePixelType & values );
+
+  void WriteNodes( const NodeType*, const OutputImagePixelType & values );
+
+  /** Write the pixels of a single node which are in the requested region */
+  void WriteNodePixels( const NodeType*, const OutputImagePixelType & values );
+
+private:
+  AttributeProfileComponentTreeToImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  LambdasType m_Lambdas;
+
+  // the lambdas sorted with the compare functor, and their position in
+  // m_Lambdas
+  LambdasType m_SortedLambdas;
+  std::vector< unsigned int > m_Order;
+
+  ProgressReporter * m_Progress;
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkAttributeProfileComponentTreeToImageFilter.txx"
+#endif
+
+#endif
+
+
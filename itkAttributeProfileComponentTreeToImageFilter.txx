@@ -0,0 +1,237 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkAttributeProfileComponentTreeToImageFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkAttributeProfileComponentTreeToImageFilter_txx
+#define __itkAttributeProfileComponentTreeToImageFilter_txx
+
+#include "itkAttributeProfileComponentTreeToImageFilter.h"
+#include <algorithm>
+
+
+namespace itk {
+
+template <class TInputImage, class TOutputImage, class TCompare>
+AttributeProfileComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::AttributeProfileComponentTreeToImageFilter()
+{
+  m_Progress = NULL;
+}
+
+
+template <class TInputImage, class TOutputImage, class TCompare>
+void
+AttributeProfileComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  // We need all the input.
+  InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
+
+  if ( !input )
+    { return; }
+
+  input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+}
+
+
+template <class TInputImage, class TOutputImage, class TCompare>
+void
+AttributeProfileComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  if( m_Lambdas.empty() )
+    {
+    itkExceptionMacro( << "At least one lambda is required." );
+    }
+  this->GetOutput()->SetNumberOfComponentsPerPixel( m_Lambdas.size() );
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare>
+void
+AttributeProfileComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::GenerateData()
+{
+  // Allocate the output
+  this->AllocateOutputs();
+
+  // sort the lambdas, but keep their position to write the components in
+  // the order given by the user. The number of lambdas is small, so a
+  // simple insertion sort is enough.
+  CompareType compare;
+  const unsigned int nbOfLambdas = m_Lambdas.size();
+  m_Order.clear();
+  for( unsigned int i=0; i<nbOfLambdas; i++ )
+    {
+    unsigned int j = m_Order.size();
+    m_Order.push_back( i );
+    while( j > 0 && compare( m_Lambdas[ i ], m_Lambdas[ m_Order[ j - 1 ] ] ) )
+      {
+      m_Order[ j ] = m_Order[ j - 1 ];
+      j--;
+      }
+    m_Order[ j ] = i;
+    }
+  m_SortedLambdas.resize( nbOfLambdas );
+  for( unsigned int j=0; j<nbOfLambdas; j++ )
+    {
+    m_SortedLambdas[ j ] = m_Lambdas[ m_Order[ j ] ];
+    }
+
+  // the root is kept by all the lambdas
+  const NodeType * root = this->GetInput()->GetRoot();
+  OutputImagePixelType values;
+  values.SetSize( nbOfLambdas );
+  values.Fill( static_cast< OutputImageInternalPixelType >( root->GetPixel() ) );
+
+  // all the pixels of the tree are visited, even if they are not all written
+  m_Progress = new ProgressReporter(this, 0, this->GetInput()->GetLargestPossibleRegion().GetNumberOfPixels());
+  this->ProfileComponents( root, nbOfLambdas, values );
+  delete m_Progress;
+  m_Progress = NULL;
+
+  m_SortedLambdas.clear();
+  m_Order.clear();
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare>
+void
+AttributeProfileComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::ProfileComponents( const NodeType* node, unsigned int nbOfKept, OutputImagePixelType & values )
+{
+  assert(node != NULL);
+
+  // write the pixels of the current node to ouput image
+  this->WriteNodePixels( node, values );
+
+  const OutputImageInternalPixelType v = static_cast< OutputImageInternalPixelType >( node->GetPixel() );
+  CompareType compare;
+  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+    {
+    // the child is kept by the lambdas lower or equal to its attribute, and
+    // by the lambdas which keep its parent
+    unsigned int nbOfChildKept = std::upper_bound( m_SortedLambdas.begin(), m_SortedLambdas.end(),
+                                                   (*it)->GetAttribute(), compare ) - m_SortedLambdas.begin();
+    nbOfChildKept = std::min( nbOfChildKept, nbOfKept );
+
+    if( nbOfChildKept == 0 )
+      {
+      // write this subtree to the output image with the values of the current node
+      this->WriteNodes( *it, values );
+      }
+    else
+      {
+      const OutputImageInternalPixelType cv = static_cast< OutputImageInternalPixelType >( (*it)->GetPixel() );
+      for( unsigned int j=0; j<nbOfChildKept; j++ )
+        {
+        values[ m_Order[ j ] ] = cv;
+        }
+      this->ProfileComponents( *it, nbOfChildKept, values );
+      // those components had the value of the current node, because
+      // nbOfChildKept <= nbOfKept
+      for( unsigned int j=0; j<nbOfChildKept; j++ )
+        {
+        values[ m_Order[ j ] ] = v;
+        }
+      }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare>
+void
+AttributeProfileComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::WriteNodes( const NodeType* node, const OutputImagePixelType & values )
+{
+  assert(node != NULL);
+
+  this->WriteNodePixels( node, values );
+
+  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+    {
+    this->WriteNodes( *it, values );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare>
+void
+AttributeProfileComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::WriteNodePixels( const NodeType* node, const OutputImagePixelType & values )
+{
+  const InputImageType * input = this->GetInput();
+  OutputImageType* output = this->GetOutput();
+  const OutputImageRegionType & outputRegion = output->GetBufferedRegion();
+
+  if( input->IsRunLengthEncoded() )
+    {
+    for( typename InputImageType::RunConstIterator it=input->NodeRunsBegin( node );
+         it!=input->NodeRunsEnd( node );
+         it++ )
+      {
+      IndexType idx = input->ComputeIndex( it->Offset );
+      for( typename NodeType::IndexType i=0; i<it->Length; i++ )
+        {
+        if( outputRegion.IsInside( idx ) )
+          {
+          output->SetPixel( idx, values );
+          }
+        idx[0]++;
+        m_Progress->CompletedPixel();
+        }
+      }
+    return;
+    }
+
+  for( typename NodeType::IndexType current=node->GetFirstIndex();
+       current != NodeType::EndIndex;
+       current = input->GetLinkedListArray()[ current ] )
+    {
+    // the offsets are relative to the whole tree, which may be larger than
+    // the output buffer
+    const IndexType idx = input->ComputeIndex( current );
+    if( outputRegion.IsInside( idx ) )
+      {
+      output->SetPixel( idx, values );
+      }
+    m_Progress->CompletedPixel();
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare>
+void
+AttributeProfileComponentTreeToImageFilter<TInputImage, TOutputImage, TCompare>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Lambdas:";
+  for( typename LambdasType::const_iterator it=m_Lambdas.begin(); it!=m_Lambdas.end(); it++ )
+    {
+    os << " " << static_cast<typename NumericTraits< AttributeType >::PrintType>( *it );
+    }
+  os << std::endl;
+}
+
+}// end namespace itk
+#endif
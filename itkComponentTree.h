@@ -22,6 +22,7 @@
 #include "itkFixedArray.h"
 #include "itkWeakPointer.h"
 #include "itkComponentTreeNode.h"
+#include "itkComponentTreeContainer.h"
 #include <list>
 
 namespace itk
@@ -48,6 +49,17 @@ namespace itk
  * As a consequence of the indices management, some methods which may seems best suited to be implemented
  * in the node class are implemented in this class, for example NodeMerge().
  *
+ * Large flat zones can use a lot of memory in the linked list array, which stores an offset per pixel.
+ * EncodeRunLength() replaces it by runs of consecutive pixels along the first dimension, so the memory used
+ * by the pixels depends on the length of the boundaries of the nodes rather than on their area, and the
+ * reconstruction filters can write whole runs at once. The methods which modify the pixels of the nodes
+ * require the linked list array: DecodeRunLength() restores it. InPlaceComponentTreeFilter does that
+ * automatically.
+ *
+ * The nodes and the linked list array are stored in a ComponentTreeContainer, which can be shared by
+ * several trees. Graft() shares the container of the grafted tree, in constant time, and the nodes are
+ * deleted when the last tree using them is destroyed or initialized.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * \sa ComponentTreeNode ImageToMaximumTreeFilter ImageToMinimumTreeFilter
@@ -115,6 +127,15 @@ public:
   /** Node type */
   typedef ComponentTreeNode< PixelType, OffsetValueType, AttributeType > NodeType;
 
+  /** The container of the nodes and of the linked list array */
+  typedef ComponentTreeContainer< NodeType > ContainerType;
+  typedef typename ContainerType::Pointer ContainerPointer;
+
+  /** Run-length encoding typedefs */
+  typedef typename ContainerType::RunType RunType;
+  typedef typename ContainerType::RunsType RunsType;
+  typedef typename RunsType::const_iterator RunConstIterator;
+
   /** Convenience methods to set the LargestPossibleRegion,
    *  BufferedRegion and RequestedRegion. Allocate must still be called.
    */
@@ -137,8 +158,52 @@ public:
   NodeType * GetRoot();
   const NodeType * GetRoot() const;
 
-  /** Set the root node */
-  itkSetObjectMacro(Root, NodeType);
+  /** Set the root node. The tree takes the ownership of the node, and the
+   * previous root node is deleted. */
+  void SetRoot( NodeType * root )
+    {
+    m_Container->SetRoot( root );
+    this->Modified();
+    }
+
+  /** Get/Set the container of the nodes and of the linked list array */
+  ContainerType * GetContainer()
+    {
+    return m_Container;
+    }
+
+  const ContainerType * GetContainer() const
+    {
+    return m_Container;
+    }
+
+  void SetContainer( ContainerType * container );
+
+  /** The memory used by the tree, in bytes. The attributes are counted
+   * with their size only: the memory they may allocate is not counted. */
+  struct MemoryFootprintType
+    {
+    unsigned long NumberOfNodes;
+    /** the nodes, without their attribute */
+    unsigned long Nodes;
+    unsigned long Attributes;
+    /** the entries in the children lists */
+    unsigned long ChildrenLists;
+    unsigned long LinkedListArray;
+    unsigned long Runs;
+    unsigned long Total;
+    };
+
+  /** Compute the memory used by the tree. The whole tree is traversed. */
+  MemoryFootprintType GetMemoryFootprint() const;
+
+  /** The memory used by a single node, including its entry in the children
+   * list of its parent. Useful to predict the memory used by a tree. */
+  static unsigned long GetNodeMemorySize()
+    {
+    // a list entry stores two pointers and the value
+    return sizeof( NodeType ) + 3 * sizeof( void * );
+    }
 
   /** Restore the data object to its initial state. This means releasing
    * memory. */
@@ -153,12 +218,39 @@ public:
 //  itkGetConstMacro(LinkedListArray, LinkedListArrayType);
   const LinkedListArrayType & GetLinkedListArray() const
     {
-    return m_LinkedListArray;
+    return m_Container->GetLinkedListArray();
     }
 
   LinkedListArrayType & GetLinkedListArray()
     {
-    return m_LinkedListArray;
+    return m_Container->GetLinkedListArray();
+    }
+
+  /** Store the pixels of the nodes as runs along the first dimension, and
+   * release the linked list array. The pixels of the nodes are sorted in
+   * the process. Do nothing if the tree is already encoded. */
+  void EncodeRunLength();
+
+  /** Restore the linked list array from the runs, and release the runs. Do
+   * nothing if the tree is not encoded. */
+  void DecodeRunLength();
+
+  bool IsRunLengthEncoded() const
+    {
+    return m_Container->GetRunLengthEncoded();
+    }
+
+  /** The runs of a node, when the tree is run-length encoded */
+  RunConstIterator NodeRunsBegin( const NodeType *node ) const
+    {
+    assert( this->IsRunLengthEncoded() );
+    return m_Container->GetRuns().begin() + node->GetFirstIndex();
+    }
+
+  RunConstIterator NodeRunsEnd( const NodeType *node ) const
+    {
+    assert( this->IsRunLengthEncoded() );
+    return m_Container->GetRuns().begin() + node->GetLastIndex();
     }
 
 
@@ -188,6 +280,9 @@ public:
   /** Return the number of index  in the node and its children */
   unsigned long NodeCountIndexes( const NodeType *node ) const;
 
+  /** Return the number of index in the node, without its children */
+  unsigned long NodeCountOwnIndexes( const NodeType *node ) const;
+
   const PixelType & GetPixel( const IndexType & idx ) const;
 
   const PixelType & GetPixel( const OffsetValueType & idx ) const;
@@ -211,22 +306,22 @@ public:
 protected:
   ComponentTree();
   void PrintSelf(std::ostream& os, Indent indent) const;
-  virtual ~ComponentTree()
-    {
-    if( m_Root )
-      {
-      delete m_Root;
-      }
-    }
+  virtual ~ComponentTree() {}
+
+  void AddNodeMemoryFootprint( const NodeType * node, MemoryFootprintType & footprint ) const;
+
+  /** Encode the pixels of a node and of its children. offsets is only
+   * there to avoid a memory allocation per node. */
+  void EncodeNodeRunLength( NodeType * node, LinkedListArrayType & offsets, RunsType & runs );
+
+  void DecodeNodeRunLength( NodeType * node );
 
 private:
   ComponentTree(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
-  /** The root node */
-  NodeType * m_Root;
-
-  LinkedListArrayType m_LinkedListArray;
+  /** The nodes and the linked list array */
+  ContainerPointer m_Container;
 };
 
 } // end namespace itk
@@ -22,6 +22,7 @@
 
 #include "itkComponentTree.h"
 #include "itkProcessObject.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -47,8 +48,8 @@ ComponentTree<TPixel, VImageDimension, TValue>
 {
   Superclass::PrintSelf(os,indent);
   
-//   os << indent << "PixelContainer: " << std::endl;
-//   m_Buffer->Print(os, indent.GetNextIndent());
+  os << indent << "Container: " << std::endl;
+  m_Container->Print(os, indent.GetNextIndent());
 
 // m_Origin and m_Spacing are printed in the Superclass
 }
@@ -62,8 +63,8 @@ void
 ComponentTree<TPixel, VImageDimension, TValue>
 ::Initialize()
 {
-  m_Root = NULL;
-  m_LinkedListArray.clear();
+  // don't touch the current container: it may be used by another tree
+  m_Container = ContainerType::New();
 }
 
 
@@ -75,7 +76,7 @@ void
 ComponentTree<TPixel, VImageDimension, TValue>
 ::Allocate()
 {
-  m_LinkedListArray.resize( this->GetLargestPossibleRegion().GetNumberOfPixels() );
+  this->GetLinkedListArray().resize( this->GetLargestPossibleRegion().GetNumberOfPixels() );
 }
 
 
@@ -104,10 +105,8 @@ ComponentTree<TPixel, VImageDimension, TValue>
 
     if ( imgData )
       {
-      // Now copy anything remaining that is needed
-      this->SetRoot( const_cast< NodeType * >
-                                  (imgData->GetRoot() ) );
-      this->m_LinkedListArray = imgData->m_LinkedListArray;
+      // Now share the nodes and the linked list array
+      this->SetContainer( const_cast< ContainerType * >( imgData->GetContainer() ) );
       }
     else
       {
@@ -120,21 +119,242 @@ ComponentTree<TPixel, VImageDimension, TValue>
 }
 
 
-/** Return the number of indexes */
+template<class TPixel, unsigned int VImageDimension, class TValue>
+void 
+ComponentTree<TPixel, VImageDimension, TValue>
+::SetContainer( ContainerType * container )
+{
+  if( container == NULL )
+    {
+    itkExceptionMacro( << "The container must not be NULL." );
+    }
+  if( m_Container != container )
+    {
+    m_Container = container;
+    this->Modified();
+    }
+}
+
+
+template<class TPixel, unsigned int VImageDimension, class TValue>
+typename ComponentTree<TPixel, VImageDimension, TValue>::MemoryFootprintType
+ComponentTree<TPixel, VImageDimension, TValue>
+::GetMemoryFootprint() const
+{
+  MemoryFootprintType footprint;
+  footprint.NumberOfNodes = 0;
+  footprint.Nodes = 0;
+  footprint.Attributes = 0;
+  footprint.ChildrenLists = 0;
+  footprint.LinkedListArray = this->GetLinkedListArray().capacity() * sizeof( OffsetValueType );
+  footprint.Runs = m_Container->GetRuns().capacity() * sizeof( RunType );
+
+  const NodeType * root = m_Container->GetRoot();
+  if( root != NULL )
+    {
+    this->AddNodeMemoryFootprint( root, footprint );
+    }
+
+  footprint.Total = footprint.Nodes + footprint.Attributes + footprint.ChildrenLists + footprint.LinkedListArray
+                    + footprint.Runs;
+  return footprint;
+}
+
+
+template<class TPixel, unsigned int VImageDimension, class TValue>
+void 
+ComponentTree<TPixel, VImageDimension, TValue>
+::AddNodeMemoryFootprint( const NodeType * node, MemoryFootprintType & footprint ) const
+{
+  assert( node != NULL );
+  footprint.NumberOfNodes++;
+  footprint.Nodes += sizeof( NodeType ) - sizeof( AttributeType );
+  footprint.Attributes += sizeof( AttributeType );
+
+  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  footprint.ChildrenLists += childrenList->size() * ( GetNodeMemorySize() - sizeof( NodeType ) );
+  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+    {
+    this->AddNodeMemoryFootprint( *it, footprint );
+    }
+}
+
+
+template<class TPixel, unsigned int VImageDimension, class TValue>
+void 
+ComponentTree<TPixel, VImageDimension, TValue>
+::EncodeRunLength()
+{
+  if( this->IsRunLengthEncoded() )
+    {
+    return;
+    }
+
+  RunsType & runs = m_Container->GetRuns();
+  runs.clear();
+  NodeType * root = m_Container->GetRoot();
+  if( root != NULL )
+    {
+    LinkedListArrayType offsets;
+    this->EncodeNodeRunLength( root, offsets, runs );
+    }
+  // release the memory
+  RunsType( runs ).swap( runs );
+  LinkedListArrayType().swap( this->GetLinkedListArray() );
+  m_Container->SetRunLengthEncoded( true );
+  this->Modified();
+}
+
+
+template<class TPixel, unsigned int VImageDimension, class TValue>
+void 
+ComponentTree<TPixel, VImageDimension, TValue>
+::EncodeNodeRunLength( NodeType * node, LinkedListArrayType & offsets, RunsType & runs )
+{
+  assert( node != NULL );
+
+  offsets.clear();
+  for( OffsetValueType current = node->GetFirstIndex();
+       current != NodeType::EndIndex;
+       current = this->GetLinkedListArray()[ current ] )
+    {
+    offsets.push_back( current );
+    }
+  std::sort( offsets.begin(), offsets.end() );
+
+  // the offsets are relative to the largest possible region, so a new line
+  // begins on each multiple of the size of the first dimension
+  const OffsetValueType lineSize = this->GetLargestPossibleRegion().GetSize()[0];
+  const OffsetValueType begin = runs.size();
+  for( typename LinkedListArrayType::const_iterator it=offsets.begin(); it!=offsets.end(); it++ )
+    {
+    if( static_cast< OffsetValueType >( runs.size() ) > begin
+        && runs.back().Offset + runs.back().Length == *it
+        && *it % lineSize != 0 )
+      {
+      runs.back().Length++;
+      }
+    else
+      {
+      RunType run;
+      run.Offset = *it;
+      run.Length = 1;
+      runs.push_back( run );
+      }
+    }
+  node->SetFirstIndex( begin );
+  node->SetLastIndex( runs.size() );
+
+  for( typename NodeType::ChildrenListType::iterator it=node->GetChildren().begin();
+       it!=node->GetChildren().end();
+       it++ )
+    {
+    this->EncodeNodeRunLength( *it, offsets, runs );
+    }
+}
+
+
+template<class TPixel, unsigned int VImageDimension, class TValue>
+void 
+ComponentTree<TPixel, VImageDimension, TValue>
+::DecodeRunLength()
+{
+  if( !this->IsRunLengthEncoded() )
+    {
+    return;
+    }
+
+  this->GetLinkedListArray().resize( this->GetLargestPossibleRegion().GetNumberOfPixels() );
+  NodeType * root = m_Container->GetRoot();
+  if( root != NULL )
+    {
+    this->DecodeNodeRunLength( root );
+    }
+  RunsType().swap( m_Container->GetRuns() );
+  m_Container->SetRunLengthEncoded( false );
+  this->Modified();
+}
+
+
+template<class TPixel, unsigned int VImageDimension, class TValue>
+void 
+ComponentTree<TPixel, VImageDimension, TValue>
+::DecodeNodeRunLength( NodeType * node )
+{
+  assert( node != NULL );
+
+  LinkedListArrayType & linkedList = this->GetLinkedListArray();
+  const RunsType & runs = m_Container->GetRuns();
+  OffsetValueType first = NodeType::EndIndex;
+  OffsetValueType last = NodeType::EndIndex;
+  for( OffsetValueType i=node->GetFirstIndex(); i<node->GetLastIndex(); i++ )
+    {
+    const OffsetValueType end = runs[i].Offset + runs[i].Length;
+    for( OffsetValueType current=runs[i].Offset; current<end; current++ )
+      {
+      if( last == NodeType::EndIndex )
+        {
+        first = current;
+        }
+      else
+        {
+        linkedList[ last ] = current;
+        }
+      last = current;
+      }
+    }
+  if( last != NodeType::EndIndex )
+    {
+    linkedList[ last ] = NodeType::EndIndex;
+    }
+  node->SetFirstIndex( first );
+  node->SetLastIndex( last );
+
+  for( typename NodeType::ChildrenListType::iterator it=node->GetChildren().begin();
+       it!=node->GetChildren().end();
+       it++ )
+    {
+    this->DecodeNodeRunLength( *it );
+    }
+}
+
+
 template<class TPixel, unsigned int VImageDimension, class TValue>
 unsigned long 
 ComponentTree<TPixel, VImageDimension, TValue>
-::NodeCountIndexes( const NodeType * node ) const 
+::NodeCountOwnIndexes( const NodeType * node ) const 
 {
   assert( node != NULL );
 
-  int size = 0;
+  unsigned long size = 0;
+  if( this->IsRunLengthEncoded() )
+    {
+    for( RunConstIterator it=this->NodeRunsBegin( node ); it!=this->NodeRunsEnd( node ); it++ )
+      {
+      size += it->Length;
+      }
+    return size;
+    }
+
   OffsetValueType current = node->GetFirstIndex();
   while( current != NodeType::EndIndex )
     {
     size++;
-    current = m_LinkedListArray[ current ];
+    current = this->GetLinkedListArray()[ current ];
     }
+  return size;
+}
+
+
+/** Return the number of indexes */
+template<class TPixel, unsigned int VImageDimension, class TValue>
+unsigned long 
+ComponentTree<TPixel, VImageDimension, TValue>
+::NodeCountIndexes( const NodeType * node ) const 
+{
+  assert( node != NULL );
+
+  unsigned long size = this->NodeCountOwnIndexes( node );
 
   for( typename NodeType::ChildrenListType::const_iterator it=node->GetChildren().begin();
        it!=node->GetChildren().end();
@@ -157,6 +377,7 @@ ComponentTree<TPixel, VImageDimension, TValue>
   assert( idx != NodeType::EndIndex );
   assert( idx >= 0 );
   assert( idx < (long)this->GetLargestPossibleRegion().GetNumberOfPixels() );
+  assert( !this->IsRunLengthEncoded() );
   
   typename NodeType::IndexType current = node->GetFirstIndex();
   typename NodeType::IndexType previous = NodeType::EndIndex;
@@ -165,18 +386,18 @@ ComponentTree<TPixel, VImageDimension, TValue>
     {
     if( current == idx )
       {
-      previous = m_LinkedListArray[ current ];
+      previous = this->GetLinkedListArray()[ current ];
       if( current == node->GetFirstIndex() )
         {
-        node->SetFirstIndex( m_LinkedListArray[ current ] );
+        node->SetFirstIndex( this->GetLinkedListArray()[ current ] );
         }
       if( current == node->GetLastIndex() )
         {
-        node->SetLastIndex( m_LinkedListArray[ current ] );
+        node->SetLastIndex( this->GetLinkedListArray()[ current ] );
         }
       return true;
       }
-    current = m_LinkedListArray[ current ];
+    current = this->GetLinkedListArray()[ current ];
     }
   return false;
 }
@@ -202,17 +423,18 @@ ComponentTree<TPixel, VImageDimension, TValue>
   assert( idx != NodeType::EndIndex );
   assert( idx >= 0 );
   assert( (unsigned long)idx < this->GetLargestPossibleRegion().GetNumberOfPixels() );
+  assert( !this->IsRunLengthEncoded() );
   assert( !this->NodeHasIndex( node, idx ) );
 
   if( node->GetLastIndex() == NodeType::EndIndex )
     {
     node->SetFirstIndex( idx );
     node->SetLastIndex( idx );
-    m_LinkedListArray[ idx ] = NodeType::EndIndex;
+    this->GetLinkedListArray()[ idx ] = NodeType::EndIndex;
     }
   else
     {
-    m_LinkedListArray[ idx ] = node->GetFirstIndex();
+    this->GetLinkedListArray()[ idx ] = node->GetFirstIndex();
     node->SetFirstIndex( idx );
     }
   assert( this->NodeHasIndex( node, idx ) );
@@ -239,6 +461,18 @@ ComponentTree<TPixel, VImageDimension, TValue>
   assert( idx >= 0 );
   assert( (unsigned long)idx < this->GetLargestPossibleRegion().GetNumberOfPixels() );
 
+  if( this->IsRunLengthEncoded() )
+    {
+    for( RunConstIterator it=this->NodeRunsBegin( node ); it!=this->NodeRunsEnd( node ); it++ )
+      {
+      if( idx >= it->Offset && idx < it->Offset + it->Length )
+        {
+        return true;
+        }
+      }
+    return false;
+    }
+
   OffsetValueType current = node->GetFirstIndex();
   while( current != NodeType::EndIndex )
     {
@@ -246,7 +480,7 @@ ComponentTree<TPixel, VImageDimension, TValue>
       {
       return true;
       }
-    current = m_LinkedListArray[ current ];
+    current = this->GetLinkedListArray()[ current ];
     }
   return false;
 }
@@ -270,10 +504,16 @@ ComponentTree<TPixel, VImageDimension, TValue>
   assert( node != NULL );
   assert( obsolatedNode != NULL );
   assert( node != obsolatedNode );
+  assert( !this->IsRunLengthEncoded() );
 
   if( obsolatedNode->GetFirstIndex() != NodeType::EndIndex )
     {
-    m_LinkedListArray[ obsolatedNode->GetLastIndex() ] = node->GetFirstIndex();
+    this->GetLinkedListArray()[ obsolatedNode->GetLastIndex() ] = node->GetFirstIndex();
+    if( node->GetLastIndex() == NodeType::EndIndex )
+      {
+      // the node was empty
+      node->SetLastIndex( obsolatedNode->GetLastIndex() );
+      }
     node->SetFirstIndex( obsolatedNode->GetFirstIndex() );
     obsolatedNode->SetFirstIndex( NodeType::EndIndex );
     obsolatedNode->SetLastIndex( NodeType::EndIndex );
@@ -424,14 +664,9 @@ ComponentTree<TPixel, VImageDimension, TValue>
 {
   assert( node != NULL );
 
-  OffsetValueType current = node->GetFirstIndex();
-  while( current != NodeType::EndIndex )
+  if( this->NodeHasIndex( node, idx ) )
     {
-    if( current == idx )
-      {
-      return node;
-      }
-    current = m_LinkedListArray[ current ];
+    return node;
     }
 
   for( typename NodeType::ChildrenListType::const_iterator it=node->GetChildren().begin();
@@ -465,14 +700,9 @@ ComponentTree<TPixel, VImageDimension, TValue>
 {
   assert( node != NULL );
 
-  OffsetValueType current = node->GetFirstIndex();
-  while( current != NodeType::EndIndex )
+  if( this->NodeHasIndex( node, idx ) )
     {
-    if( current == idx )
-      {
-      return node;
-      }
-    current = m_LinkedListArray[ current ];
+    return node;
     }
 
   for( typename NodeType::ChildrenListType::const_iterator it=node->GetChildren().begin();
@@ -495,11 +725,12 @@ typename ComponentTree<TPixel, VImageDimension, TValue>::NodeType *
 ComponentTree<TPixel, VImageDimension, TValue>
 ::GetRoot()
 {
-  if( m_Root == NULL )
+  NodeType * root = m_Container->GetRoot();
+  if( root == NULL )
     {
     itkExceptionMacro(<< "No root Node.");
     }
-  return m_Root;
+  return root;
 }
 
 
@@ -508,11 +739,12 @@ const typename ComponentTree<TPixel, VImageDimension, TValue>::NodeType *
 ComponentTree<TPixel, VImageDimension, TValue>
 ::GetRoot() const
 {
-  if( m_Root == NULL )
+  const NodeType * root = m_Container->GetRoot();
+  if( root == NULL )
     {
     itkExceptionMacro(<< "No root Node.");
     }
-  return m_Root;
+  return root;
 }
 
 
@@ -0,0 +1,433 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeAccumulator.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeAccumulator_h
+#define __itkComponentTreeAccumulator_h
+
+#include "itkComponentTreeNode.h"
+#include "itkNumericTraits.h"
+#include <cmath>
+#include <algorithm>
+
+namespace itk
+{
+
+namespace Functor {
+
+/** \class NullComponentTreeAccumulator
+ * \brief An accumulator which does nothing
+ *
+ * The accumulators compute the attributes of the nodes while the tree is
+ * built by ImageToComponentTreeFilter. They must provide:
+ * - SetComponentTree( tree ): called with the tree being built, before
+ * AddPixel(). The accumulators which need the position of the pixels keep
+ * it to compute the index of the offsets.
+ * - Initialize( node ): called when a node is created.
+ * - AddPixel( node, offset ): called when a pixel is added to a node. The
+ * value of the pixel is the one of the node.
+ * - Merge( node, other ): called when the pixels and the children of other
+ * are added to node, as a child or in the same node. The attribute of other
+ * is complete at that time.
+ * - Unmerge( node, other ): called when the pixels and the children of
+ * other, with a complete attribute, are removed from node. It is used by
+ * ComponentTreeIncrementalUpdater to keep the attributes of the ancestors
+ * of the rebuilt nodes up to date.
+ * - the enum value Active, which is 0 when the accumulator does nothing, so
+ * the builder can skip the calls at compile time.
+ * - the enum value Unmergeable, which is 0 when the attribute can't be
+ * removed from the one of the parent, like a bounding box. Unmerge() is
+ * then never called, and the accumulator can't be used by
+ * ComponentTreeIncrementalUpdater.
+ *
+ * Only the attributes which can be merged in constant time can be computed
+ * that way. The attributes with several values, like the bounding box or
+ * the moments, are stored in an array attribute, like a FixedArray.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ImageToComponentTreeFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template< class TNode >
+class ITK_EXPORT NullComponentTreeAccumulator
+{
+public:
+  typedef TNode NodeType;
+  typedef typename NodeType::IndexType OffsetValueType;
+
+  enum { Active = 0 };
+  enum { Unmergeable = 1 };
+
+  template< class TComponentTree >
+  inline void SetComponentTree( const TComponentTree * ) {}
+
+  inline void Initialize( NodeType * ) {}
+
+  inline void AddPixel( NodeType *, const OffsetValueType & ) {}
+
+  inline void Merge( NodeType *, const NodeType * ) {}
+
+  inline void Unmerge( NodeType *, const NodeType * ) {}
+};
+
+
+/** \class NumberOfPixelsComponentTreeAccumulator
+ * \brief Compute the number of pixels of the nodes while the tree is built
+ *
+ * The attribute is the same as the one computed by
+ * NumberOfPixelsComponentTreeFilter.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa NumberOfPixelsComponentTreeFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template< class TNode, class TAttributeAccessor=AttributeComponentTreeNodeAccessor< TNode > >
+class ITK_EXPORT NumberOfPixelsComponentTreeAccumulator
+{
+public:
+  typedef TNode NodeType;
+  typedef typename NodeType::IndexType OffsetValueType;
+  typedef TAttributeAccessor AttributeAccessorType;
+  typedef typename AttributeAccessorType::AttributeType AttributeType;
+
+  enum { Active = 1 };
+  enum { Unmergeable = 1 };
+
+  template< class TComponentTree >
+  inline void SetComponentTree( const TComponentTree * ) {}
+
+  inline void Initialize( NodeType * node )
+    {
+    m_Accessor( node, NumericTraits< AttributeType >::Zero );
+    }
+
+  inline void AddPixel( NodeType * node, const OffsetValueType & )
+    {
+    m_Accessor( node, static_cast< AttributeType >( m_Accessor( node ) + 1 ) );
+    }
+
+  inline void Merge( NodeType * node, const NodeType * other )
+    {
+    m_Accessor( node, static_cast< AttributeType >( m_Accessor( node ) + m_Accessor( other ) ) );
+    }
+
+  inline void Unmerge( NodeType * node, const NodeType * other )
+    {
+    m_Accessor( node, static_cast< AttributeType >( m_Accessor( node ) - m_Accessor( other ) ) );
+    }
+
+private:
+  AttributeAccessorType m_Accessor;
+};
+
+
+/** \class SumComponentTreeAccumulator
+ * \brief Compute the sum of the absolute pixel values of the nodes while the tree is built
+ *
+ * The attribute is the same as the one computed by SumComponentTreeFilter.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa SumComponentTreeFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template< class TNode, class TAttributeAccessor=AttributeComponentTreeNodeAccessor< TNode > >
+class ITK_EXPORT SumComponentTreeAccumulator
+{
+public:
+  typedef TNode NodeType;
+  typedef typename NodeType::IndexType OffsetValueType;
+  typedef TAttributeAccessor AttributeAccessorType;
+  typedef typename AttributeAccessorType::AttributeType AttributeType;
+
+  enum { Active = 1 };
+  enum { Unmergeable = 1 };
+
+  template< class TComponentTree >
+  inline void SetComponentTree( const TComponentTree * ) {}
+
+  inline void Initialize( NodeType * node )
+    {
+    m_Accessor( node, NumericTraits< AttributeType >::Zero );
+    }
+
+  inline void AddPixel( NodeType * node, const OffsetValueType & )
+    {
+    m_Accessor( node, static_cast< AttributeType >( m_Accessor( node ) + std::abs( node->GetPixel() ) ) );
+    }
+
+  inline void Merge( NodeType * node, const NodeType * other )
+    {
+    m_Accessor( node, static_cast< AttributeType >( m_Accessor( node ) + m_Accessor( other ) ) );
+    }
+
+  inline void Unmerge( NodeType * node, const NodeType * other )
+    {
+    m_Accessor( node, static_cast< AttributeType >( m_Accessor( node ) - m_Accessor( other ) ) );
+    }
+
+private:
+  AttributeAccessorType m_Accessor;
+};
+
+
+/** \class BoundingBoxComponentTreeAccumulator
+ * \brief Compute the bounding box of the nodes while the tree is built
+ *
+ * The attribute is an array, like a FixedArray, of 2 * ImageDimension
+ * values: the minimum index of the pixels of the node and its children on
+ * each dimension, then the maximum index on each dimension.
+ *
+ * The bounding box of a node can't be computed again when a part of its
+ * pixels is removed, so the accumulator is not Unmergeable, and can't be
+ * used with ComponentTreeIncrementalUpdater.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa NullComponentTreeAccumulator
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template< class TComponentTree,
+          class TAttributeAccessor=AttributeComponentTreeNodeAccessor< typename TComponentTree::NodeType > >
+class ITK_EXPORT BoundingBoxComponentTreeAccumulator
+{
+public:
+  typedef TComponentTree ComponentTreeType;
+  typedef typename ComponentTreeType::NodeType NodeType;
+  typedef typename ComponentTreeType::IndexType IndexType;
+  typedef typename NodeType::IndexType OffsetValueType;
+  typedef TAttributeAccessor AttributeAccessorType;
+  typedef typename AttributeAccessorType::AttributeType AttributeType;
+  typedef typename AttributeType::ValueType ValueType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TComponentTree::ImageDimension);
+
+  enum { Active = 1 };
+  enum { Unmergeable = 0 };
+
+  BoundingBoxComponentTreeAccumulator()
+    {
+    m_ComponentTree = NULL;
+    }
+
+  inline void SetComponentTree( const ComponentTreeType * tree )
+    {
+    m_ComponentTree = tree;
+    }
+
+  inline void Initialize( NodeType * node )
+    {
+    AttributeType box = m_Accessor( node );
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      box[i] = NumericTraits< ValueType >::max();
+      box[ i + ImageDimension ] = NumericTraits< ValueType >::NonpositiveMin();
+      }
+    m_Accessor( node, box );
+    }
+
+  inline void AddPixel( NodeType * node, const OffsetValueType & offset )
+    {
+    assert( m_ComponentTree != NULL );
+    const IndexType idx = m_ComponentTree->ComputeIndex( offset );
+    AttributeType box = m_Accessor( node );
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      const ValueType v = static_cast< ValueType >( idx[i] );
+      box[i] = std::min( box[i], v );
+      box[ i + ImageDimension ] = std::max( box[ i + ImageDimension ], v );
+      }
+    m_Accessor( node, box );
+    }
+
+  inline void Merge( NodeType * node, const NodeType * other )
+    {
+    AttributeType box = m_Accessor( node );
+    const AttributeType otherBox = m_Accessor( other );
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      box[i] = std::min( box[i], otherBox[i] );
+      box[ i + ImageDimension ] = std::max( box[ i + ImageDimension ], otherBox[ i + ImageDimension ] );
+      }
+    m_Accessor( node, box );
+    }
+
+private:
+  const ComponentTreeType * m_ComponentTree;
+  AttributeAccessorType m_Accessor;
+};
+
+
+/** \class FirstMomentsComponentTreeAccumulator
+ * \brief Compute the first order moments of the nodes while the tree is built
+ *
+ * The attribute is an array, like a FixedArray, of ImageDimension values:
+ * the sum of the physical positions of the pixels of the node and its
+ * children on each dimension. These are the non normalized moments used by
+ * CompactnessComponentTreeFilter: the center of gravity of a node is the
+ * attribute divided by its number of pixels, which can be computed at the
+ * same time with a PairComponentTreeAccumulator.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa CompactnessComponentTreeFilter NullComponentTreeAccumulator
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template< class TComponentTree,
+          class TAttributeAccessor=AttributeComponentTreeNodeAccessor< typename TComponentTree::NodeType > >
+class ITK_EXPORT FirstMomentsComponentTreeAccumulator
+{
+public:
+  typedef TComponentTree ComponentTreeType;
+  typedef typename ComponentTreeType::NodeType NodeType;
+  typedef typename ComponentTreeType::IndexType IndexType;
+  typedef typename ComponentTreeType::PointType PointType;
+  typedef typename NodeType::IndexType OffsetValueType;
+  typedef TAttributeAccessor AttributeAccessorType;
+  typedef typename AttributeAccessorType::AttributeType AttributeType;
+  typedef typename AttributeType::ValueType ValueType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TComponentTree::ImageDimension);
+
+  enum { Active = 1 };
+  enum { Unmergeable = 1 };
+
+  FirstMomentsComponentTreeAccumulator()
+    {
+    m_ComponentTree = NULL;
+    }
+
+  inline void SetComponentTree( const ComponentTreeType * tree )
+    {
+    m_ComponentTree = tree;
+    }
+
+  inline void Initialize( NodeType * node )
+    {
+    AttributeType moments = m_Accessor( node );
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      moments[i] = NumericTraits< ValueType >::Zero;
+      }
+    m_Accessor( node, moments );
+    }
+
+  inline void AddPixel( NodeType * node, const OffsetValueType & offset )
+    {
+    assert( m_ComponentTree != NULL );
+    PointType physicalPosition;
+    m_ComponentTree->TransformIndexToPhysicalPoint( m_ComponentTree->ComputeIndex( offset ), physicalPosition );
+    AttributeType moments = m_Accessor( node );
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      moments[i] = static_cast< ValueType >( moments[i] + physicalPosition[i] );
+      }
+    m_Accessor( node, moments );
+    }
+
+  inline void Merge( NodeType * node, const NodeType * other )
+    {
+    AttributeType moments = m_Accessor( node );
+    const AttributeType otherMoments = m_Accessor( other );
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      moments[i] = static_cast< ValueType >( moments[i] + otherMoments[i] );
+      }
+    m_Accessor( node, moments );
+    }
+
+  inline void Unmerge( NodeType * node, const NodeType * other )
+    {
+    AttributeType moments = m_Accessor( node );
+    const AttributeType otherMoments = m_Accessor( other );
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      moments[i] = static_cast< ValueType >( moments[i] - otherMoments[i] );
+      }
+    m_Accessor( node, moments );
+    }
+
+private:
+  const ComponentTreeType * m_ComponentTree;
+  AttributeAccessorType m_Accessor;
+};
+
+
+/** \class PairComponentTreeAccumulator
+ * \brief Run two accumulators
+ *
+ * The accumulators must use different accessors, for example an
+ * accessor to the components of an array attribute. Several accumulators
+ * can be run by nesting the pairs.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template< class TFirstAccumulator, class TSecondAccumulator >
+class ITK_EXPORT PairComponentTreeAccumulator
+{
+public:
+  typedef typename TFirstAccumulator::NodeType NodeType;
+  typedef typename NodeType::IndexType OffsetValueType;
+
+  enum { Active = TFirstAccumulator::Active || TSecondAccumulator::Active };
+  enum { Unmergeable = TFirstAccumulator::Unmergeable && TSecondAccumulator::Unmergeable };
+
+  template< class TComponentTree >
+  inline void SetComponentTree( const TComponentTree * tree )
+    {
+    m_First.SetComponentTree( tree );
+    m_Second.SetComponentTree( tree );
+    }
+
+  inline void Initialize( NodeType * node )
+    {
+    m_First.Initialize( node );
+    m_Second.Initialize( node );
+    }
+
+  inline void AddPixel( NodeType * node, const OffsetValueType & offset )
+    {
+    m_First.AddPixel( node, offset );
+    m_Second.AddPixel( node, offset );
+    }
+
+  inline void Merge( NodeType * node, const NodeType * other )
+    {
+    m_First.Merge( node, other );
+    m_Second.Merge( node, other );
+    }
+
+  inline void Unmerge( NodeType * node, const NodeType * other )
+    {
+    m_First.Unmerge( node, other );
+    m_Second.Unmerge( node, other );
+    }
+
+private:
+  TFirstAccumulator m_First;
+  TSecondAccumulator m_Second;
+};
+
+}
+
+} // end namespace itk
+
+#endif
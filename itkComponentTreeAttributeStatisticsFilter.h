@@ -0,0 +1,293 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeAttributeStatisticsFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeAttributeStatisticsFilter_h
+#define __itkComponentTreeAttributeStatisticsFilter_h
+
+#include "itkProcessObject.h"
+#include "itkHistogram.h"
+#include "itkFixedArray.h"
+#include "itkMultiThreader.h"
+#include "itkComponentTreeNode.h"
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace itk {
+
+namespace Functor {
+
+/**
+ * Read a single attribute of a node as a measurement vector of size 1.
+ */
+template< class TComponentTreeNode, class TAttributeAccessor=AttributeComponentTreeNodeAccessor< TComponentTreeNode > >
+class ITK_EXPORT AttributeMeasurementComponentTreeNodeAccessor
+{
+public:
+  typedef TComponentTreeNode ComponentTreeNodeType;
+  itkStaticConstMacro(MeasurementVectorSize, unsigned int, 1);
+  typedef FixedArray< double, 1 > MeasurementVectorType;
+
+  inline MeasurementVectorType operator()( const ComponentTreeNodeType * node )
+    {
+    TAttributeAccessor accessor;
+    MeasurementVectorType mv;
+    mv[0] = static_cast< double >( accessor( node ) );
+    return mv;
+    }
+};
+
+/**
+ * Read two attributes of a node, for example the area and the contrast,
+ * as a measurement vector of size 2.
+ */
+template< class TComponentTreeNode, class TAttributeAccessor1, class TAttributeAccessor2 >
+class ITK_EXPORT PairMeasurementComponentTreeNodeAccessor
+{
+public:
+  typedef TComponentTreeNode ComponentTreeNodeType;
+  itkStaticConstMacro(MeasurementVectorSize, unsigned int, 2);
+  typedef FixedArray< double, 2 > MeasurementVectorType;
+
+  inline MeasurementVectorType operator()( const ComponentTreeNodeType * node )
+    {
+    TAttributeAccessor1 accessor1;
+    TAttributeAccessor2 accessor2;
+    MeasurementVectorType mv;
+    mv[0] = static_cast< double >( accessor1( node ) );
+    mv[1] = static_cast< double >( accessor2( node ) );
+    return mv;
+    }
+};
+
+/**
+ * Read the attribute of a node as a measurement vector, when the attribute
+ * is itself a FixedArray, as done in multiple_attributes.cxx.
+ */
+template< class TComponentTreeNode >
+class ITK_EXPORT ArrayMeasurementComponentTreeNodeAccessor
+{
+public:
+  typedef TComponentTreeNode ComponentTreeNodeType;
+  typedef typename ComponentTreeNodeType::AttributeType AttributeType;
+  itkStaticConstMacro(MeasurementVectorSize, unsigned int, AttributeType::Length);
+  typedef FixedArray< double, itkGetStaticConstMacro(MeasurementVectorSize) > MeasurementVectorType;
+
+  inline MeasurementVectorType operator()( const ComponentTreeNodeType * node )
+    {
+    MeasurementVectorType mv;
+    for( unsigned int i=0; i<MeasurementVectorSize; i++ )
+      {
+      mv[i] = static_cast< double >( node->GetAttribute()[i] );
+      }
+    return mv;
+    }
+};
+
+}
+
+
+/** \class ComponentTreeAttributeStatisticsFilter
+ * \brief Summarize the distribution of several attributes of the nodes
+ *
+ * This filter computes, for each component of the measurement vector
+ * returned by the measurement accessor, the minimum, the maximum, the mean,
+ * some quantiles, and an histogram of the values over all the nodes of the
+ * tree. It can also compute 2D joint histograms of pairs of components,
+ * for example the area against the contrast, which are added with
+ * AddJointHistogram().
+ *
+ * The tree is traversed only once, to pack the measurements in a
+ * contiguous array. The statistics and the histograms are then computed
+ * with a multithreaded reduction over that array: each thread accumulates
+ * its own partial results which are merged at the end.
+ *
+ * The 1D histograms are available as outputs 0 to MeasurementVectorSize-1,
+ * and the joint histograms as the following outputs, in the order they
+ * have been added. The bins are spread uniformly between the minimum and
+ * the maximum of each attribute.
+ *
+ * The quantile q of an attribute is the value found at the position
+ * floor( q * (n-1) ) in the sorted values of the n nodes.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ComponentTreeToHistogramFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TImage, class TMeasurementAccessor=typename Functor::AttributeMeasurementComponentTreeNodeAccessor< typename TImage::NodeType > >
+class ITK_EXPORT ComponentTreeAttributeStatisticsFilter :
+    public ProcessObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef ComponentTreeAttributeStatisticsFilter Self;
+  typedef ProcessObject             Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TImage ImageType;
+  typedef typename ImageType::Pointer         ImagePointer;
+  typedef typename ImageType::ConstPointer    ImageConstPointer;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::NodeType        NodeType;
+  typedef typename ImageType::IndexType       IndexType;
+
+  typedef TMeasurementAccessor MeasurementAccessorType;
+  typedef typename MeasurementAccessorType::MeasurementVectorType MeasurementVectorType;
+
+  itkStaticConstMacro(MeasurementVectorSize, unsigned int,
+                      MeasurementAccessorType::MeasurementVectorSize);
+
+  typedef Statistics::Histogram< double > HistogramType;
+  typedef typename HistogramType::Pointer HistogramPointer;
+
+  typedef std::vector< double > QuantilesType;
+  typedef std::pair< unsigned int, unsigned int > JointHistogramPairType;
+  typedef std::vector< JointHistogramPairType > JointHistogramPairsType;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ComponentTreeAttributeStatisticsFilter,
+               ProcessObject);
+
+  /** Set/Get the input tree */
+  void SetInput( const ImageType * input );
+  const ImageType * GetInput() const;
+
+  /** Get the 1D histogram of a component of the measurement vector */
+  const HistogramType * GetHistogram( unsigned int component ) const;
+
+  /** Get the joint histogram in the order given by AddJointHistogram() */
+  const HistogramType * GetJointHistogram( unsigned int i ) const;
+
+  /** Add a 2D joint histogram of two components of the measurement vector.
+   * Return the position of the histogram, to be used with
+   * GetJointHistogram(). */
+  unsigned int AddJointHistogram( unsigned int component0, unsigned int component1 );
+  void ClearJointHistograms();
+  const JointHistogramPairsType & GetJointHistogramPairs() const
+    {
+    return m_JointHistogramPairs;
+    }
+
+  /** Set/Get the number of bins of the histograms, in each dimension */
+  itkSetMacro(NumberOfBins, unsigned int);
+  itkGetConstReferenceMacro(NumberOfBins, unsigned int);
+
+  /** Set/Get the quantiles to compute, as values in [0, 1] */
+  void SetQuantiles( const QuantilesType & quantiles );
+  itkGetConstReferenceMacro(Quantiles, QuantilesType);
+
+  /** Set/Get the number of threads used to compute the statistics */
+  itkSetClampMacro(NumberOfThreads, int, 1, ITK_MAX_THREADS);
+  itkGetConstReferenceMacro(NumberOfThreads, int);
+
+  /** Get the statistics of a component of the measurement vector */
+  double GetMinimum( unsigned int component ) const
+    {
+    return m_Minimum[ component ];
+    }
+  double GetMaximum( unsigned int component ) const
+    {
+    return m_Maximum[ component ];
+    }
+  double GetMean( unsigned int component ) const
+    {
+    return m_Mean[ component ];
+    }
+  /** Get the value of the i-th quantile given with SetQuantiles() */
+  double GetQuantile( unsigned int component, unsigned int i ) const
+    {
+    return m_QuantileValues[ component ][ i ];
+    }
+
+  /** Get the number of nodes in the tree */
+  itkGetConstMacro(NumberOfNodes, unsigned long);
+
+protected:
+  ComponentTreeAttributeStatisticsFilter();
+  ~ComponentTreeAttributeStatisticsFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  DataObject::Pointer MakeOutput(unsigned int idx);
+
+  void GenerateData();
+
+  /** Store the measurements of all the nodes in m_Measurements */
+  void CollectMeasurements( const NodeType * node );
+
+  /** Compute the partial results of a thread */
+  void ThreadedComputeRange( int threadId, int numberOfThreads );
+  void ThreadedComputeHistograms( int threadId, int numberOfThreads );
+
+  /** Compute the bin of a value in the histograms of a component */
+  inline unsigned int ComputeBin( unsigned int component, double value ) const
+    {
+    const double range = m_Maximum[component] - m_Minimum[component];
+    if( range <= 0 )
+      {
+      return 0;
+      }
+    const unsigned int bin = static_cast< unsigned int >( ( value - m_Minimum[component] ) / range * m_NumberOfBins );
+    return std::min( bin, m_NumberOfBins - 1 );
+    }
+
+  static ITK_THREAD_RETURN_TYPE ComputeRangeThreaderCallback( void * arg );
+  static ITK_THREAD_RETURN_TYPE ComputeHistogramsThreaderCallback( void * arg );
+
+private:
+  ComponentTreeAttributeStatisticsFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  typedef std::vector< double > ValuesType;
+  typedef std::vector< unsigned long > FrequenciesType;
+
+  unsigned int m_NumberOfBins;
+  QuantilesType m_Quantiles;
+  JointHistogramPairsType m_JointHistogramPairs;
+  int m_NumberOfThreads;
+
+  unsigned long m_NumberOfNodes;
+  ValuesType m_Minimum;
+  ValuesType m_Maximum;
+  ValuesType m_Mean;
+  std::vector< ValuesType > m_QuantileValues;
+
+  // the measurements, packed node by node
+  ValuesType m_Measurements;
+
+  // the partial results of the threads
+  std::vector< ValuesType > m_ThreadMinimum;
+  std::vector< ValuesType > m_ThreadMaximum;
+  std::vector< ValuesType > m_ThreadSum;
+  std::vector< std::vector< FrequenciesType > > m_ThreadFrequencies;
+  std::vector< std::vector< FrequenciesType > > m_ThreadJointFrequencies;
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkComponentTreeAttributeStatisticsFilter.txx"
+#endif
+
+#endif
+
+
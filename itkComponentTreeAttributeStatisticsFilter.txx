@@ -0,0 +1,460 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeAttributeStatisticsFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeAttributeStatisticsFilter_txx
+#define __itkComponentTreeAttributeStatisticsFilter_txx
+
+#include "itkComponentTreeAttributeStatisticsFilter.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+#include <stack>
+
+
+namespace itk {
+
+template<class TImage, class TMeasurementAccessor>
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::ComponentTreeAttributeStatisticsFilter()
+{
+  m_NumberOfBins = 128;
+  m_Quantiles.push_back( 0.25 );
+  m_Quantiles.push_back( 0.5 );
+  m_Quantiles.push_back( 0.75 );
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_NumberOfNodes = 0;
+
+  m_Minimum.resize( MeasurementVectorSize, 0 );
+  m_Maximum.resize( MeasurementVectorSize, 0 );
+  m_Mean.resize( MeasurementVectorSize, 0 );
+  m_QuantileValues.resize( MeasurementVectorSize );
+
+  this->SetNumberOfRequiredInputs(1);
+  this->SetNumberOfRequiredOutputs(MeasurementVectorSize);
+  for( unsigned int i=0; i<MeasurementVectorSize; i++ )
+    {
+    this->ProcessObject::SetNthOutput( i, this->MakeOutput(i) );
+    }
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+void
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::SetInput( const ImageType * input )
+{
+  this->ProcessObject::SetNthInput( 0, const_cast< ImageType * >( input ) );
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+const typename ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>::ImageType *
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::GetInput() const
+{
+  if ( this->GetNumberOfInputs() < 1 )
+    {
+    return 0;
+    }
+  return static_cast< const ImageType * >( this->ProcessObject::GetInput(0) );
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+DataObject::Pointer
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::MakeOutput( unsigned int itkNotUsed(idx) )
+{
+  HistogramPointer output = HistogramType::New();
+  return static_cast< DataObject * >( output );
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+const typename ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>::HistogramType *
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::GetHistogram( unsigned int component ) const
+{
+  assert( component < MeasurementVectorSize );
+  return static_cast< const HistogramType * >( this->ProcessObject::GetOutput( component ) );
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+const typename ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>::HistogramType *
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::GetJointHistogram( unsigned int i ) const
+{
+  assert( i < m_JointHistogramPairs.size() );
+  return static_cast< const HistogramType * >( this->ProcessObject::GetOutput( MeasurementVectorSize + i ) );
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+unsigned int
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::AddJointHistogram( unsigned int component0, unsigned int component1 )
+{
+  if( component0 >= MeasurementVectorSize || component1 >= MeasurementVectorSize )
+    {
+    itkExceptionMacro( << "Invalid component for joint histogram: " << component0 << ", " << component1 );
+    }
+  m_JointHistogramPairs.push_back( JointHistogramPairType( component0, component1 ) );
+  const unsigned int nbOfOutputs = MeasurementVectorSize + m_JointHistogramPairs.size();
+  this->SetNumberOfRequiredOutputs( nbOfOutputs );
+  this->ProcessObject::SetNthOutput( nbOfOutputs - 1, this->MakeOutput( nbOfOutputs - 1 ) );
+  this->Modified();
+  return m_JointHistogramPairs.size() - 1;
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+void
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::ClearJointHistograms()
+{
+  if( !m_JointHistogramPairs.empty() )
+    {
+    m_JointHistogramPairs.clear();
+    this->SetNumberOfRequiredOutputs( MeasurementVectorSize );
+    this->SetNumberOfOutputs( MeasurementVectorSize );
+    this->Modified();
+    }
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+void
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::SetQuantiles( const QuantilesType & quantiles )
+{
+  for( typename QuantilesType::const_iterator it=quantiles.begin(); it!=quantiles.end(); it++ )
+    {
+    if( *it < 0.0 || *it > 1.0 )
+      {
+      itkExceptionMacro( << "Quantiles must be in [0, 1]." );
+      }
+    }
+  m_Quantiles = quantiles;
+  this->Modified();
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+void
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::GenerateData()
+{
+  ProgressReporter progress(this, 0, 4);
+
+  // pack the measurements in a single traversal of the tree
+  m_Measurements.clear();
+  this->CollectMeasurements( this->GetInput()->GetRoot() );
+  m_NumberOfNodes = m_Measurements.size() / MeasurementVectorSize;
+  progress.CompletedPixel();
+
+  // don't use more threads than nodes
+  int numberOfThreads = m_NumberOfThreads;
+  if( static_cast< unsigned long >( numberOfThreads ) > m_NumberOfNodes )
+    {
+    numberOfThreads = std::max( 1, static_cast< int >( m_NumberOfNodes ) );
+    }
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( numberOfThreads );
+
+  // minimum, maximum and mean
+  m_ThreadMinimum.assign( numberOfThreads, ValuesType( MeasurementVectorSize, NumericTraits< double >::max() ) );
+  m_ThreadMaximum.assign( numberOfThreads, ValuesType( MeasurementVectorSize, NumericTraits< double >::NonpositiveMin() ) );
+  m_ThreadSum.assign( numberOfThreads, ValuesType( MeasurementVectorSize, 0.0 ) );
+  threader->SetSingleMethod( this->ComputeRangeThreaderCallback, this );
+  threader->SingleMethodExecute();
+
+  for( unsigned int i=0; i<MeasurementVectorSize; i++ )
+    {
+    double sum = 0;
+    m_Minimum[i] = NumericTraits< double >::max();
+    m_Maximum[i] = NumericTraits< double >::NonpositiveMin();
+    for( int t=0; t<numberOfThreads; t++ )
+      {
+      m_Minimum[i] = std::min( m_Minimum[i], m_ThreadMinimum[t][i] );
+      m_Maximum[i] = std::max( m_Maximum[i], m_ThreadMaximum[t][i] );
+      sum += m_ThreadSum[t][i];
+      }
+    if( m_NumberOfNodes == 0 )
+      {
+      m_Minimum[i] = m_Maximum[i] = 0;
+      }
+    m_Mean[i] = m_NumberOfNodes ? sum / m_NumberOfNodes : 0.0;
+    }
+  progress.CompletedPixel();
+
+  // histograms
+  m_ThreadFrequencies.assign( numberOfThreads,
+    std::vector< FrequenciesType >( MeasurementVectorSize, FrequenciesType( m_NumberOfBins, 0 ) ) );
+  m_ThreadJointFrequencies.assign( numberOfThreads,
+    std::vector< FrequenciesType >( m_JointHistogramPairs.size(), FrequenciesType( m_NumberOfBins * m_NumberOfBins, 0 ) ) );
+  threader->SetSingleMethod( this->ComputeHistogramsThreaderCallback, this );
+  threader->SingleMethodExecute();
+
+  for( unsigned int i=0; i<MeasurementVectorSize; i++ )
+    {
+    HistogramType * histogram = static_cast< HistogramType * >( this->ProcessObject::GetOutput( i ) );
+    typename HistogramType::SizeType size;
+    size.SetSize( 1 );
+    size.Fill( m_NumberOfBins );
+    typename HistogramType::MeasurementVectorType lower;
+    lower.SetSize( 1 );
+    lower[0] = m_Minimum[i];
+    typename HistogramType::MeasurementVectorType upper;
+    upper.SetSize( 1 );
+    upper[0] = m_Maximum[i];
+    histogram->SetMeasurementVectorSize( 1 );
+    histogram->SetClipBinsAtEnds( false );
+    histogram->Initialize( size, lower, upper );
+    for( unsigned int b=0; b<m_NumberOfBins; b++ )
+      {
+      unsigned long frequency = 0;
+      for( int t=0; t<numberOfThreads; t++ )
+        {
+        frequency += m_ThreadFrequencies[t][i][b];
+        }
+      histogram->SetFrequency( b, frequency );
+      }
+    }
+
+  for( unsigned int j=0; j<m_JointHistogramPairs.size(); j++ )
+    {
+    const unsigned int c0 = m_JointHistogramPairs[j].first;
+    const unsigned int c1 = m_JointHistogramPairs[j].second;
+    HistogramType * histogram = static_cast< HistogramType * >( this->ProcessObject::GetOutput( MeasurementVectorSize + j ) );
+    typename HistogramType::SizeType size;
+    size.SetSize( 2 );
+    size.Fill( m_NumberOfBins );
+    typename HistogramType::MeasurementVectorType lower;
+    lower.SetSize( 2 );
+    lower[0] = m_Minimum[c0];
+    lower[1] = m_Minimum[c1];
+    typename HistogramType::MeasurementVectorType upper;
+    upper.SetSize( 2 );
+    upper[0] = m_Maximum[c0];
+    upper[1] = m_Maximum[c1];
+    histogram->SetMeasurementVectorSize( 2 );
+    histogram->SetClipBinsAtEnds( false );
+    histogram->Initialize( size, lower, upper );
+    typename HistogramType::IndexType index;
+    index.SetSize( 2 );
+    for( unsigned int b1=0; b1<m_NumberOfBins; b1++ )
+      {
+      for( unsigned int b0=0; b0<m_NumberOfBins; b0++ )
+        {
+        unsigned long frequency = 0;
+        for( int t=0; t<numberOfThreads; t++ )
+          {
+          frequency += m_ThreadJointFrequencies[t][j][ b0 + b1 * m_NumberOfBins ];
+          }
+        index[0] = b0;
+        index[1] = b1;
+        histogram->SetFrequency( histogram->GetInstanceIdentifier( index ), frequency );
+        }
+      }
+    }
+  progress.CompletedPixel();
+
+  // quantiles - nth_element is linear, and the quantiles are searched in
+  // increasing order to reduce the range to partition at each step
+  std::vector< unsigned int > order( m_Quantiles.size() );
+  for( unsigned int k=0; k<order.size(); k++ )
+    {
+    order[k] = k;
+    }
+  for( unsigned int k=0; k<order.size(); k++ )
+    {
+    for( unsigned int l=k+1; l<order.size(); l++ )
+      {
+      if( m_Quantiles[ order[l] ] < m_Quantiles[ order[k] ] )
+        {
+        std::swap( order[k], order[l] );
+        }
+      }
+    }
+
+  ValuesType values( m_NumberOfNodes );
+  for( unsigned int i=0; i<MeasurementVectorSize; i++ )
+    {
+    m_QuantileValues[i].assign( m_Quantiles.size(), 0.0 );
+    if( m_NumberOfNodes == 0 )
+      {
+      continue;
+      }
+    for( unsigned long n=0; n<m_NumberOfNodes; n++ )
+      {
+      values[n] = m_Measurements[ n * MeasurementVectorSize + i ];
+      }
+    typename ValuesType::iterator first = values.begin();
+    for( unsigned int k=0; k<order.size(); k++ )
+      {
+      typename ValuesType::iterator nth = values.begin()
+        + static_cast< unsigned long >( m_Quantiles[ order[k] ] * ( m_NumberOfNodes - 1 ) );
+      std::nth_element( first, nth, values.end() );
+      m_QuantileValues[i][ order[k] ] = *nth;
+      first = nth;
+      }
+    }
+  progress.CompletedPixel();
+
+  // release the temporary data
+  m_Measurements.clear();
+  m_ThreadMinimum.clear();
+  m_ThreadMaximum.clear();
+  m_ThreadSum.clear();
+  m_ThreadFrequencies.clear();
+  m_ThreadJointFrequencies.clear();
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+void
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::CollectMeasurements( const NodeType * root )
+{
+  MeasurementAccessorType accessor;
+
+  // avoid the recursion to not pay a function call per node
+  std::stack< const NodeType * > nodes;
+  nodes.push( root );
+  while( !nodes.empty() )
+    {
+    const NodeType * node = nodes.top();
+    nodes.pop();
+
+    const MeasurementVectorType mv = accessor( node );
+    for( unsigned int i=0; i<MeasurementVectorSize; i++ )
+      {
+      m_Measurements.push_back( mv[i] );
+      }
+
+    const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+    for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+      {
+      nodes.push( *it );
+      }
+    }
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+void
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::ThreadedComputeRange( int threadId, int numberOfThreads )
+{
+  const unsigned long begin = m_NumberOfNodes * threadId / numberOfThreads;
+  const unsigned long end = m_NumberOfNodes * ( threadId + 1 ) / numberOfThreads;
+
+  ValuesType & minimum = m_ThreadMinimum[ threadId ];
+  ValuesType & maximum = m_ThreadMaximum[ threadId ];
+  ValuesType & sum = m_ThreadSum[ threadId ];
+
+  for( unsigned long n=begin; n<end; n++ )
+    {
+    const double * mv = & m_Measurements[ n * MeasurementVectorSize ];
+    for( unsigned int i=0; i<MeasurementVectorSize; i++ )
+      {
+      minimum[i] = std::min( minimum[i], mv[i] );
+      maximum[i] = std::max( maximum[i], mv[i] );
+      sum[i] += mv[i];
+      }
+    }
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+void
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::ThreadedComputeHistograms( int threadId, int numberOfThreads )
+{
+  const unsigned long begin = m_NumberOfNodes * threadId / numberOfThreads;
+  const unsigned long end = m_NumberOfNodes * ( threadId + 1 ) / numberOfThreads;
+
+  std::vector< FrequenciesType > & frequencies = m_ThreadFrequencies[ threadId ];
+  std::vector< FrequenciesType > & jointFrequencies = m_ThreadJointFrequencies[ threadId ];
+
+  unsigned int bins[MeasurementVectorSize];
+  for( unsigned long n=begin; n<end; n++ )
+    {
+    const double * mv = & m_Measurements[ n * MeasurementVectorSize ];
+    for( unsigned int i=0; i<MeasurementVectorSize; i++ )
+      {
+      bins[i] = this->ComputeBin( i, mv[i] );
+      frequencies[i][ bins[i] ]++;
+      }
+    for( unsigned int j=0; j<m_JointHistogramPairs.size(); j++ )
+      {
+      const JointHistogramPairType & p = m_JointHistogramPairs[j];
+      jointFrequencies[j][ bins[p.first] + bins[p.second] * m_NumberOfBins ]++;
+      }
+    }
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+ITK_THREAD_RETURN_TYPE
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::ComputeRangeThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self * filter = static_cast< Self * >( info->UserData );
+  filter->ThreadedComputeRange( info->ThreadID, info->NumberOfThreads );
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+ITK_THREAD_RETURN_TYPE
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::ComputeHistogramsThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self * filter = static_cast< Self * >( info->UserData );
+  filter->ThreadedComputeHistograms( info->ThreadID, info->NumberOfThreads );
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+template<class TImage, class TMeasurementAccessor>
+void
+ComponentTreeAttributeStatisticsFilter<TImage, TMeasurementAccessor>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfBins: " << m_NumberOfBins << std::endl;
+  os << indent << "Quantiles:";
+  for( typename QuantilesType::const_iterator it=m_Quantiles.begin(); it!=m_Quantiles.end(); it++ )
+    {
+    os << " " << *it;
+    }
+  os << std::endl;
+  os << indent << "JointHistograms:";
+  for( typename JointHistogramPairsType::const_iterator it=m_JointHistogramPairs.begin(); it!=m_JointHistogramPairs.end(); it++ )
+    {
+    os << " (" << it->first << ", " << it->second << ")";
+    }
+  os << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "NumberOfNodes: " << m_NumberOfNodes << std::endl;
+}
+
+}// end namespace itk
+#endif
@@ -17,8 +17,7 @@
 #ifndef __itkComponentTreeAttributeToImageFilter_h
 #define __itkComponentTreeAttributeToImageFilter_h
 
-#include "itkImageToImageFilter.h"
-#include "itkProgressReporter.h"
+#include "itkThreadedComponentTreeToImageFilter.h"
 
 namespace itk {
 
@@ -36,12 +35,12 @@ namespace itk {
  */
 template<class TInputImage, class TOutputImage>
 class ITK_EXPORT ComponentTreeAttributeToImageFilter : 
-    public ImageToImageFilter<TInputImage, TOutputImage>
+    public ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
 {
 public:
   /** Standard class typedefs. */
   typedef ComponentTreeAttributeToImageFilter Self;
-  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage> Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
 
@@ -69,7 +68,7 @@ public:
 
   /** Runtime information support. */
   itkTypeMacro(ComponentTreeAttributeToImageFilter, 
-               ImageToImageFilter);
+               ThreadedComponentTreeToImageFilter);
 
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
@@ -87,27 +86,16 @@ protected:
   ~ComponentTreeAttributeToImageFilter() {};
   void PrintSelf(std::ostream& os, Indent indent) const;
 
-  /** ComponentTreeAttributeToImageFilter needs the entire input be
-   * available. Thus, it needs to provide an implementation of
-   * GenerateInputRequestedRegion(). */
-  void GenerateInputRequestedRegion() ;
-
-  /** ComponentTreeAttributeToImageFilter will produce the entire output. */
-  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
-  
-  /** Single-threaded version of GenerateData.  This filter delegates
-   * to GrayscaleGeodesicErodeImageFilter. */
-    void GenerateData();
-
-  void WriteNodes( const NodeType* );
-  
+  /** Return the attribute value of the node */
+  OutputImagePixelType GetNodeValue( const NodeType * node )
+    {
+    return static_cast<OutputImagePixelType>( node->GetAttribute() );
+    }
 
 private:
   ComponentTreeAttributeToImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
-  ProgressReporter * m_Progress;
-
 } ; // end of class
 
 } // end namespace itk
@@ -17,12 +17,7 @@
 #ifndef __itkComponentTreeAttributeToImageFilter_txx
 #define __itkComponentTreeAttributeToImageFilter_txx
 
-#include "itkImageRegionIterator.h"
-#include "itkImageRegionConstIterator.h"
 #include "itkComponentTreeAttributeToImageFilter.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
-#include <algorithm>
-#include <list>
 
 
 namespace itk {
@@ -33,75 +28,6 @@ ComponentTreeAttributeToImageFilter<TInputImage, TOutputImage>
 {
 }
 
-template <class TInputImage, class TOutputImage>
-void 
-ComponentTreeAttributeToImageFilter<TInputImage, TOutputImage>
-::GenerateInputRequestedRegion()
-{
-  // call the superclass' implementation of this method
-  Superclass::GenerateInputRequestedRegion();
-  
-  // We need all the input.
-  InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
-  
-  if ( !input )
-    { return; }
-
-  input->SetRequestedRegion( input->GetLargestPossibleRegion() );
-}
-
-
-template <class TInputImage, class TOutputImage>
-void 
-ComponentTreeAttributeToImageFilter<TInputImage, TOutputImage>
-::EnlargeOutputRequestedRegion(DataObject *)
-{
-  this->GetOutput()
-    ->SetRequestedRegion( this->GetOutput()->GetLargestPossibleRegion() );
-}
-
-
-template<class TInputImage, class TOutputImage>
-void
-ComponentTreeAttributeToImageFilter<TInputImage, TOutputImage>
-::GenerateData()
-{
-  // Allocate the output
-  this->AllocateOutputs();
-  m_Progress = new ProgressReporter(this, 0, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels());
-  this->WriteNodes( this->GetInput()->GetRoot() );
-  delete m_Progress;
-  m_Progress = NULL;
-    
-  
-}
-
-
-template<class TInputImage, class TOutputImage>
-void
-ComponentTreeAttributeToImageFilter<TInputImage, TOutputImage>
-::WriteNodes( const NodeType* node )
-{
-  assert(node != NULL);
-  OutputImagePixelType v = static_cast<OutputImagePixelType>( node->GetAttribute() );
-  OutputImageType* output = this->GetOutput();
-
-  for( typename NodeType::IndexType current=node->GetFirstIndex();
-       current != NodeType::EndIndex;
-       current = this->GetInput()->GetLinkedListArray()[ current ] )
-    {
-    // std::cout << *it << ": " << v << std::endl;
-    output->SetPixel( output->ComputeIndex( current ), v );
-    m_Progress->CompletedPixel();
-    }
-  
-  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
-  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
-    {
-    this->WriteNodes( *it );
-    }
-}
-
 
 template<class TInputImage, class TOutputImage>
 void
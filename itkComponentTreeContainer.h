@@ -0,0 +1,144 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeContainer.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeContainer_h
+#define __itkComponentTreeContainer_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include <vector>
+
+namespace itk
+{
+
+/** \class ComponentTreeContainer
+ *  \brief Store the nodes and the pixel lists of an itk::ComponentTree
+ *
+ * This class owns the root node, and thus all the nodes of the tree, and
+ * the linked list array which stores the pixels of the nodes. The nodes are
+ * deleted with the container.
+ *
+ * It is reference counted, so several trees can share the same data, as
+ * the images share their pixel container: ComponentTree::Graft() only
+ * shares the container, and doesn't copy anything.
+ *
+ * The pixels can also be stored as runs of consecutive pixels along the
+ * first dimension, instead of the linked list array. In that case, the
+ * linked list array is empty, and the first and last index of each node
+ * are the range of its runs in the run array. See
+ * ComponentTree::EncodeRunLength().
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ComponentTree
+ * \ingroup ImageObjects
+ */
+template <class TNode>
+class ITK_EXPORT ComponentTreeContainer : public Object
+{
+public:
+  /** Standard class typedefs */
+  typedef ComponentTreeContainer     Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer<Self>         Pointer;
+  typedef SmartPointer<const Self>   ConstPointer;
+
+  typedef TNode NodeType;
+
+  /** The linked list array: the offset of the next pixel of each pixel */
+  typedef std::vector< typename NodeType::IndexType > LinkedListArrayType;
+
+  /** A run of pixels along the first dimension */
+  struct RunType
+    {
+    /** the offset of the first pixel of the run */
+    typename NodeType::IndexType Offset;
+    typename NodeType::IndexType Length;
+    };
+  typedef std::vector< RunType > RunsType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Standard part of every itk Object. */
+  itkTypeMacro(ComponentTreeContainer, Object);
+
+  /** Get the root node. May be NULL. */
+  NodeType * GetRoot()
+    {
+    return m_Root;
+    }
+
+  const NodeType * GetRoot() const
+    {
+    return m_Root;
+    }
+
+  /** Set the root node. The container takes the ownership of the node and
+   * of its children. The previous root, if any, is deleted. */
+  void SetRoot( NodeType * root );
+
+  const LinkedListArrayType & GetLinkedListArray() const
+    {
+    return m_LinkedListArray;
+    }
+
+  LinkedListArrayType & GetLinkedListArray()
+    {
+    return m_LinkedListArray;
+    }
+
+  const RunsType & GetRuns() const
+    {
+    return m_Runs;
+    }
+
+  RunsType & GetRuns()
+    {
+    return m_Runs;
+    }
+
+  /** Set/Get whether the pixels are stored in the runs rather than in the
+   * linked list array. */
+  itkSetMacro(RunLengthEncoded, bool);
+  itkGetConstMacro(RunLengthEncoded, bool);
+
+protected:
+  ComponentTreeContainer();
+  virtual ~ComponentTreeContainer();
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+private:
+  ComponentTreeContainer(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  /** The root node */
+  NodeType * m_Root;
+
+  LinkedListArrayType m_LinkedListArray;
+
+  RunsType m_Runs;
+
+  bool m_RunLengthEncoded;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkComponentTreeContainer.txx"
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeContainer.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeContainer_txx
+#define __itkComponentTreeContainer_txx
+
+#include "itkComponentTreeContainer.h"
+
+namespace itk
+{
+
+template <class TNode>
+ComponentTreeContainer<TNode>
+::ComponentTreeContainer()
+{
+  m_Root = NULL;
+  m_RunLengthEncoded = false;
+}
+
+
+template <class TNode>
+ComponentTreeContainer<TNode>
+::~ComponentTreeContainer()
+{
+  if( m_Root )
+    {
+    delete m_Root;
+    }
+}
+
+
+template <class TNode>
+void
+ComponentTreeContainer<TNode>
+::SetRoot( NodeType * root )
+{
+  if( m_Root != root )
+    {
+    if( m_Root )
+      {
+      delete m_Root;
+      }
+    m_Root = root;
+    this->Modified();
+    }
+}
+
+
+template <class TNode>
+void
+ComponentTreeContainer<TNode>
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Root: " << m_Root << std::endl;
+  os << indent << "LinkedListArray size: " << m_LinkedListArray.size() << std::endl;
+  os << indent << "Runs size: " << m_Runs.size() << std::endl;
+  os << indent << "RunLengthEncoded: " << m_RunLengthEncoded << std::endl;
+}
+
+} // end namespace itk
+
+#endif
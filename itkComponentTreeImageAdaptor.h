@@ -0,0 +1,229 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeImageAdaptor.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeImageAdaptor_h
+#define __itkComponentTreeImageAdaptor_h
+
+#include "itkImageAdaptor.h"
+#include "itkComponentTreeToNodeIdImageFilter.h"
+#include "itkComponentTreeNode.h"
+#include <vector>
+
+namespace itk {
+
+namespace Accessor {
+
+/** \class ComponentTreeNodeValuePixelAccessor
+ * \brief Give access to the pixel value of the node stored in a pixel
+ *
+ * The pixel stores the id of the node in the node table of the adaptor.
+ * The accessor is read only.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ComponentTreeImageAdaptor
+ * \ingroup ImageAdaptors
+ */
+template< class TNode, class TExternalType=typename TNode::PixelType >
+class ITK_EXPORT ComponentTreeNodeValuePixelAccessor
+{
+public:
+  typedef TExternalType ExternalType;
+  typedef unsigned int InternalType;
+  typedef std::vector< const TNode * > NodeTableType;
+
+  ComponentTreeNodeValuePixelAccessor()
+    {
+    m_NodeTable = NULL;
+    }
+
+  inline ExternalType Get( const InternalType & input ) const
+    {
+    return static_cast< ExternalType >( (*m_NodeTable)[ input ]->GetPixel() );
+    }
+
+  void SetNodeTable( const NodeTableType * table )
+    {
+    m_NodeTable = table;
+    }
+
+private:
+  const NodeTableType * m_NodeTable;
+};
+
+
+/** \class ComponentTreeNodeAttributePixelAccessor
+ * \brief Give access to the attribute of the node stored in a pixel
+ *
+ * The attribute is read with TAttibuteAccessor, so an attribute stored in
+ * a more complex type can be used as well. The pixel stores the id of the
+ * node in the node table of the adaptor.
+ * The accessor is read only.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ComponentTreeImageAdaptor
+ * \ingroup ImageAdaptors
+ */
+template< class TNode, class TExternalType=double,
+          class TAttibuteAccessor=typename Functor::AttributeComponentTreeNodeAccessor< TNode > >
+class ITK_EXPORT ComponentTreeNodeAttributePixelAccessor
+{
+public:
+  typedef TExternalType ExternalType;
+  typedef unsigned int InternalType;
+  typedef TAttibuteAccessor AttributeAccessorType;
+  typedef std::vector< const TNode * > NodeTableType;
+
+  ComponentTreeNodeAttributePixelAccessor()
+    {
+    m_NodeTable = NULL;
+    }
+
+  inline ExternalType Get( const InternalType & input ) const
+    {
+    AttributeAccessorType accessor;
+    return static_cast< ExternalType >( accessor( (*m_NodeTable)[ input ] ) );
+    }
+
+  void SetNodeTable( const NodeTableType * table )
+    {
+    m_NodeTable = table;
+    }
+
+private:
+  const NodeTableType * m_NodeTable;
+};
+
+} // end namespace Accessor
+
+
+/** \class ComponentTreeImageAdaptor
+ * \brief Present an itk::ComponentTree as an image, without producing the image
+ *
+ * ComponentTreeImageAdaptor gives access to the pixel values or the
+ * attributes of a component tree through the usual image interface, so it
+ * can be used as an input of the image filters and with the image
+ * iterators. The value of a pixel is computed only when it is read, with
+ * the accessor given as template parameter:
+ * Accessor::ComponentTreeNodeValuePixelAccessor, the default, produces the
+ * same values as ComponentTreeToImageFilter, and
+ * Accessor::ComponentTreeNodeAttributePixelAccessor the same values as
+ * ComponentTreeAttributeToImageFilter.
+ *
+ * The adaptor is built on an image of node ids and on a table of the
+ * nodes, computed by ComponentTreeToNodeIdImageFilter when
+ * SetComponentTree() is called. Reading a pixel is then just a lookup in
+ * the node table. The ids are stored on 32 bits, so the adaptor still
+ * materializes a full image of 4 bytes per pixel: it uses as much memory
+ * as the float image of an attribute produced by
+ * ComponentTreeAttributeToImageFilter, and more than the image of the pixel
+ * values when the pixel type is smaller. It saves memory only over the
+ * images of larger types, like double, and over an image of node pointers
+ * on a 64 bits system. Its main use is to give access to any value of the
+ * nodes, through the accessor, without writing a filter for it.
+ *
+ * The adaptor keeps a reference to the tree and to its container, so the
+ * nodes stay valid even if the tree is updated again by its source. It
+ * doesn't watch the tree though: the nodes must not be modified while the
+ * adaptor is in use, and SetComponentTree() must be called again to view the
+ * new content of the tree.
+ *
+ * The adaptor is read only.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ComponentTreeToNodeIdImageFilter, ComponentTreeToImageFilter, ComponentTreeAttributeToImageFilter
+ * \ingroup ImageAdaptors
+ */
+template< class TComponentTree,
+          class TPixelAccessor=Accessor::ComponentTreeNodeValuePixelAccessor< typename TComponentTree::NodeType > >
+class ITK_EXPORT ComponentTreeImageAdaptor :
+    public ImageAdaptor< Image< unsigned int, TComponentTree::ImageDimension >, TPixelAccessor >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ComponentTreeImageAdaptor Self;
+  typedef ImageAdaptor< Image< unsigned int, TComponentTree::ImageDimension >, TPixelAccessor > Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TComponentTree ComponentTreeType;
+  typedef typename ComponentTreeType::ConstPointer ComponentTreeConstPointer;
+  typedef typename ComponentTreeType::NodeType NodeType;
+  typedef typename ComponentTreeType::ContainerType ContainerType;
+  typedef typename ContainerType::ConstPointer ContainerConstPointer;
+  typedef Image< unsigned int, TComponentTree::ImageDimension > NodeImageType;
+  typedef ComponentTreeToNodeIdImageFilter< ComponentTreeType, NodeImageType > NodeImageFilterType;
+  typedef typename NodeImageFilterType::NodeTableType NodeTableType;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ComponentTreeImageAdaptor, ImageAdaptor);
+
+  /** Set the tree to view. The pixel to node id image and the node table
+   * are computed immediately. */
+  void SetComponentTree( const ComponentTreeType * tree )
+    {
+    if( tree == NULL )
+      {
+      itkExceptionMacro( << "The component tree must not be NULL." );
+      }
+    typename NodeImageFilterType::Pointer filter = NodeImageFilterType::New();
+    filter->SetInput( tree );
+    filter->Update();
+    m_ComponentTree = tree;
+    m_Container = tree->GetContainer();
+    m_NodeTable.swap( filter->GetNodeTable() );
+    this->GetPixelAccessor().SetNodeTable( &m_NodeTable );
+    this->SetImage( filter->GetOutput() );
+    }
+
+  const ComponentTreeType * GetComponentTree() const
+    {
+    return m_ComponentTree;
+    }
+
+protected:
+  ComponentTreeImageAdaptor() {}
+  ~ComponentTreeImageAdaptor() {}
+  void PrintSelf(std::ostream& os, Indent indent) const
+    {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "ComponentTree: " << m_ComponentTree.GetPointer() << std::endl;
+    os << indent << "NodeTable size: " << m_NodeTable.size() << std::endl;
+    }
+
+private:
+  ComponentTreeImageAdaptor(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  ComponentTreeConstPointer m_ComponentTree;
+
+  // keep the nodes alive
+  ContainerConstPointer m_Container;
+
+  // the node of each id of the node image
+  NodeTableType m_NodeTable;
+
+} ; // end of class
+
+} // end namespace itk
+
+#endif
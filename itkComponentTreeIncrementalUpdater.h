@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeIncrementalUpdater.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeIncrementalUpdater_h
+#define __itkComponentTreeIncrementalUpdater_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkComponentTreeAccumulator.h"
+#include <vector>
+
+namespace itk {
+
+/** \class ComponentTreeIncrementalUpdater
+ * \brief Update a component tree after the modification of a region of its image
+ *
+ * The tree must have been built from the image with TCompare, for example
+ * with std::greater for a max tree built by ImageToMaximumTreeFilter, and
+ * with the same connectivity. Initialize() computes the node of each pixel
+ * once. Then, each time some pixels of the image are modified in place,
+ * UpdateRegion() updates the tree, in place, without building it again:
+ * - the nodes with some pixels in the modified region or next to it, and
+ * their ancestors, are removed from the tree. The ancestors are removed up
+ * to the first one shallower than both the old and the new values of the
+ * modified pixels: the level sets at the shallower levels are not
+ * modified, so that node keeps its pixels, and the rebuilt nodes are
+ * spliced under it.
+ * - the other children of the removed nodes are detached. Neither their
+ * pixels nor their neighbors have been modified, so they are still valid
+ * subtrees.
+ * - the removed part of the tree is built again with a union-find on the
+ * pixels of the removed nodes and on the detached subtrees, which are
+ * processed as single pixels with the value of their root, like the flat
+ * zones of the FlatZones algorithm of ImageToComponentTreeFilter.
+ *
+ * The work done is proportional to the number of pixels in the removed
+ * nodes, not to the size of the image. The update is fast when the
+ * modified region is small and when its new and old values are deep in
+ * the tree - high values in a max tree. Modifying the pixels to a value
+ * close to the one of the root rebuilds most of the tree.
+ *
+ * The attributes computed with TAccumulator are kept up to date: they are
+ * computed in the rebuilt nodes, the detached subtrees keep their
+ * attribute, and the kept ancestors of the rebuilt nodes get the attribute
+ * of the removed subtrees removed with Unmerge() and the one of the
+ * rebuilt subtrees added with Merge(). That adds the depth of the kept
+ * nodes to the work done. TAccumulator must be Unmergeable, which is
+ * checked at compile time. The attributes not computed with TAccumulator
+ * must be computed again.
+ *
+ * The image and the tree are not part of a pipeline here: both are
+ * modified in place, so they should be disconnected from the filters which
+ * produced them, with DisconnectPipeline().
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ImageToComponentTreeFilter NullComponentTreeAccumulator
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TImage, class TComponentTree, class TCompare,
+         class TAccumulator=Functor::NullComponentTreeAccumulator< typename TComponentTree::NodeType > >
+class ITK_EXPORT ComponentTreeIncrementalUpdater : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ComponentTreeIncrementalUpdater Self;
+  typedef Object                          Superclass;
+  typedef SmartPointer<Self>              Pointer;
+  typedef SmartPointer<const Self>        ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TImage                                   ImageType;
+  typedef typename ImageType::RegionType           RegionType;
+  typedef typename ImageType::IndexType            IndexType;
+  typedef typename ImageType::OffsetType           OffsetType;
+  typedef typename ImageType::OffsetValueType      OffsetValueType;
+  typedef TComponentTree                           ComponentTreeType;
+  typedef typename ComponentTreeType::PixelType    PixelType;
+  typedef typename ComponentTreeType::NodeType     NodeType;
+  typedef TCompare                                 CompareType;
+  typedef TAccumulator                             AccumulatorType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** The attributes of the kept nodes are updated with Unmerge(), so the
+   * accumulator must support it. */
+  typedef char AccumulatorMustBeUnmergeable[ AccumulatorType::Unmergeable ? 1 : -1 ];
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ComponentTreeIncrementalUpdater, Object);
+
+  /** Set/Get the image, modified in place by the user. */
+  itkSetConstObjectMacro(Image, ImageType);
+  itkGetConstObjectMacro(Image, ImageType);
+
+  /** Set/Get the tree built from the image, updated in place. */
+  itkSetObjectMacro(ComponentTree, ComponentTreeType);
+  itkGetObjectMacro(ComponentTree, ComponentTreeType);
+
+  /**
+   * Set/Get whether the connected components are defined strictly by
+   * face connectivity or by face+edge+vertex connectivity. It must be the
+   * one used to build the tree. Default is FullyConnectedOff.
+   */
+  itkSetMacro(FullyConnected, bool);
+  itkGetConstReferenceMacro(FullyConnected, bool);
+  itkBooleanMacro(FullyConnected);
+
+  /** Compute the node of each pixel of the tree. Must be called before
+   * UpdateRegion(), and again when the tree has been modified by something
+   * else than this object. The tree is decoded if it is run-length
+   * encoded. */
+  void Initialize();
+
+  /** Update the tree after the modification of the pixels of the image in
+   * region. */
+  void UpdateRegion( const RegionType & region );
+
+protected:
+  ComponentTreeIncrementalUpdater();
+  ~ComponentTreeIncrementalUpdater() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Order the vertices deepest first, and by position for the vertices
+   * with the same value */
+  class VertexCompare
+    {
+    public:
+    inline bool operator()( unsigned long a, unsigned long b ) const
+      {
+      if( m_Compare( (*m_Values)[a], (*m_Values)[b] ) )
+        {
+        return true;
+        }
+      if( m_Compare( (*m_Values)[b], (*m_Values)[a] ) )
+        {
+        return false;
+        }
+      return a < b;
+      }
+    const std::vector< PixelType > * m_Values;
+    CompareType m_Compare;
+    };
+
+  /** Return true if the node is removed by the current update. The node
+   * must have some pixels. */
+  inline bool IsRemoved( const NodeType * node, OffsetValueType numberOfPixelVertices ) const
+    {
+    const OffsetValueType id = m_VertexIds[ node->GetFirstIndex() ];
+    return id >= 0 && id < numberOfPixelVertices;
+    }
+
+private:
+  ComponentTreeIncrementalUpdater(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  typename ImageType::ConstPointer m_Image;
+  typename ComponentTreeType::Pointer m_ComponentTree;
+  bool                m_FullyConnected;
+
+  // the node of each pixel
+  std::vector< NodeType * > m_NodeMap;
+
+  // the id of the vertex of each pixel during an update, and the marks of
+  // the nodes, at the offset of their first pixel. -1 between the updates.
+  std::vector< OffsetValueType > m_VertexIds;
+
+  std::vector< OffsetType > m_Neighbors;
+  std::vector< OffsetValueType > m_NeighborOffsets;
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkComponentTreeIncrementalUpdater.txx"
+#endif
+
+#endif
+
+
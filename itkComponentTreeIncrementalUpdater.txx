@@ -0,0 +1,520 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeIncrementalUpdater.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeIncrementalUpdater_txx
+#define __itkComponentTreeIncrementalUpdater_txx
+
+#include "itkComponentTreeIncrementalUpdater.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include <algorithm>
+#include <utility>
+
+
+namespace itk {
+
+template <class TImage, class TComponentTree, class TCompare, class TAccumulator>
+ComponentTreeIncrementalUpdater<TImage, TComponentTree, TCompare, TAccumulator>
+::ComponentTreeIncrementalUpdater()
+{
+  m_Image = NULL;
+  m_ComponentTree = NULL;
+  m_FullyConnected = false;
+}
+
+
+template <class TImage, class TComponentTree, class TCompare, class TAccumulator>
+void
+ComponentTreeIncrementalUpdater<TImage, TComponentTree, TCompare, TAccumulator>
+::Initialize()
+{
+  if( m_Image.IsNull() || m_ComponentTree.IsNull() )
+    {
+    itkExceptionMacro( << "The image and the component tree must be set." );
+    }
+  if( m_Image->GetBufferedRegion() != m_ComponentTree->GetLargestPossibleRegion() )
+    {
+    itkExceptionMacro( << "The buffered region of the image doesn't match the region of the tree." );
+    }
+
+  m_ComponentTree->DecodeRunLength();
+
+  // the node of each pixel, with a traversal of the tree without recursion
+  const unsigned long numberOfPixels = m_ComponentTree->GetLargestPossibleRegion().GetNumberOfPixels();
+  m_NodeMap.assign( numberOfPixels, NULL );
+  m_VertexIds.assign( numberOfPixels, -1 );
+  const typename ComponentTreeType::LinkedListArrayType & linkedList = m_ComponentTree->GetLinkedListArray();
+  std::vector< NodeType * > stack;
+  if( m_ComponentTree->GetRoot() != NULL )
+    {
+    stack.push_back( m_ComponentTree->GetRoot() );
+    }
+  while( !stack.empty() )
+    {
+    NodeType * node = stack.back();
+    stack.pop_back();
+    for( typename NodeType::IndexType current=node->GetFirstIndex();
+         current != NodeType::EndIndex;
+         current = linkedList[ current ] )
+      {
+      m_NodeMap[ current ] = node;
+      }
+    const typename NodeType::ChildrenListType & children = node->GetChildren();
+    stack.insert( stack.end(), children.begin(), children.end() );
+    }
+
+  // the neighbors of a pixel with the current connectivity
+  const typename RegionType::SizeType & size = m_ComponentTree->GetLargestPossibleRegion().GetSize();
+  OffsetValueType strides[ImageDimension];
+  strides[0] = 1;
+  for( unsigned int d=1; d<ImageDimension; d++ )
+    {
+    strides[d] = strides[d-1] * size[d-1];
+    }
+  unsigned long neighborhoodSize = 1;
+  for( unsigned int d=0; d<ImageDimension; d++ )
+    {
+    neighborhoodSize *= 3;
+    }
+  m_Neighbors.clear();
+  m_NeighborOffsets.clear();
+  for( unsigned long i=0; i<neighborhoodSize; i++ )
+    {
+    OffsetType o;
+    unsigned long r = i;
+    unsigned int nbOfNonZero = 0;
+    OffsetValueType offset = 0;
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      o[d] = static_cast< long >( r % 3 ) - 1;
+      r /= 3;
+      if( o[d] != 0 )
+        {
+        nbOfNonZero++;
+        }
+      offset += o[d] * strides[d];
+      }
+    if( nbOfNonZero != 0 && ( m_FullyConnected || nbOfNonZero == 1 ) )
+      {
+      m_Neighbors.push_back( o );
+      m_NeighborOffsets.push_back( offset );
+      }
+    }
+}
+
+
+template <class TImage, class TComponentTree, class TCompare, class TAccumulator>
+void
+ComponentTreeIncrementalUpdater<TImage, TComponentTree, TCompare, TAccumulator>
+::UpdateRegion( const RegionType & region )
+{
+  if( m_NodeMap.empty() )
+    {
+    itkExceptionMacro( << "Initialize() must be called before UpdateRegion()." );
+    }
+  ComponentTreeType * tree = m_ComponentTree;
+  const RegionType & treeRegion = tree->GetLargestPossibleRegion();
+  tree->DecodeRunLength();
+
+  RegionType modifiedRegion = region;
+  if( !modifiedRegion.Crop( treeRegion ) )
+    {
+    return;
+    }
+
+  // the shallowest of the old and of the new values of the modified pixels.
+  // The level sets at the shallower levels are not modified, so the nodes
+  // shallower than that value keep their pixels.
+  const typename ImageType::PixelType * buffer = m_Image->GetBufferPointer();
+  CompareType compare;
+  PixelType shallowest = static_cast< PixelType >( buffer[ tree->ComputeOffset( modifiedRegion.GetIndex() ) ] );
+  ImageRegionConstIteratorWithIndex< ImageType > mIt( m_Image, modifiedRegion );
+  for( mIt.GoToBegin(); !mIt.IsAtEnd(); ++mIt )
+    {
+    const PixelType & oldValue = m_NodeMap[ tree->ComputeOffset( mIt.GetIndex() ) ]->GetPixel();
+    const PixelType newValue = static_cast< PixelType >( mIt.Get() );
+    if( compare( shallowest, oldValue ) )
+      {
+      shallowest = oldValue;
+      }
+    if( compare( shallowest, newValue ) )
+      {
+      shallowest = newValue;
+      }
+    }
+
+  // the nodes to rebuild: the ones with a touched pixel - the modified pixels
+  // and their neighbors - and their ancestors up to the first one shallower
+  // than the modified values. That one is kept, and the rebuilt nodes are
+  // spliced under it. The nodes are marked in m_VertexIds, at the offset of
+  // their first pixel.
+  RegionType touchedRegion = modifiedRegion;
+  touchedRegion.PadByRadius( 1 );
+  touchedRegion.Crop( treeRegion );
+  const OffsetValueType removedMark = -2;
+  std::vector< NodeType * > removed;
+  ImageRegionConstIteratorWithIndex< ImageType > it( m_Image, touchedRegion );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    NodeType * node = m_NodeMap[ tree->ComputeOffset( it.GetIndex() ) ];
+    while( node != NULL && !compare( shallowest, node->GetPixel() )
+           && m_VertexIds[ node->GetFirstIndex() ] != removedMark )
+      {
+      assert( node->GetFirstIndex() != NodeType::EndIndex );
+      m_VertexIds[ node->GetFirstIndex() ] = removedMark;
+      removed.push_back( node );
+      node = node->GetParent();
+      }
+    }
+
+  // the vertices of the graph to rebuild: the pixels of the removed nodes,
+  // with their new value, then the detached subtrees, with the value of
+  // their root. The id of a vertex is stored in m_VertexIds, at the offset of
+  // the pixel or of the first pixel of the root of the subtree. The first
+  // pixel of a removed node is a pixel vertex, so a node is removed when the
+  // id at its first pixel is the id of a pixel vertex.
+  std::vector< PixelType > values;
+  std::vector< OffsetValueType > offsets;
+  std::vector< NodeType * > detached;
+  const typename ComponentTreeType::LinkedListArrayType & linkedList = tree->GetLinkedListArray();
+  for( typename std::vector< NodeType * >::const_iterator nIt=removed.begin(); nIt!=removed.end(); nIt++ )
+    {
+    for( typename NodeType::IndexType current=(*nIt)->GetFirstIndex();
+         current != NodeType::EndIndex;
+         current = linkedList[ current ] )
+      {
+      m_VertexIds[ current ] = values.size();
+      values.push_back( static_cast< PixelType >( buffer[ current ] ) );
+      offsets.push_back( current );
+      detached.push_back( NULL );
+      }
+    }
+  const OffsetValueType numberOfPixelVertices = values.size();
+  // the offsets, other than the pixel vertices, to reset in m_VertexIds
+  std::vector< OffsetValueType > marked;
+  for( typename std::vector< NodeType * >::const_iterator nIt=removed.begin(); nIt!=removed.end(); nIt++ )
+    {
+    const typename NodeType::ChildrenListType & children = (*nIt)->GetChildren();
+    for( typename NodeType::ChildrenListType::const_iterator cIt=children.begin(); cIt!=children.end(); cIt++ )
+      {
+      if( !this->IsRemoved( *cIt, numberOfPixelVertices ) )
+        {
+        m_VertexIds[ (*cIt)->GetFirstIndex() ] = values.size();
+        marked.push_back( (*cIt)->GetFirstIndex() );
+        values.push_back( (*cIt)->GetPixel() );
+        offsets.push_back( -1 );
+        detached.push_back( *cIt );
+        }
+      }
+    }
+  const unsigned long numberOfVertices = values.size();
+
+  // the edges of the graph. Two detached subtrees are never adjacent, so
+  // only the neighbors of the pixels are needed. A neighbor shallower than
+  // the modified values is in a kept node, and is not part of the graph.
+  std::vector< std::pair< unsigned long, unsigned long > > edges;
+  std::vector< NodeType * > path;
+  const unsigned int numberOfNeighbors = m_Neighbors.size();
+  for( OffsetValueType v=0; v<numberOfPixelVertices; v++ )
+    {
+    const OffsetValueType p = offsets[v];
+    const IndexType idx = tree->ComputeIndex( p );
+    for( unsigned int j=0; j<numberOfNeighbors; j++ )
+      {
+      if( !treeRegion.IsInside( idx + m_Neighbors[j] ) )
+        {
+        continue;
+        }
+      const OffsetValueType n = p + m_NeighborOffsets[j];
+      OffsetValueType id = m_VertexIds[n];
+      if( id >= 0 && id < numberOfPixelVertices )
+        {
+        edges.push_back( std::make_pair( v, id ) );
+        continue;
+        }
+      NodeType * node = m_NodeMap[n];
+      if( compare( shallowest, node->GetPixel() ) )
+        {
+        continue;
+        }
+      // the neighbor is in a detached subtree: find its root, and remember
+      // it in the nodes of the path for the next neighbors
+      path.clear();
+      while( m_VertexIds[ node->GetFirstIndex() ] < numberOfPixelVertices )
+        {
+        path.push_back( node );
+        node = node->GetParent();
+        assert( node != NULL && !this->IsRemoved( node, numberOfPixelVertices ) );
+        }
+      id = m_VertexIds[ node->GetFirstIndex() ];
+      for( typename std::vector< NodeType * >::const_iterator pIt=path.begin(); pIt!=path.end(); pIt++ )
+        {
+        m_VertexIds[ (*pIt)->GetFirstIndex() ] = id;
+        marked.push_back( (*pIt)->GetFirstIndex() );
+        }
+      edges.push_back( std::make_pair( v, id ) );
+      edges.push_back( std::make_pair( id, v ) );
+      }
+    }
+
+  // store the adjacency in a single array, with the position of the
+  // neighbors of each vertex
+  std::vector< unsigned long > adjacencyStart( numberOfVertices + 1, 0 );
+  for( unsigned long e=0; e<edges.size(); e++ )
+    {
+    adjacencyStart[ edges[e].first + 1 ]++;
+    }
+  for( unsigned long v=0; v<numberOfVertices; v++ )
+    {
+    adjacencyStart[ v + 1 ] += adjacencyStart[v];
+    }
+  std::vector< unsigned long > adjacency( edges.size() );
+  {
+  std::vector< unsigned long > position( adjacencyStart.begin(), adjacencyStart.end() - 1 );
+  for( unsigned long e=0; e<edges.size(); e++ )
+    {
+    adjacency[ position[ edges[e].first ]++ ] = edges[e].second;
+    }
+  }
+  std::vector< std::pair< unsigned long, unsigned long > >().swap( edges );
+
+  // union-find on the vertices, from the deepest ones, as in the
+  // RankTransform algorithm of ImageToComponentTreeFilter
+  std::vector< unsigned long > order( numberOfVertices );
+  for( unsigned long v=0; v<numberOfVertices; v++ )
+    {
+    order[v] = v;
+    }
+  VertexCompare vertexCompare;
+  vertexCompare.m_Values = &values;
+  std::sort( order.begin(), order.end(), vertexCompare );
+
+  const long unprocessed = -1;
+  std::vector< unsigned long > parent( numberOfVertices );
+  std::vector< long > zpar( numberOfVertices, unprocessed );
+  for( unsigned long i=0; i<numberOfVertices; i++ )
+    {
+    const unsigned long p = order[i];
+    parent[p] = p;
+    zpar[p] = p;
+    for( unsigned long a=adjacencyStart[p]; a<adjacencyStart[p+1]; a++ )
+      {
+      if( zpar[ adjacency[a] ] == unprocessed )
+        {
+        continue;
+        }
+      // find the root of the neighbor, with path halving
+      unsigned long r = adjacency[a];
+      while( zpar[r] != static_cast< long >( r ) )
+        {
+        zpar[r] = zpar[ zpar[r] ];
+        r = zpar[r];
+        }
+      if( r != p )
+        {
+        parent[r] = p;
+        zpar[r] = p;
+        }
+      }
+    }
+  std::vector< long >().swap( zpar );
+  std::vector< unsigned long >().swap( adjacency );
+  std::vector< unsigned long >().swap( adjacencyStart );
+
+  // make the parent of each vertex the canonical vertex of its node
+  for( long i=numberOfVertices-1; i>=0; i-- )
+    {
+    const unsigned long p = order[i];
+    const unsigned long q = parent[p];
+    if( values[ parent[q] ] == values[q] )
+      {
+      parent[p] = parent[q];
+      }
+    }
+
+  // the kept node where each rebuilt subtree is spliced: the first ancestor
+  // of its vertices which is not removed. It is NULL when the root is
+  // rebuilt.
+  std::vector< std::pair< unsigned long, NodeType * > > splices;
+  for( unsigned long p=0; p<numberOfVertices; p++ )
+    {
+    if( parent[p] == p )
+      {
+      NodeType * node = detached[p] != NULL ? detached[p]->GetParent() : m_NodeMap[ offsets[p] ];
+      while( node != NULL && this->IsRemoved( node, numberOfPixelVertices ) )
+        {
+        node = node->GetParent();
+        }
+      splices.push_back( std::make_pair( p, node ) );
+      }
+    }
+
+  // remove the rebuilt subtrees from the kept nodes, detach the subtrees,
+  // and delete the removed nodes. The old root is deleted by the tree when
+  // the new one is set. The attribute of a removed subtree is removed from
+  // the one of the kept node and of all its ancestors.
+  AccumulatorType accumulator;
+  accumulator.SetComponentTree( tree );
+  for( unsigned long s=0; s<splices.size(); s++ )
+    {
+    NodeType * splice = splices[s].second;
+    if( splice == NULL )
+      {
+      continue;
+      }
+    typename NodeType::ChildrenListType & children = splice->GetChildren();
+    typename NodeType::ChildrenListType::iterator cIt = children.begin();
+    while( cIt != children.end() )
+      {
+      if( this->IsRemoved( *cIt, numberOfPixelVertices ) )
+        {
+        if( AccumulatorType::Active )
+          {
+          for( NodeType * ancestor=splice; ancestor!=NULL; ancestor=ancestor->GetParent() )
+            {
+            accumulator.Unmerge( ancestor, *cIt );
+            }
+          }
+        cIt = children.erase( cIt );
+        }
+      else
+        {
+        cIt++;
+        }
+      }
+    }
+  NodeType * oldRoot = tree->GetRoot();
+  for( typename std::vector< NodeType * >::const_iterator nIt=removed.begin(); nIt!=removed.end(); nIt++ )
+    {
+    (*nIt)->GetChildren().clear();
+    }
+  for( typename std::vector< NodeType * >::const_iterator nIt=removed.begin(); nIt!=removed.end(); nIt++ )
+    {
+    if( *nIt != oldRoot )
+      {
+      delete *nIt;
+      }
+    }
+  std::vector< NodeType * >().swap( removed );
+
+  // create the nodes from the root, and reattach the detached subtrees.
+  // A detached subtree is alone at its level, so it is always canonical.
+  std::vector< NodeType * > nodes( numberOfVertices, NULL );
+  for( long i=numberOfVertices-1; i>=0; i-- )
+    {
+    const unsigned long p = order[i];
+    const unsigned long q = parent[p];
+    if( p == q || values[p] != values[q] )
+      {
+      NodeType * node = detached[p];
+      if( node == NULL )
+        {
+        node = new NodeType();
+        node->SetPixel( values[p] );
+        if( AccumulatorType::Active )
+          {
+          accumulator.Initialize( node );
+          }
+        }
+      if( p != q )
+        {
+        assert( nodes[q] != NULL );
+        nodes[q]->AddChild( node );
+        }
+      nodes[p] = node;
+      }
+    else
+      {
+      assert( detached[p] == NULL );
+      nodes[p] = nodes[q];
+      }
+    if( detached[p] == NULL )
+      {
+      tree->NodeAddIndex( nodes[p], offsets[p] );
+      m_NodeMap[ offsets[p] ] = nodes[p];
+      if( AccumulatorType::Active )
+        {
+        accumulator.AddPixel( nodes[p], offsets[p] );
+        }
+      }
+    }
+
+  if( AccumulatorType::Active )
+    {
+    // merge the attributes of the nodes in their parent, from the deepest
+    // ones. The detached subtrees already have a complete attribute.
+    for( unsigned long i=0; i<numberOfVertices; i++ )
+      {
+      const unsigned long p = order[i];
+      const unsigned long q = parent[p];
+      if( values[p] != values[q] )
+        {
+        accumulator.Merge( nodes[q], nodes[p] );
+        }
+      }
+    }
+
+  // splice the rebuilt subtrees in the kept nodes, and add their attribute
+  // to the one of the kept node and of all its ancestors
+  for( unsigned long s=0; s<splices.size(); s++ )
+    {
+    NodeType * node = nodes[ splices[s].first ];
+    if( splices[s].second != NULL )
+      {
+      if( AccumulatorType::Active )
+        {
+        for( NodeType * ancestor=splices[s].second; ancestor!=NULL; ancestor=ancestor->GetParent() )
+          {
+          accumulator.Merge( ancestor, node );
+          }
+        }
+      splices[s].second->AddChild( node );
+      }
+    else
+      {
+      // the whole tree has been rebuilt
+      assert( splices.size() == 1 );
+      node->SetParent( NULL );
+      tree->SetRoot( node );
+      }
+    }
+
+  // clear the marks for the next update
+  for( OffsetValueType v=0; v<numberOfPixelVertices; v++ )
+    {
+    m_VertexIds[ offsets[v] ] = -1;
+    }
+  for( typename std::vector< OffsetValueType >::const_iterator oIt=marked.begin(); oIt!=marked.end(); oIt++ )
+    {
+    m_VertexIds[ *oIt ] = -1;
+    }
+
+  tree->Modified();
+}
+
+
+template <class TImage, class TComponentTree, class TCompare, class TAccumulator>
+void
+ComponentTreeIncrementalUpdater<TImage, TComponentTree, TCompare, TAccumulator>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Image: "  << m_Image.GetPointer() << std::endl;
+  os << indent << "ComponentTree: "  << m_ComponentTree.GetPointer() << std::endl;
+  os << indent << "FullyConnected: "  << m_FullyConnected << std::endl;
+}
+
+}// end namespace itk
+#endif
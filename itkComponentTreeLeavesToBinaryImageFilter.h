@@ -17,8 +17,7 @@
 #ifndef __itkComponentTreeLeavesToBinaryImageFilter_h
 #define __itkComponentTreeLeavesToBinaryImageFilter_h
 
-#include "itkImageToImageFilter.h"
-#include "itkProgressReporter.h"
+#include "itkThreadedComponentTreeToImageFilter.h"
 
 namespace itk {
 
@@ -36,12 +35,12 @@ namespace itk {
  */
 template<class TInputImage, class TOutputImage>
 class ITK_EXPORT ComponentTreeLeavesToBinaryImageFilter : 
-    public ImageToImageFilter<TInputImage, TOutputImage>
+    public ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
 {
 public:
   /** Standard class typedefs. */
   typedef ComponentTreeLeavesToBinaryImageFilter Self;
-  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage> Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
 
@@ -69,7 +68,7 @@ public:
 
   /** Runtime information support. */
   itkTypeMacro(ComponentTreeLeavesToBinaryImageFilter, 
-               ImageToImageFilter);
+               ThreadedComponentTreeToImageFilter);
 
   itkSetMacro(ForegroundValue, OutputImagePixelType);
   itkGetConstMacro(ForegroundValue, OutputImagePixelType);
@@ -93,27 +92,21 @@ protected:
   ~ComponentTreeLeavesToBinaryImageFilter() {};
   void PrintSelf(std::ostream& os, Indent indent) const;
 
-  /** ComponentTreeLeavesToBinaryImageFilter needs the entire input be
-   * available. Thus, it needs to provide an implementation of
-   * GenerateInputRequestedRegion(). */
-  void GenerateInputRequestedRegion() ;
-
-  /** ComponentTreeLeavesToBinaryImageFilter will produce the entire output. */
-  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
-  
-  /** Single-threaded version of GenerateData.  This filter delegates
-   * to GrayscaleGeodesicErodeImageFilter. */
-    void GenerateData();
-
-  void WriteNodes( const NodeType* );
-  
+  /** Return the foreground value for the leaves, and the background
+   * value for the other nodes */
+  OutputImagePixelType GetNodeValue( const NodeType * node )
+    {
+    if( node->IsLeaf() )
+      {
+      return m_ForegroundValue;
+      }
+    return m_BackgroundValue;
+    }
 
 private:
   ComponentTreeLeavesToBinaryImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
-  ProgressReporter * m_Progress;
-
   OutputImagePixelType m_ForegroundValue;
   OutputImagePixelType m_BackgroundValue;
 
@@ -17,12 +17,7 @@
 #ifndef __itkComponentTreeLeavesToBinaryImageFilter_txx
 #define __itkComponentTreeLeavesToBinaryImageFilter_txx
 
-#include "itkImageRegionIterator.h"
-#include "itkImageRegionConstIterator.h"
 #include "itkComponentTreeLeavesToBinaryImageFilter.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
-#include <algorithm>
-#include <list>
 
 
 namespace itk {
@@ -35,89 +30,6 @@ ComponentTreeLeavesToBinaryImageFilter<TInputImage, TOutputImage>
   m_BackgroundValue = NumericTraits< OutputImagePixelType >::Zero;
 }
 
-template <class TInputImage, class TOutputImage>
-void 
-ComponentTreeLeavesToBinaryImageFilter<TInputImage, TOutputImage>
-::GenerateInputRequestedRegion()
-{
-  // call the superclass' implementation of this method
-  Superclass::GenerateInputRequestedRegion();
-  
-  // We need all the input.
-  InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
-  
-  if ( !input )
-    { return; }
-
-  input->SetRequestedRegion( input->GetLargestPossibleRegion() );
-}
-
-
-template <class TInputImage, class TOutputImage>
-void 
-ComponentTreeLeavesToBinaryImageFilter<TInputImage, TOutputImage>
-::EnlargeOutputRequestedRegion(DataObject *)
-{
-  this->GetOutput()
-    ->SetRequestedRegion( this->GetOutput()->GetLargestPossibleRegion() );
-}
-
-
-template<class TInputImage, class TOutputImage>
-void
-ComponentTreeLeavesToBinaryImageFilter<TInputImage, TOutputImage>
-::GenerateData()
-{
-  // Allocate the output
-  this->AllocateOutputs();
-  m_Progress = new ProgressReporter(this, 0, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels());
-  this->WriteNodes( this->GetInput()->GetRoot() );
-  delete m_Progress;
-  m_Progress = NULL;
-    
-  
-}
-
-
-template<class TInputImage, class TOutputImage>
-void
-ComponentTreeLeavesToBinaryImageFilter<TInputImage, TOutputImage>
-::WriteNodes( const NodeType* node )
-{
-  assert(node != NULL);
-
-  OutputImageType* output = this->GetOutput();
-
-  if( node->IsLeaf() )
-    {
-  for( typename NodeType::IndexType current=node->GetFirstIndex();
-       current != NodeType::EndIndex;
-       current = this->GetInput()->GetLinkedListArray()[ current ] )
-    {
-    // std::cout << *it << ": " << v << std::endl;
-    output->SetPixel( output->ComputeIndex( current ), m_ForegroundValue );
-    m_Progress->CompletedPixel();
-    }
-    }
-  else
-    {
-  for( typename NodeType::IndexType current=node->GetFirstIndex();
-       current != NodeType::EndIndex;
-       current = this->GetInput()->GetLinkedListArray()[ current ] )
-    {
-    // std::cout << *it << ": " << v << std::endl;
-    output->SetPixel( output->ComputeIndex( current ), m_BackgroundValue );
-    m_Progress->CompletedPixel();
-    }
-
-    const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
-    for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
-      {
-      this->WriteNodes( *it );
-      }
-    }
-}
-
 
 template<class TInputImage, class TOutputImage>
 void
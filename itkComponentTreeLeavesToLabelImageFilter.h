@@ -17,8 +17,7 @@
 #ifndef __itkComponentTreeLeavesToLabelImageFilter_h
 #define __itkComponentTreeLeavesToLabelImageFilter_h
 
-#include "itkImageToImageFilter.h"
-#include "itkProgressReporter.h"
+#include "itkThreadedComponentTreeToImageFilter.h"
 
 namespace itk {
 
@@ -35,12 +34,12 @@ namespace itk {
  */
 template<class TInputImage, class TOutputImage>
 class ITK_EXPORT ComponentTreeLeavesToLabelImageFilter : 
-    public ImageToImageFilter<TInputImage, TOutputImage>
+    public ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
 {
 public:
   /** Standard class typedefs. */
   typedef ComponentTreeLeavesToLabelImageFilter Self;
-  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage> Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
 
@@ -68,7 +67,7 @@ public:
 
   /** Runtime information support. */
   itkTypeMacro(ComponentTreeLeavesToLabelImageFilter, 
-               ImageToImageFilter);
+               ThreadedComponentTreeToImageFilter);
 
   itkSetMacro(BackgroundValue, OutputImagePixelType);
   itkGetConstMacro(BackgroundValue, OutputImagePixelType);
@@ -89,27 +88,24 @@ protected:
   ~ComponentTreeLeavesToLabelImageFilter() {};
   void PrintSelf(std::ostream& os, Indent indent) const;
 
-  /** ComponentTreeLeavesToLabelImageFilter needs the entire input be
-   * available. Thus, it needs to provide an implementation of
-   * GenerateInputRequestedRegion(). */
-  void GenerateInputRequestedRegion() ;
+  /** Start the labeling with the first label which is not the
+   * background value */
+  void CollectNodes( const NodeType * node );
 
-  /** ComponentTreeLeavesToLabelImageFilter will produce the entire output. */
-  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
-  
-  /** Single-threaded version of GenerateData.  This filter delegates
-   * to GrayscaleGeodesicErodeImageFilter. */
-  void GenerateData();
+  /** Give a label to each leaf, and return the label of the next leaf */
+  OutputImagePixelType LabelNodes( const NodeType*, const OutputImagePixelType & );
 
-  OutputImagePixelType WriteNodes( const NodeType*, const OutputImagePixelType & );
-  
+  /** Return the background value. The labels of the leaves are given by
+   * LabelNodes(). */
+  OutputImagePixelType GetNodeValue( const NodeType * itkNotUsed(node) )
+    {
+    return m_BackgroundValue;
+    }
 
 private:
   ComponentTreeLeavesToLabelImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
-  ProgressReporter * m_Progress;
-
   OutputImagePixelType m_BackgroundValue;
 
 } ; // end of class
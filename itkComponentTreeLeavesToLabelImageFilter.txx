@@ -17,12 +17,7 @@
 #ifndef __itkComponentTreeLeavesToLabelImageFilter_txx
 #define __itkComponentTreeLeavesToLabelImageFilter_txx
 
-#include "itkImageRegionIterator.h"
-#include "itkImageRegionConstIterator.h"
 #include "itkComponentTreeLeavesToLabelImageFilter.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
-#include <algorithm>
-#include <list>
 
 
 namespace itk {
@@ -34,77 +29,33 @@ ComponentTreeLeavesToLabelImageFilter<TInputImage, TOutputImage>
   m_BackgroundValue = NumericTraits< OutputImagePixelType >::Zero;
 }
 
-template <class TInputImage, class TOutputImage>
-void 
-ComponentTreeLeavesToLabelImageFilter<TInputImage, TOutputImage>
-::GenerateInputRequestedRegion()
-{
-  // call the superclass' implementation of this method
-  Superclass::GenerateInputRequestedRegion();
-  
-  // We need all the input.
-  InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
-  
-  if ( !input )
-    { return; }
-
-  input->SetRequestedRegion( input->GetLargestPossibleRegion() );
-}
-
-
-template <class TInputImage, class TOutputImage>
-void 
-ComponentTreeLeavesToLabelImageFilter<TInputImage, TOutputImage>
-::EnlargeOutputRequestedRegion(DataObject *)
-{
-  this->GetOutput()
-    ->SetRequestedRegion( this->GetOutput()->GetLargestPossibleRegion() );
-}
-
-
 template<class TInputImage, class TOutputImage>
 void
 ComponentTreeLeavesToLabelImageFilter<TInputImage, TOutputImage>
-::GenerateData()
+::CollectNodes( const NodeType * node )
 {
-  // Allocate the output
-  this->AllocateOutputs();
-  m_Progress = new ProgressReporter(this, 0, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels());
-
   OutputImagePixelType firstLabel = NumericTraits< OutputImagePixelType >::Zero;
   if( firstLabel == m_BackgroundValue )
     {
     firstLabel++;
     }
 
-  this->WriteNodes( this->GetInput()->GetRoot(), firstLabel );
-
-  delete m_Progress;
-  m_Progress = NULL;
-  
+  this->LabelNodes( node, firstLabel );
 }
 
 
 template<class TInputImage, class TOutputImage>
 typename ComponentTreeLeavesToLabelImageFilter<TInputImage, TOutputImage>::OutputImagePixelType
 ComponentTreeLeavesToLabelImageFilter<TInputImage, TOutputImage>
-::WriteNodes( const NodeType* node, const OutputImagePixelType & label )
+::LabelNodes( const NodeType* node, const OutputImagePixelType & label )
 {
   assert(node != NULL);
 
-  OutputImageType* output = this->GetOutput();
   OutputImagePixelType nextLabel = label;
 
   if( node->IsLeaf() )
     {
-    for( typename NodeType::IndexType current=node->GetFirstIndex();
-        current != NodeType::EndIndex;
-        current = this->GetInput()->GetLinkedListArray()[ current ] )
-      {
-      // std::cout << *it << ": " << v << std::endl;
-      output->SetPixel( output->ComputeIndex( current ), label );
-      m_Progress->CompletedPixel();
-      }
+    this->AddNode( node, label );
 
     nextLabel++;
     if( nextLabel == m_BackgroundValue )
@@ -115,19 +66,12 @@ ComponentTreeLeavesToLabelImageFilter<TInputImage, TOutputImage>
     }
   else
     {
-    for( typename NodeType::IndexType current=node->GetFirstIndex();
-        current != NodeType::EndIndex;
-        current = this->GetInput()->GetLinkedListArray()[ current ] )
-      {
-      // std::cout << *it << ": " << v << std::endl;
-      output->SetPixel( output->ComputeIndex( current ), m_BackgroundValue );
-      m_Progress->CompletedPixel();
-      }
+    this->AddNode( node, m_BackgroundValue );
 
     const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
     for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
       {
-      nextLabel = this->WriteNodes( *it, nextLabel );
+      nextLabel = this->LabelNodes( *it, nextLabel );
       }
     }
 
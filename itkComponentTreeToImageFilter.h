@@ -17,8 +17,7 @@
 #ifndef __itkComponentTreeToImageFilter_h
 #define __itkComponentTreeToImageFilter_h
 
-#include "itkImageToImageFilter.h"
-#include "itkProgressReporter.h"
+#include "itkThreadedComponentTreeToImageFilter.h"
 
 namespace itk {
 
@@ -35,12 +34,12 @@ namespace itk {
  */
 template<class TInputImage, class TOutputImage>
 class ITK_EXPORT ComponentTreeToImageFilter : 
-    public ImageToImageFilter<TInputImage, TOutputImage>
+    public ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
 {
 public:
   /** Standard class typedefs. */
   typedef ComponentTreeToImageFilter Self;
-  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage> Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
 
@@ -68,7 +67,7 @@ public:
 
   /** Runtime information support. */
   itkTypeMacro(ComponentTreeToImageFilter, 
-               ImageToImageFilter);
+               ThreadedComponentTreeToImageFilter);
 
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
@@ -86,27 +85,16 @@ protected:
   ~ComponentTreeToImageFilter() {};
   void PrintSelf(std::ostream& os, Indent indent) const;
 
-  /** ComponentTreeToImageFilter needs the entire input be
-   * available. Thus, it needs to provide an implementation of
-   * GenerateInputRequestedRegion(). */
-  void GenerateInputRequestedRegion() ;
-
-  /** ComponentTreeToImageFilter will produce the entire output. */
-  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
-  
-  /** Single-threaded version of GenerateData.  This filter delegates
-   * to GrayscaleGeodesicErodeImageFilter. */
-    void GenerateData();
-
-  void WriteNodes( const NodeType* );
-  
+  /** Return the pixel value of the node */
+  OutputImagePixelType GetNodeValue( const NodeType * node )
+    {
+    return static_cast<OutputImagePixelType>( node->GetPixel() );
+    }
 
 private:
   ComponentTreeToImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
-  ProgressReporter * m_Progress;
-
 } ; // end of class
 
 } // end namespace itk
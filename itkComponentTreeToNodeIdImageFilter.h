@@ -0,0 +1,118 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeToNodeIdImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeToNodeIdImageFilter_h
+#define __itkComponentTreeToNodeIdImageFilter_h
+
+#include "itkThreadedComponentTreeToImageFilter.h"
+#include "itkImage.h"
+#include <vector>
+
+namespace itk {
+
+/** \class ComponentTreeToNodeIdImageFilter
+ * \brief Produce an image of the id of the node of each pixel of an itk::ComponentTree
+ *
+ * The nodes are numbered in the depth first order of the tree, starting
+ * with 0 for the root, and the pixel value of the output image is the id of
+ * the node which contains the pixel. GetNodeTable() gives the node of each
+ * id. With a 32 bits output pixel type, this index from the pixels to the
+ * nodes uses half the memory of an image of node pointers on a 64 bits
+ * system.
+ *
+ * An exception is thrown if the tree has more nodes than the output pixel
+ * type can number. The node table is only valid as long as the tree is not
+ * modified or destroyed.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ComponentTreeImageAdaptor
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TInputImage, class TOutputImage=Image< unsigned int, TInputImage::ImageDimension > >
+class ITK_EXPORT ComponentTreeToNodeIdImageFilter : 
+    public ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ComponentTreeToNodeIdImageFilter Self;
+  typedef ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename InputImageType::Pointer         InputImagePointer;
+  typedef typename InputImageType::ConstPointer    InputImageConstPointer;
+  typedef typename InputImageType::RegionType      InputImageRegionType;
+  typedef typename InputImageType::PixelType       InputImagePixelType;
+  typedef typename OutputImageType::Pointer        OutputImagePointer;
+  typedef typename OutputImageType::ConstPointer   OutputImageConstPointer;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+  typedef typename InputImageType::NodeType        NodeType;
+  typedef typename InputImageType::AttributeType   AttributeType;
+  typedef typename OutputImageType::IndexType      IndexType;
+  typedef std::vector< const NodeType * >          NodeTableType;
+  
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(ComponentTreeToNodeIdImageFilter, 
+               ThreadedComponentTreeToImageFilter);
+
+  /** Return the node of each id, computed by the last update. The table can
+   * be swapped with another one to take it without copy. */
+  NodeTableType & GetNodeTable()
+    {
+    return m_NodeTable;
+    }
+
+protected:
+  ComponentTreeToNodeIdImageFilter();
+  ~ComponentTreeToNodeIdImageFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Number the nodes before writing them */
+  void GenerateData();
+
+  /** Give the next id to the node. The nodes are visited once by
+   * CollectNodes(), in depth first order. */
+  OutputImagePixelType GetNodeValue( const NodeType * node );
+
+private:
+  ComponentTreeToNodeIdImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  NodeTableType m_NodeTable;
+
+} ; // end of class
+
+} // end namespace itk
+  
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkComponentTreeToNodeIdImageFilter.txx"
+#endif
+
+#endif
+
+
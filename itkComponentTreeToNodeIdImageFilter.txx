@@ -0,0 +1,68 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeToNodeIdImageFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeToNodeIdImageFilter_txx
+#define __itkComponentTreeToNodeIdImageFilter_txx
+
+#include "itkComponentTreeToNodeIdImageFilter.h"
+#include "itkNumericTraits.h"
+
+
+namespace itk {
+
+template <class TInputImage, class TOutputImage>
+ComponentTreeToNodeIdImageFilter<TInputImage, TOutputImage>
+::ComponentTreeToNodeIdImageFilter()
+{
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+ComponentTreeToNodeIdImageFilter<TInputImage, TOutputImage>
+::GenerateData()
+{
+  m_NodeTable.clear();
+  Superclass::GenerateData();
+}
+
+
+template<class TInputImage, class TOutputImage>
+typename ComponentTreeToNodeIdImageFilter<TInputImage, TOutputImage>::OutputImagePixelType
+ComponentTreeToNodeIdImageFilter<TInputImage, TOutputImage>
+::GetNodeValue( const NodeType * node )
+{
+  if( m_NodeTable.size() > static_cast< unsigned long >( NumericTraits< OutputImagePixelType >::max() ) )
+    {
+    itkExceptionMacro( << "Too many nodes for the output pixel type." );
+    }
+  m_NodeTable.push_back( node );
+  return static_cast< OutputImagePixelType >( m_NodeTable.size() - 1 );
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+ComponentTreeToNodeIdImageFilter<TInputImage, TOutputImage>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NodeTable size: "  << m_NodeTable.size() << std::endl;
+}
+  
+}// end namespace itk
+#endif
@@ -0,0 +1,231 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeToPatternSpectrum2DFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeToPatternSpectrum2DFilter_h
+#define __itkComponentTreeToPatternSpectrum2DFilter_h
+
+#include "itkProcessObject.h"
+#include "itkHistogram.h"
+#include "itkFixedArray.h"
+#include "itkMultiThreader.h"
+#include "itkComponentTreeNode.h"
+#include "vcl_cmath.h"
+#include <vector>
+#include <algorithm>
+
+namespace itk {
+
+/** \class ComponentTreeToPatternSpectrum2DFilter
+ * \brief Compute a 2D size-shape pattern spectrum from a component tree
+ *
+ * This filter computes the same volume contributions than
+ * ComponentTreeToPatternSpectrumFilter - the subtree area of a node
+ * multiplied by the difference between its level and the level of its
+ * parent - but accumulates them in a 2D grid indexed by a size attribute
+ * and a shape attribute, for example the number of pixels and the
+ * compactness. All the shape classes are computed at once, without running
+ * a granulometry per class.
+ *
+ * The tree is traversed once to collect the contributions. They are then
+ * binned by several threads, each one in its own grid, and the grids are
+ * summed at the end.
+ *
+ * The first dimension of the output histogram is the size, and the second
+ * one is the shape. For each dimension, the bins can be spread uniformly or
+ * logarithmically over the range of the attribute in the tree, or over
+ * [BinMinimum, BinMaximum] if AutoMinimumMaximum is off. With the log
+ * binning, the lower bound is the smallest positive value of the attribute,
+ * and the smaller values are counted in the first bin. With a user provided
+ * range, the nodes out of the range are ignored.
+ *
+ * The histogram frequencies are integers: the volume of each bin is rounded
+ * to the nearest integer. The exact volumes are available with
+ * GetSpectrum().
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ComponentTreeToPatternSpectrumFilter, CompactnessComponentTreeFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+class ITK_EXPORT ComponentTreeToPatternSpectrum2DFilter :
+    public ProcessObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef ComponentTreeToPatternSpectrum2DFilter Self;
+  typedef ProcessObject             Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TImage ImageType;
+  typedef typename ImageType::Pointer         ImagePointer;
+  typedef typename ImageType::ConstPointer    ImageConstPointer;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::NodeType        NodeType;
+  typedef typename ImageType::IndexType       IndexType;
+
+  typedef TSizeAccessor SizeAccessorType;
+  typedef TShapeAccessor ShapeAccessorType;
+
+  typedef typename NumericTraits<PixelType>::RealType RealPixelType;
+
+  typedef Statistics::Histogram< double > HistogramType;
+  typedef typename HistogramType::Pointer HistogramPointer;
+
+  /** The exact volume of each bin, with the size bin varying the fastest */
+  typedef std::vector< double > SpectrumType;
+
+  typedef FixedArray< unsigned int, 2 > NumberOfBinsType;
+  typedef FixedArray< double, 2 > BinBoundType;
+  typedef FixedArray< bool, 2 > LogBinningType;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ComponentTreeToPatternSpectrum2DFilter,
+               ProcessObject);
+
+  /** Set/Get the input tree */
+  void SetInput( const ImageType * input );
+  const ImageType * GetInput() const;
+
+  /** Get the 2D pattern spectrum */
+  const HistogramType * GetOutput() const;
+  HistogramType * GetOutput();
+
+  /** Set/Get the number of bins for the size and for the shape */
+  itkSetMacro(NumberOfBins, NumberOfBinsType);
+  itkGetConstReferenceMacro(NumberOfBins, NumberOfBinsType);
+
+  /** Set/Get whether the bins of a dimension are spread logarithmically.
+   * Defaults to true for the size, and false for the shape. */
+  itkSetMacro(LogBinning, LogBinningType);
+  itkGetConstReferenceMacro(LogBinning, LogBinningType);
+
+  /** Set/Get whether the range of the bins is the range of the attributes
+   * in the tree (the default), or is given by BinMinimum and BinMaximum */
+  itkSetMacro(AutoMinimumMaximum, bool);
+  itkGetConstReferenceMacro(AutoMinimumMaximum, bool);
+  itkBooleanMacro(AutoMinimumMaximum);
+
+  itkSetMacro(BinMinimum, BinBoundType);
+  itkGetConstReferenceMacro(BinMinimum, BinBoundType);
+
+  itkSetMacro(BinMaximum, BinBoundType);
+  itkGetConstReferenceMacro(BinMaximum, BinBoundType);
+
+  /** Set/Get the number of threads used to bin the contributions */
+  itkSetClampMacro(NumberOfThreads, int, 1, ITK_MAX_THREADS);
+  itkGetConstReferenceMacro(NumberOfThreads, int);
+
+  /** Get the total volume in the spectrum */
+  itkGetConstMacro(TotalVolume, double);
+
+  /** Get the volume of each bin of the pattern spectrum, without the
+   * rounding of the output histogram */
+  itkGetConstReferenceMacro(Spectrum, SpectrumType);
+
+protected:
+  ComponentTreeToPatternSpectrum2DFilter();
+  ~ComponentTreeToPatternSpectrum2DFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  DataObject::Pointer MakeOutput(unsigned int idx);
+
+  void GenerateData();
+
+  /** Store the size, the shape and the volume of the nodes of the subtree,
+   * and return the number of pixels in the subtree */
+  unsigned long ComputeContributions( const NodeType * node );
+
+  /** Bin the contributions of a part of the nodes in the grid of the
+   * thread */
+  void ThreadedComputeSpectrum( int threadId, int numberOfThreads );
+
+  static ITK_THREAD_RETURN_TYPE ComputeSpectrumThreaderCallback( void * arg );
+
+  /** Compute the bin of a value in a dimension, or return false if the value
+   * is out of the range */
+  inline bool ComputeBin( unsigned int d, double value, unsigned int & bin ) const
+    {
+    double pos;
+    if( m_LogBinning[d] )
+      {
+      if( value <= m_Lower[d] )
+        {
+        bin = 0;
+        return m_AutoMinimumMaximum || value == m_Lower[d];
+        }
+      pos = vcl_log( value / m_Lower[d] ) * m_Scale[d];
+      }
+    else
+      {
+      pos = ( value - m_Lower[d] ) * m_Scale[d];
+      }
+    if( pos < 0 || pos > m_NumberOfBins[d] )
+      {
+      if( !m_AutoMinimumMaximum )
+        {
+        bin = 0;
+        return false;
+        }
+      // rounding error on the bounds of the range
+      pos = std::max( 0.0, std::min( pos, static_cast< double >( m_NumberOfBins[d] ) ) );
+      }
+    bin = std::min( static_cast< unsigned int >( pos ), m_NumberOfBins[d] - 1 );
+    return true;
+    }
+
+private:
+  ComponentTreeToPatternSpectrum2DFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  typedef std::vector< double > ValuesType;
+
+  NumberOfBinsType m_NumberOfBins;
+  LogBinningType m_LogBinning;
+  bool m_AutoMinimumMaximum;
+  BinBoundType m_BinMinimum;
+  BinBoundType m_BinMaximum;
+  int m_NumberOfThreads;
+  double m_TotalVolume;
+  SpectrumType m_Spectrum;
+
+  // the size, the shape and the volume, packed node by node
+  ValuesType m_Contributions;
+
+  // the bounds actually used, and the factor to go from a value to a bin
+  BinBoundType m_Lower;
+  BinBoundType m_Upper;
+  BinBoundType m_Scale;
+
+  // the partial spectra of the threads
+  std::vector< ValuesType > m_ThreadSpectra;
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkComponentTreeToPatternSpectrum2DFilter.txx"
+#endif
+
+#endif
+
+
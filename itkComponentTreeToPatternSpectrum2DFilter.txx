@@ -0,0 +1,332 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeToPatternSpectrum2DFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeToPatternSpectrum2DFilter_txx
+#define __itkComponentTreeToPatternSpectrum2DFilter_txx
+
+#include "itkComponentTreeToPatternSpectrum2DFilter.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+
+
+namespace itk {
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::ComponentTreeToPatternSpectrum2DFilter()
+{
+  m_NumberOfBins.Fill( 32 );
+  m_LogBinning[0] = true;
+  m_LogBinning[1] = false;
+  m_AutoMinimumMaximum = true;
+  m_BinMinimum.Fill( 0 );
+  m_BinMaximum.Fill( 0 );
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_TotalVolume = 0;
+  m_Lower.Fill( 0 );
+  m_Upper.Fill( 0 );
+  m_Scale.Fill( 0 );
+
+  this->SetNumberOfRequiredInputs(1);
+  this->SetNumberOfRequiredOutputs(1);
+  this->ProcessObject::SetNthOutput( 0, this->MakeOutput(0) );
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+void
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::SetInput( const ImageType * input )
+{
+  this->ProcessObject::SetNthInput( 0, const_cast< ImageType * >( input ) );
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+const typename ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>::ImageType *
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::GetInput() const
+{
+  if ( this->GetNumberOfInputs() < 1 )
+    {
+    return 0;
+    }
+  return static_cast< const ImageType * >( this->ProcessObject::GetInput(0) );
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+DataObject::Pointer
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::MakeOutput( unsigned int itkNotUsed(idx) )
+{
+  HistogramPointer output = HistogramType::New();
+  return static_cast< DataObject * >( output );
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+const typename ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>::HistogramType *
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::GetOutput() const
+{
+  return static_cast< const HistogramType * >( this->ProcessObject::GetOutput(0) );
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+typename ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>::HistogramType *
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::GetOutput()
+{
+  return static_cast< HistogramType * >( this->ProcessObject::GetOutput(0) );
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+void
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::GenerateData()
+{
+  ProgressReporter progress(this, 0, 3);
+
+  for( unsigned int d=0; d<2; d++ )
+    {
+    if( m_NumberOfBins[d] == 0 )
+      {
+      itkExceptionMacro( << "The number of bins must be greater than 0." );
+      }
+    if( !m_AutoMinimumMaximum && m_LogBinning[d] && m_BinMinimum[d] <= 0 )
+      {
+      itkExceptionMacro( << "BinMinimum must be positive with the log binning." );
+      }
+    }
+
+  // collect the contributions in a single traversal of the tree
+  m_Contributions.clear();
+  this->ComputeContributions( this->GetInput()->GetRoot() );
+  const unsigned long nbOfContributions = m_Contributions.size() / 3;
+  progress.CompletedPixel();
+
+  // the range of the bins
+  for( unsigned int d=0; d<2; d++ )
+    {
+    if( m_AutoMinimumMaximum )
+      {
+      double minimum = NumericTraits< double >::max();
+      double maximum = NumericTraits< double >::NonpositiveMin();
+      for( unsigned long i=0; i<nbOfContributions; i++ )
+        {
+        const double v = m_Contributions[ i * 3 + d ];
+        if( !m_LogBinning[d] || v > 0 )
+          {
+          minimum = std::min( minimum, v );
+          }
+        maximum = std::max( maximum, v );
+        }
+      if( minimum > maximum )
+        {
+        // no node, or no positive value for the log binning
+        minimum = maximum = m_LogBinning[d] ? 1.0 : 0.0;
+        }
+      m_Lower[d] = minimum;
+      m_Upper[d] = maximum;
+      }
+    else
+      {
+      m_Lower[d] = m_BinMinimum[d];
+      m_Upper[d] = m_BinMaximum[d];
+      }
+
+    m_Scale[d] = 0;
+    if( m_Upper[d] > m_Lower[d] )
+      {
+      if( m_LogBinning[d] )
+        {
+        m_Scale[d] = m_NumberOfBins[d] / vcl_log( m_Upper[d] / m_Lower[d] );
+        }
+      else
+        {
+        m_Scale[d] = m_NumberOfBins[d] / ( m_Upper[d] - m_Lower[d] );
+        }
+      }
+    }
+
+  // don't use more threads than contributions
+  int numberOfThreads = m_NumberOfThreads;
+  if( static_cast< unsigned long >( numberOfThreads ) > nbOfContributions )
+    {
+    numberOfThreads = std::max( 1, static_cast< int >( nbOfContributions ) );
+    }
+
+  const unsigned long nbOfBins = m_NumberOfBins[0] * m_NumberOfBins[1];
+  m_ThreadSpectra.assign( numberOfThreads, ValuesType( nbOfBins, 0.0 ) );
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( numberOfThreads );
+  threader->SetSingleMethod( this->ComputeSpectrumThreaderCallback, this );
+  threader->SingleMethodExecute();
+  progress.CompletedPixel();
+
+  // merge the partial spectra in the output histogram
+  HistogramType * histogram = this->GetOutput();
+  typename HistogramType::SizeType size;
+  size.SetSize( 2 );
+  size[0] = m_NumberOfBins[0];
+  size[1] = m_NumberOfBins[1];
+  typename HistogramType::MeasurementVectorType lower;
+  lower.SetSize( 2 );
+  typename HistogramType::MeasurementVectorType upper;
+  upper.SetSize( 2 );
+  for( unsigned int d=0; d<2; d++ )
+    {
+    lower[d] = m_Lower[d];
+    upper[d] = m_Upper[d];
+    }
+  histogram->SetMeasurementVectorSize( 2 );
+  histogram->SetClipBinsAtEnds( false );
+  histogram->Initialize( size, lower, upper );
+  for( unsigned int d=0; d<2; d++ )
+    {
+    if( m_LogBinning[d] )
+      {
+      // replace the uniform bounds by the geometric ones
+      const double ratio = m_Upper[d] / m_Lower[d];
+      for( unsigned int b=0; b<m_NumberOfBins[d]; b++ )
+        {
+        histogram->SetBinMin( d, b, m_Lower[d] * vcl_pow( ratio, static_cast< double >( b ) / m_NumberOfBins[d] ) );
+        histogram->SetBinMax( d, b, m_Lower[d] * vcl_pow( ratio, static_cast< double >( b + 1 ) / m_NumberOfBins[d] ) );
+        }
+      }
+    }
+
+  m_TotalVolume = 0;
+  m_Spectrum.assign( nbOfBins, 0.0 );
+  typename HistogramType::IndexType index;
+  index.SetSize( 2 );
+  for( unsigned int b1=0; b1<m_NumberOfBins[1]; b1++ )
+    {
+    for( unsigned int b0=0; b0<m_NumberOfBins[0]; b0++ )
+      {
+      double volume = 0;
+      for( int t=0; t<numberOfThreads; t++ )
+        {
+        volume += m_ThreadSpectra[t][ b0 + b1 * m_NumberOfBins[0] ];
+        }
+      m_TotalVolume += volume;
+      m_Spectrum[ b0 + b1 * m_NumberOfBins[0] ] = volume;
+      index[0] = b0;
+      index[1] = b1;
+      histogram->SetFrequency( histogram->GetInstanceIdentifier( index ),
+        static_cast< typename HistogramType::AbsoluteFrequencyType >( volume + 0.5 ) );
+      }
+    }
+  progress.CompletedPixel();
+
+  // release the temporary data
+  m_Contributions.clear();
+  m_ThreadSpectra.clear();
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+unsigned long
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::ComputeContributions( const NodeType * node )
+{
+  assert(node != NULL);
+  SizeAccessorType sizeAccessor;
+  ShapeAccessorType shapeAccessor;
+
+  unsigned long area = this->GetInput()->NodeCountOwnIndexes( node );
+
+  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+    {
+    area += this->ComputeContributions( *it );
+    }
+
+  if( !node->IsRoot() )
+    {
+    RealPixelType diff = static_cast< RealPixelType >( node->GetPixel() )
+                         - static_cast< RealPixelType >( node->GetParent()->GetPixel() );
+    if( diff < 0 )
+      {
+      // min tree
+      diff = -diff;
+      }
+    m_Contributions.push_back( static_cast< double >( sizeAccessor( node ) ) );
+    m_Contributions.push_back( static_cast< double >( shapeAccessor( node ) ) );
+    m_Contributions.push_back( static_cast< double >( diff ) * area );
+    }
+
+  return area;
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+void
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::ThreadedComputeSpectrum( int threadId, int numberOfThreads )
+{
+  const unsigned long nbOfContributions = m_Contributions.size() / 3;
+  const unsigned long begin = nbOfContributions * threadId / numberOfThreads;
+  const unsigned long end = nbOfContributions * ( threadId + 1 ) / numberOfThreads;
+
+  ValuesType & spectrum = m_ThreadSpectra[ threadId ];
+
+  unsigned int bin0;
+  unsigned int bin1;
+  for( unsigned long n=begin; n<end; n++ )
+    {
+    const double * c = & m_Contributions[ n * 3 ];
+    if( this->ComputeBin( 0, c[0], bin0 ) && this->ComputeBin( 1, c[1], bin1 ) )
+      {
+      spectrum[ bin0 + bin1 * m_NumberOfBins[0] ] += c[2];
+      }
+    }
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+ITK_THREAD_RETURN_TYPE
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::ComputeSpectrumThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self * filter = static_cast< Self * >( info->UserData );
+  filter->ThreadedComputeSpectrum( info->ThreadID, info->NumberOfThreads );
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+template<class TImage, class TSizeAccessor, class TShapeAccessor>
+void
+ComponentTreeToPatternSpectrum2DFilter<TImage, TSizeAccessor, TShapeAccessor>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfBins: " << m_NumberOfBins << std::endl;
+  os << indent << "LogBinning: " << m_LogBinning << std::endl;
+  os << indent << "AutoMinimumMaximum: " << m_AutoMinimumMaximum << std::endl;
+  os << indent << "BinMinimum: " << m_BinMinimum << std::endl;
+  os << indent << "BinMaximum: " << m_BinMaximum << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "TotalVolume: " << m_TotalVolume << std::endl;
+}
+
+}// end namespace itk
+#endif
@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeToPatternSpectrumFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeToPatternSpectrumFilter_h
+#define __itkComponentTreeToPatternSpectrumFilter_h
+
+#include "itkProcessObject.h"
+#include "itkHistogram.h"
+#include "itkComponentTreeNode.h"
+#include <vector>
+
+namespace itk {
+
+/** \class ComponentTreeToPatternSpectrumFilter
+ * \brief Compute the pattern spectrum of an image from its component tree
+ *
+ * The pattern spectrum gives, for each value of the attribute, the volume
+ * (sum of the pixel values) removed by an attribute opening when the
+ * threshold goes over that value. It is the derivative of the granulometry
+ * curve, which is obtained with a cumulative sum of the histogram.
+ *
+ * A node removed by the opening brings the pixels of its subtree down to
+ * the level of its parent, so its contribution to the spectrum is its
+ * subtree area multiplied by the difference between its level and the
+ * level of its parent. The contributions are computed in a single post
+ * order traversal, without modifying the tree, and accumulated in the
+ * bin of the attribute of the node. The root is never removed and has no
+ * contribution.
+ *
+ * The attribute is expected to be increasing. For a non increasing
+ * attribute, the contributions are those of the DIRECT filtering rule.
+ *
+ * The output is a 1D histogram with NumberOfBins bins spread uniformly over
+ * the range of the attribute, or over [BinMinimum, BinMaximum] if
+ * AutoMinimumMaximum is off. The histogram frequencies are integers: the
+ * volume of each bin is rounded to the nearest integer. The volumes are
+ * not integers with a real pixel type, so the exact volume of each bin is
+ * also available with GetSpectrum().
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa GranulometryComponentTreeFilter, ComponentTreeToHistogramFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TImage, class TAttibuteAccessor=typename Functor::AttributeComponentTreeNodeAccessor< typename TImage::NodeType > >
+class ITK_EXPORT ComponentTreeToPatternSpectrumFilter :
+    public ProcessObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef ComponentTreeToPatternSpectrumFilter Self;
+  typedef ProcessObject             Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TImage ImageType;
+  typedef typename ImageType::Pointer         ImagePointer;
+  typedef typename ImageType::ConstPointer    ImageConstPointer;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::NodeType        NodeType;
+  typedef typename ImageType::IndexType       IndexType;
+
+  typedef TAttibuteAccessor AttributeAccessorType;
+  typedef typename AttributeAccessorType::AttributeType   AttributeType;
+
+  typedef typename NumericTraits<PixelType>::RealType RealPixelType;
+
+  typedef Statistics::Histogram< double > HistogramType;
+  typedef typename HistogramType::Pointer HistogramPointer;
+
+  /** The exact volume of each bin */
+  typedef std::vector< double > SpectrumType;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ComponentTreeToPatternSpectrumFilter,
+               ProcessObject);
+
+  /** Set/Get the input tree */
+  void SetInput( const ImageType * input );
+  const ImageType * GetInput() const;
+
+  /** Get the pattern spectrum */
+  const HistogramType * GetOutput() const;
+  HistogramType * GetOutput();
+
+  /** Set/Get the number of bins of the pattern spectrum */
+  itkSetMacro(NumberOfBins, unsigned int);
+  itkGetConstReferenceMacro(NumberOfBins, unsigned int);
+
+  /** Set/Get whether the range of the bins is the range of the attribute
+   * in the tree (the default), or is given by BinMinimum and BinMaximum */
+  itkSetMacro(AutoMinimumMaximum, bool);
+  itkGetConstReferenceMacro(AutoMinimumMaximum, bool);
+  itkBooleanMacro(AutoMinimumMaximum);
+
+  itkSetMacro(BinMinimum, double);
+  itkGetConstReferenceMacro(BinMinimum, double);
+
+  itkSetMacro(BinMaximum, double);
+  itkGetConstReferenceMacro(BinMaximum, double);
+
+  /** Get the total volume in the spectrum */
+  itkGetConstMacro(TotalVolume, double);
+
+  /** Get the volume of each bin of the pattern spectrum, without the
+   * rounding of the output histogram */
+  itkGetConstReferenceMacro(Spectrum, SpectrumType);
+
+protected:
+  ComponentTreeToPatternSpectrumFilter();
+  ~ComponentTreeToPatternSpectrumFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  DataObject::Pointer MakeOutput(unsigned int idx);
+
+  void GenerateData();
+
+  /** Store the attribute and the volume of the nodes of the subtree, and
+   * return the number of pixels in the subtree */
+  unsigned long ComputeContributions( const NodeType * node );
+
+private:
+  ComponentTreeToPatternSpectrumFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  unsigned int m_NumberOfBins;
+  bool m_AutoMinimumMaximum;
+  double m_BinMinimum;
+  double m_BinMaximum;
+  double m_TotalVolume;
+  SpectrumType m_Spectrum;
+
+  // the attribute and the volume of the nodes
+  std::vector< double > m_Attributes;
+  std::vector< double > m_Volumes;
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkComponentTreeToPatternSpectrumFilter.txx"
+#endif
+
+#endif
+
+
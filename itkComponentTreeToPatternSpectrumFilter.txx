@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkComponentTreeToPatternSpectrumFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkComponentTreeToPatternSpectrumFilter_txx
+#define __itkComponentTreeToPatternSpectrumFilter_txx
+
+#include "itkComponentTreeToPatternSpectrumFilter.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+
+
+namespace itk {
+
+template<class TImage, class TAttributeAccessor>
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::ComponentTreeToPatternSpectrumFilter()
+{
+  m_NumberOfBins = 128;
+  m_AutoMinimumMaximum = true;
+  m_BinMinimum = 0;
+  m_BinMaximum = 0;
+  m_TotalVolume = 0;
+
+  this->SetNumberOfRequiredInputs(1);
+  this->SetNumberOfRequiredOutputs(1);
+  this->ProcessObject::SetNthOutput( 0, this->MakeOutput(0) );
+}
+
+
+template<class TImage, class TAttributeAccessor>
+void
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::SetInput( const ImageType * input )
+{
+  this->ProcessObject::SetNthInput( 0, const_cast< ImageType * >( input ) );
+}
+
+
+template<class TImage, class TAttributeAccessor>
+const typename ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>::ImageType *
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::GetInput() const
+{
+  if ( this->GetNumberOfInputs() < 1 )
+    {
+    return 0;
+    }
+  return static_cast< const ImageType * >( this->ProcessObject::GetInput(0) );
+}
+
+
+template<class TImage, class TAttributeAccessor>
+DataObject::Pointer
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::MakeOutput( unsigned int itkNotUsed(idx) )
+{
+  HistogramPointer output = HistogramType::New();
+  return static_cast< DataObject * >( output );
+}
+
+
+template<class TImage, class TAttributeAccessor>
+const typename ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>::HistogramType *
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::GetOutput() const
+{
+  return static_cast< const HistogramType * >( this->ProcessObject::GetOutput(0) );
+}
+
+
+template<class TImage, class TAttributeAccessor>
+typename ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>::HistogramType *
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::GetOutput()
+{
+  return static_cast< HistogramType * >( this->ProcessObject::GetOutput(0) );
+}
+
+
+template<class TImage, class TAttributeAccessor>
+void
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::GenerateData()
+{
+  ProgressReporter progress(this, 0, 2);
+
+  m_Attributes.clear();
+  m_Volumes.clear();
+  this->ComputeContributions( this->GetInput()->GetRoot() );
+  progress.CompletedPixel();
+
+  double minimum = m_BinMinimum;
+  double maximum = m_BinMaximum;
+  if( m_AutoMinimumMaximum )
+    {
+    minimum = 0;
+    maximum = 0;
+    if( !m_Attributes.empty() )
+      {
+      minimum = *std::min_element( m_Attributes.begin(), m_Attributes.end() );
+      maximum = *std::max_element( m_Attributes.begin(), m_Attributes.end() );
+      }
+    }
+
+  // accumulate in double to not lose the fractional volumes. They are kept
+  // in m_Spectrum, and rounded only in the output histogram
+  m_Spectrum.assign( m_NumberOfBins, 0.0 );
+  const double range = maximum - minimum;
+  m_TotalVolume = 0;
+  for( unsigned long i=0; i<m_Attributes.size(); i++ )
+    {
+    unsigned int bin = 0;
+    if( range > 0 )
+      {
+      const double pos = ( m_Attributes[i] - minimum ) / range * m_NumberOfBins;
+      if( pos < 0 || pos > m_NumberOfBins )
+        {
+        // out of the user provided range
+        continue;
+        }
+      bin = std::min( static_cast< unsigned int >( pos ), m_NumberOfBins - 1 );
+      }
+    m_Spectrum[ bin ] += m_Volumes[i];
+    m_TotalVolume += m_Volumes[i];
+    }
+
+  HistogramType * histogram = this->GetOutput();
+  typename HistogramType::SizeType size;
+  size.SetSize( 1 );
+  size.Fill( m_NumberOfBins );
+  typename HistogramType::MeasurementVectorType lower;
+  lower.SetSize( 1 );
+  lower[0] = minimum;
+  typename HistogramType::MeasurementVectorType upper;
+  upper.SetSize( 1 );
+  upper[0] = maximum;
+  histogram->SetMeasurementVectorSize( 1 );
+  histogram->SetClipBinsAtEnds( false );
+  histogram->Initialize( size, lower, upper );
+  for( unsigned int b=0; b<m_NumberOfBins; b++ )
+    {
+    histogram->SetFrequency( b, static_cast< typename HistogramType::AbsoluteFrequencyType >( m_Spectrum[b] + 0.5 ) );
+    }
+
+  m_Attributes.clear();
+  m_Volumes.clear();
+  progress.CompletedPixel();
+}
+
+
+template<class TImage, class TAttributeAccessor>
+unsigned long
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::ComputeContributions( const NodeType * node )
+{
+  assert(node != NULL);
+  AttributeAccessorType accessor;
+
+  unsigned long area = this->GetInput()->NodeCountOwnIndexes( node );
+
+  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+    {
+    area += this->ComputeContributions( *it );
+    }
+
+  if( !node->IsRoot() )
+    {
+    RealPixelType diff = static_cast< RealPixelType >( node->GetPixel() )
+                         - static_cast< RealPixelType >( node->GetParent()->GetPixel() );
+    if( diff < 0 )
+      {
+      // min tree
+      diff = -diff;
+      }
+    m_Attributes.push_back( static_cast< double >( accessor( node ) ) );
+    m_Volumes.push_back( static_cast< double >( diff ) * area );
+    }
+
+  return area;
+}
+
+
+template<class TImage, class TAttributeAccessor>
+void
+ComponentTreeToPatternSpectrumFilter<TImage, TAttributeAccessor>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfBins: " << m_NumberOfBins << std::endl;
+  os << indent << "AutoMinimumMaximum: " << m_AutoMinimumMaximum << std::endl;
+  os << indent << "BinMinimum: " << m_BinMinimum << std::endl;
+  os << indent << "BinMaximum: " << m_BinMaximum << std::endl;
+  os << indent << "TotalVolume: " << m_TotalVolume << std::endl;
+}
+
+}// end namespace itk
+#endif
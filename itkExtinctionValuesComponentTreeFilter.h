@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkExtinctionValuesComponentTreeFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkExtinctionValuesComponentTreeFilter_h
+#define __itkExtinctionValuesComponentTreeFilter_h
+
+#include "itkInPlaceComponentTreeFilter.h"
+
+namespace itk {
+/** \class ExtinctionValuesComponentTreeFilter
+ * \brief Replace the attribute of the leaves by their extinction value
+ *
+ * The extinction value of a leaf (a regional extremum) is the value of the
+ * attribute at which the leaf disappears when the tree is filtered with
+ * increasing values of the attribute, the leaves with the greatest
+ * attribute being the last to be removed.
+ * The extinction values are computed in a single leaf to root traversal:
+ * at each node, the leaf coming from the child with the greatest attribute
+ * goes on to the parent, and the leaves coming from the other children
+ * are given the attribute of their child. The leaf surviving at the root
+ * is given the attribute of the root.
+ *
+ * The attribute of the nodes which are not leaves is set to zero, so the
+ * output can be used directly with ComponentTreeAttributeToImageFilter to
+ * produce a marker image of the extinction values.
+ *
+ * The attribute is expected to be increasing. The dynamics of the regional
+ * extrema are the extinction values of the attribute computed by
+ * LocalIntensityComponentTreeFilter.
+ *
+ * This filter replaces the repeated use of KeepNLobesComponentTreeFilter
+ * with a varying number of lobes.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TImage, class TAttibuteAccessor=typename Functor::AttributeComponentTreeNodeAccessor< typename TImage::NodeType > >
+class ITK_EXPORT ExtinctionValuesComponentTreeFilter :
+    public InPlaceComponentTreeFilter<TImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ExtinctionValuesComponentTreeFilter Self;
+  typedef InPlaceComponentTreeFilter<TImage>
+  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TImage ImageType;
+  typedef typename ImageType::Pointer         ImagePointer;
+  typedef typename ImageType::ConstPointer    ImageConstPointer;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::NodeType        NodeType;
+  typedef typename ImageType::IndexType       IndexType;
+
+  typedef TAttibuteAccessor AttributeAccessorType;
+  typedef typename AttributeAccessorType::AttributeType   AttributeType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ExtinctionValuesComponentTreeFilter,
+               InPlaceComponentTreeFilter);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+/*  itkConceptMacro(InputEqualityComparableCheck,
+    (Concept::EqualityComparable<InputImagePixelType>));
+  itkConceptMacro(IntConvertibleToInputCheck,
+    (Concept::Convertible<int, InputImagePixelType>));
+  itkConceptMacro(InputOStreamWritableCheck,
+    (Concept::OStreamWritable<InputImagePixelType>));*/
+  /** End concept checking */
+#endif
+
+protected:
+  ExtinctionValuesComponentTreeFilter() {};
+  ~ExtinctionValuesComponentTreeFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Single-threaded version of GenerateData.  This filter delegates
+   * to GrayscaleGeodesicErodeImageFilter. */
+  void GenerateData();
+
+  /** Set the extinction values in the subtree of node, and return the leaf
+   * which has not been given an extinction value yet. */
+  NodeType * SetExtinctionValues( NodeType* );
+
+private:
+  ExtinctionValuesComponentTreeFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkExtinctionValuesComponentTreeFilter.txx"
+#endif
+
+#endif
+
+
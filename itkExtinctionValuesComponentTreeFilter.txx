@@ -0,0 +1,108 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkExtinctionValuesComponentTreeFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkExtinctionValuesComponentTreeFilter_txx
+#define __itkExtinctionValuesComponentTreeFilter_txx
+
+#include "itkExtinctionValuesComponentTreeFilter.h"
+#include "itkProgressReporter.h"
+
+
+namespace itk {
+
+template<class TInputImage, class TAttributeAccessor>
+void
+ExtinctionValuesComponentTreeFilter<TInputImage, TAttributeAccessor>
+::GenerateData()
+{
+  // Allocate the output
+  this->AllocateOutputs();
+
+  ProgressReporter progress(this, 0, 1);
+
+  NodeType * root = this->GetOutput()->GetRoot();
+  AttributeAccessorType accessor;
+  const AttributeType rootAttribute = accessor( root );
+
+  // the leaf which survives up to the root is the last one to disappear
+  NodeType * leaf = this->SetExtinctionValues( root );
+  if( leaf != root )
+    {
+    accessor( root, NumericTraits<AttributeType>::Zero );
+    }
+  accessor( leaf, rootAttribute );
+
+  // TODO: how to generate progress ??
+  progress.CompletedPixel();
+}
+
+
+template<class TInputImage, class TAttributeAccessor>
+typename ExtinctionValuesComponentTreeFilter<TInputImage, TAttributeAccessor>::NodeType *
+ExtinctionValuesComponentTreeFilter<TInputImage, TAttributeAccessor>
+::SetExtinctionValues( NodeType* node )
+{
+  assert(node != NULL);
+  AttributeAccessorType accessor;
+
+  NodeType * survivor = node;
+  AttributeType survivorAttribute = NumericTraits<AttributeType>::Zero;
+
+  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+    {
+    // the attribute of the child must be read before the child's subtree
+    // is processed, because it is reset to zero if the child is not a leaf
+    const AttributeType childAttribute = accessor( *it );
+    NodeType * leaf = this->SetExtinctionValues( *it );
+    if( *it != leaf )
+      {
+      accessor( *it, NumericTraits<AttributeType>::Zero );
+      }
+
+    if( survivor == node )
+      {
+      // first child: its leaf goes up for now
+      survivor = leaf;
+      survivorAttribute = childAttribute;
+      }
+    else if( childAttribute > survivorAttribute )
+      {
+      // the previous survivor is the weakest one, and disappears here
+      accessor( survivor, survivorAttribute );
+      survivor = leaf;
+      survivorAttribute = childAttribute;
+      }
+    else
+      {
+      accessor( leaf, childAttribute );
+      }
+    }
+
+  return survivor;
+}
+
+
+template<class TInputImage, class TAttributeAccessor>
+void
+ExtinctionValuesComponentTreeFilter<TInputImage, TAttributeAccessor>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+}
+
+}// end namespace itk
+#endif
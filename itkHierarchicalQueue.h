@@ -17,9 +17,11 @@
 #ifndef __itkHierarchicalQueue_h
 #define __itkHierarchicalQueue_h
 
-// #include <vector>
+#include <vector>
 #include <list>
 #include <map>
+#include <algorithm>
+#include <cstring>
 
 namespace itk
 {
@@ -35,6 +37,10 @@ namespace itk
  * values are returned in the same order they have been pushed in the queue.
  * This class gives both better performances for image analysis, and ensure
  * the output order of the values.
+ *
+ * The queue is specialized for the small integer keys, with
+ * VectorHierarchicalQueue, and for the floating point and the int and long
+ * keys ordered with std::less or std::greater, with RadixHierarchicalQueue.
  */
 template <typename TKey, typename TValue, typename TCompare=typename std::less<TKey> >
 class HierarchicalQueue
@@ -117,6 +123,178 @@ private:
 
 
 
+/** \class LevelBitmap
+ *  \brief A set of levels, with a fast search of the nearest levels
+ *
+ * The levels are marked in a two level bitmap, with a bit per level and a
+ * bit per non null word of the first level, so the next or the previous
+ * level in the set is found with a few bit scans instead of testing all the
+ * levels in between. It is used to find the non empty buckets of the
+ * hierarchical queues.
+ */
+class LevelBitmap
+{
+public:
+  LevelBitmap()
+    {
+    }
+
+  /** Set the number of levels, and clear all the levels */
+  inline void Initialize( unsigned long numberOfLevels )
+    {
+    m_Bits.assign( ( numberOfLevels + WordSize - 1 ) / WordSize, 0 );
+    m_Summary.assign( ( m_Bits.size() + WordSize - 1 ) / WordSize, 0 );
+    }
+
+  inline void Set( unsigned long level )
+    {
+    const unsigned long word = level >> WordShift;
+    m_Bits[ word ] |= WordType(1) << ( level & ( WordSize - 1 ) );
+    m_Summary[ word >> WordShift ] |= WordType(1) << ( word & ( WordSize - 1 ) );
+    }
+
+  inline void Clear( unsigned long level )
+    {
+    const unsigned long word = level >> WordShift;
+    m_Bits[ word ] &= ~( WordType(1) << ( level & ( WordSize - 1 ) ) );
+    if( m_Bits[ word ] == 0 )
+      {
+      m_Summary[ word >> WordShift ] &= ~( WordType(1) << ( word & ( WordSize - 1 ) ) );
+      }
+    }
+
+  /** Find the lowest level of the set greater than level. Return false if
+   * there is none. */
+  inline bool Next( unsigned long level, unsigned long & next ) const
+    {
+    const unsigned long word = level >> WordShift;
+    const unsigned int bit = level & ( WordSize - 1 );
+    if( bit != WordSize - 1 )
+      {
+      const WordType w = m_Bits[ word ] & ( ~WordType(0) << ( bit + 1 ) );
+      if( w != 0 )
+        {
+        next = ( word << WordShift ) + LowestBit( w );
+        return true;
+        }
+      }
+    // search the next non empty word in the summary
+    const unsigned long first = word + 1;
+    if( first >= m_Bits.size() )
+      {
+      return false;
+      }
+    unsigned long s = first >> WordShift;
+    WordType sw = m_Summary[ s ] & ( ~WordType(0) << ( first & ( WordSize - 1 ) ) );
+    while( sw == 0 )
+      {
+      s++;
+      if( s >= m_Summary.size() )
+        {
+        return false;
+        }
+      sw = m_Summary[ s ];
+      }
+    const unsigned long found = ( s << WordShift ) + LowestBit( sw );
+    next = ( found << WordShift ) + LowestBit( m_Bits[ found ] );
+    return true;
+    }
+
+  /** Find the highest level of the set lower than level. Return false if
+   * there is none. */
+  inline bool Previous( unsigned long level, unsigned long & previous ) const
+    {
+    const unsigned long word = level >> WordShift;
+    const unsigned int bit = level & ( WordSize - 1 );
+    if( bit != 0 )
+      {
+      const WordType w = m_Bits[ word ] & ( ~WordType(0) >> ( WordSize - bit ) );
+      if( w != 0 )
+        {
+        previous = ( word << WordShift ) + HighestBit( w );
+        return true;
+        }
+      }
+    // search the previous non empty word in the summary
+    if( word == 0 )
+      {
+      return false;
+      }
+    const unsigned long last = word - 1;
+    unsigned long s = last >> WordShift;
+    WordType sw = m_Summary[ s ] & ( ~WordType(0) >> ( WordSize - 1 - ( last & ( WordSize - 1 ) ) ) );
+    while( sw == 0 )
+      {
+      if( s == 0 )
+        {
+        return false;
+        }
+      s--;
+      sw = m_Summary[ s ];
+      }
+    const unsigned long found = ( s << WordShift ) + HighestBit( sw );
+    previous = ( found << WordShift ) + HighestBit( m_Bits[ found ] );
+    return true;
+    }
+
+private:
+  typedef unsigned long long WordType;
+  typedef std::vector<WordType> BitmapType;
+
+  enum { WordSize = 64, WordShift = 6 };
+
+  /** index of the lowest set bit of a non null word */
+  static inline unsigned int LowestBit( WordType w )
+    {
+    assert( w != 0 );
+#if defined(__GNUC__)
+    return __builtin_ctzll( w );
+#else
+    unsigned int b = 0;
+    while( !( w & 1 ) )
+      {
+      w >>= 1;
+      b++;
+      }
+    return b;
+#endif
+    }
+
+  /** index of the highest set bit of a non null word */
+  static inline unsigned int HighestBit( WordType w )
+    {
+    assert( w != 0 );
+#if defined(__GNUC__)
+    return WordSize - 1 - __builtin_clzll( w );
+#else
+    unsigned int b = 0;
+    while( w >>= 1 )
+      {
+      b++;
+      }
+    return b;
+#endif
+    }
+
+  // a bit per level, and a bit per non null word of m_Bits
+  BitmapType m_Bits;
+  BitmapType m_Summary;
+};
+
+
+/** \class VectorHierarchicalQueue
+ *  \brief HierarchicalQueue for the small integer keys
+ *
+ * There is a bucket for each possible key. Each bucket is a vector used as a
+ * FIFO: the values are appended at the end and read from a head position.
+ * The bucket is cleared when it becomes empty, and the already read values
+ * are removed when they use more than half of the bucket, so the memory is
+ * reused without allocating a node per value as a list would do.
+ *
+ * The non empty buckets are marked in a LevelBitmap, so the next non empty
+ * bucket is found with a few bit scans instead of testing all the buckets in
+ * between.
+ */
 template <typename TKey, typename TValue, typename TCompare >
 class VectorHierarchicalQueue
 {
@@ -130,8 +308,8 @@ public:
   typedef TKey KeyType;
   typedef TCompare CompareType;
 
-  typedef std::list<ValueType>      ValueListType;
-  typedef std::vector<ValueListType>  VectorType;
+  typedef std::vector<ValueType>      ValueVectorType;
+  typedef std::vector<ValueVectorType>  VectorType;
 
   // for code conciseness
   typedef NumericTraits< TKey > NT;
@@ -147,7 +325,8 @@ public:
   inline const ValueType & FrontValue() const
     {
     assert(!this->Empty());
-    return m_Vector[ m_CurrentValue  - NT::NonpositiveMin() ].front();
+    const unsigned long level = m_CurrentValue - NT::NonpositiveMin();
+    return m_Vector[ level ][ m_Heads[ level ] ];
     }
 
   /** push a value in the queue */
@@ -156,7 +335,13 @@ public:
     assert( k  - NT::NonpositiveMin() < m_Vector.size() );
     assert( k  - NT::NonpositiveMin() >= 0 );
 
-    m_Vector[ k  - NT::NonpositiveMin() ].push_back( v );
+    const unsigned long level = k - NT::NonpositiveMin();
+    ValueVectorType & values = m_Vector[ level ];
+    if( values.empty() )
+      {
+      m_Levels.Set( level );
+      }
+    values.push_back( v );
     if( this->Empty() || m_Compare( k, m_CurrentValue ) )
       {
       m_CurrentValue = k;
@@ -180,24 +365,49 @@ public:
   inline void Pop()
     {
     assert(!this->Empty());
-    ValueListType & valueList = m_Vector[ m_CurrentValue  - NT::NonpositiveMin() ];
-    valueList.pop_front();
+    const unsigned long level = m_CurrentValue - NT::NonpositiveMin();
+    ValueVectorType & values = m_Vector[ level ];
+    unsigned long & head = m_Heads[ level ];
+    head++;
     m_Size--;
 
-    if( valueList.empty() && !this->Empty() )
+    if( head == values.size() )
       {
-      // update the current key to a new value
-      while( m_Vector[ m_CurrentValue - NT::NonpositiveMin() ].empty() )
+      // the bucket is empty. clear() keeps the memory for the next values
+      values.clear();
+      head = 0;
+      m_Levels.Clear( level );
+      if( !this->Empty() )
         {
-        m_CurrentValue += m_Direction;
+        // update the current key to a new value
+        unsigned long next = 0;
+        bool found;
+        if( m_Direction > 0 )
+          {
+          found = m_Levels.Next( level, next );
+          }
+        else
+          {
+          found = m_Levels.Previous( level, next );
+          }
+        assert( found );
+        (void)found;
+        m_CurrentValue = static_cast< KeyType >( next + NT::NonpositiveMin() );
         }
       }
-
+    else if( head >= MinimumCompactionSize && head * 2 > values.size() )
+      {
+      // remove the values already read
+      values.erase( values.begin(), values.begin() + head );
+      head = 0;
+      }
     }
 
   VectorHierarchicalQueue()
     {
     m_Vector.resize( NT::max() - NT::NonpositiveMin() + 1 );
+    m_Heads.resize( m_Vector.size(), 0 );
+    m_Levels.Initialize( m_Vector.size() );
     if( m_Compare( NT::max(), NT::NonpositiveMin() ) )
       {
       m_Direction = -1;
@@ -218,7 +428,14 @@ protected:
 
 private:
 
+  // don't move the values of the small buckets
+  enum { MinimumCompactionSize = 1024 };
+
   VectorType m_Vector;
+  // the position of the first value of each bucket
+  std::vector<unsigned long> m_Heads;
+  // the non empty buckets
+  LevelBitmap m_Levels;
   unsigned long m_Size;
   TKey m_CurrentValue;
   TCompare m_Compare;
@@ -226,6 +443,309 @@ private:
 
 };
 
+/** \class RadixHierarchicalQueueKeyTraits
+ *  \brief Convert a key to an unsigned integer with the same ordering
+ *
+ * This class is used by RadixHierarchicalQueue, and is specialized for the
+ * supported key types.
+ */
+template <typename TKey>
+class RadixHierarchicalQueueKeyTraits
+{
+};
+
+template <>
+class RadixHierarchicalQueueKeyTraits<float>
+{
+public:
+  static inline unsigned long long Encode( const float & k )
+    {
+    unsigned int u;
+    std::memcpy( &u, &k, sizeof(u) );
+    // reverse the negative values, and put them before the positive ones
+    u = ( u & 0x80000000u ) ? ~u : ( u | 0x80000000u );
+    return u;
+    }
+};
+
+template <>
+class RadixHierarchicalQueueKeyTraits<double>
+{
+public:
+  static inline unsigned long long Encode( const double & k )
+    {
+    unsigned long long u;
+    std::memcpy( &u, &k, sizeof(u) );
+    // reverse the negative values, and put them before the positive ones
+    const unsigned long long sign = 1ULL << 63;
+    return ( u & sign ) ? ~u : ( u | sign );
+    }
+};
+
+template <>
+class RadixHierarchicalQueueKeyTraits<int>
+{
+public:
+  static inline unsigned long long Encode( const int & k )
+    {
+    return static_cast<unsigned long long>( static_cast<long long>( k ) ) ^ ( 1ULL << 63 );
+    }
+};
+
+template <>
+class RadixHierarchicalQueueKeyTraits<unsigned int>
+{
+public:
+  static inline unsigned long long Encode( const unsigned int & k )
+    {
+    return k;
+    }
+};
+
+template <>
+class RadixHierarchicalQueueKeyTraits<long>
+{
+public:
+  static inline unsigned long long Encode( const long & k )
+    {
+    return static_cast<unsigned long long>( static_cast<long long>( k ) ) ^ ( 1ULL << 63 );
+    }
+};
+
+template <>
+class RadixHierarchicalQueueKeyTraits<unsigned long>
+{
+public:
+  static inline unsigned long long Encode( const unsigned long & k )
+    {
+    return k;
+    }
+};
+
+
+/** \class RadixHierarchicalQueue
+ *  \brief HierarchicalQueue for the floating point and large integer keys
+ *
+ * The keys are converted to unsigned integers with the same ordering, and
+ * stored in a radix heap: the values with the same key as the last
+ * front value are in the bucket 0, and the other ones in the bucket given
+ * by the highest bit which differs from that key. When the bucket 0 is
+ * empty, the smallest non empty bucket is spread in the lower buckets,
+ * which is done at most once per bit for each value. The buckets are
+ * vectors, so there is no allocation per value, and the values keep their
+ * order, so the values with the same key are still returned in the order
+ * they have been pushed.
+ *
+ * A radix heap requires the pushed keys to not be before the front key.
+ * Some algorithms can't guarantee that, so the values pushed before the
+ * front key are stored in a map, which is used first. With a monotone
+ * usage, like the removal of the leaves by increasing attribute, the map is
+ * never used.
+ *
+ * When VReverse is true, the keys are returned from the greatest to the
+ * lowest.
+ */
+template <typename TKey, typename TValue, typename TCompare, bool VReverse>
+class RadixHierarchicalQueue
+{
+
+public:
+
+  /** Standard typedefs */
+  typedef RadixHierarchicalQueue      Self;
+
+  typedef TValue ValueType;
+  typedef TKey KeyType;
+  typedef TCompare CompareType;
+
+  typedef unsigned long long CodeType;
+  typedef RadixHierarchicalQueueKeyTraits< TKey > KeyTraitsType;
+
+  /** return the current key */
+  inline const KeyType & FrontKey() const
+    {
+    assert(!this->Empty());
+    return this->Front().Key;
+    }
+
+  /** return the current value */
+  inline const ValueType & FrontValue() const
+    {
+    assert(!this->Empty());
+    return this->Front().Value;
+    }
+
+  /** push a value in the queue */
+  inline void Push( const KeyType & k, const ValueType & v)
+    {
+    ElementType e;
+    e.Code = KeyTraitsType::Encode( k );
+    if( VReverse )
+      {
+      e.Code = ~e.Code;
+      }
+    e.Key = k;
+    e.Value = v;
+
+    if( m_RadixSize == 0 && ( m_Overflow.empty() || e.Code >= m_Last ) )
+      {
+      // the radix heap is empty: start it from that key
+      m_Last = e.Code;
+      }
+
+    if( e.Code < m_Last )
+      {
+      // can't go in the radix heap
+      m_Overflow[ e.Code ].push_back( e );
+      }
+    else
+      {
+      m_Buckets[ this->BucketIndex( e.Code ) ].push_back( e );
+      m_RadixSize++;
+      }
+    m_Size++;
+    }
+
+  /** return the size of the queue */
+  inline const unsigned long & Size() const
+    {
+    return m_Size;
+    }
+
+  /** return true if the queue is empty */
+  inline const bool Empty() const
+    {
+    return m_Size == 0;
+    }
+
+  /** remove the first element of the queue */
+  inline void Pop()
+    {
+    assert(!this->Empty());
+    m_Size--;
+
+    if( !m_Overflow.empty() )
+      {
+      ElementListType & elements = m_Overflow.begin()->second;
+      elements.pop_front();
+      if( elements.empty() )
+        {
+        m_Overflow.erase( m_Overflow.begin() );
+        }
+      return;
+      }
+
+    ElementVectorType & first = m_Buckets[0];
+    m_Head++;
+    m_RadixSize--;
+    if( m_Head == first.size() )
+      {
+      first.clear();
+      m_Head = 0;
+      if( m_RadixSize != 0 )
+        {
+        this->Redistribute();
+        }
+      }
+    }
+
+  RadixHierarchicalQueue()
+    {
+    m_Size = 0;
+    m_RadixSize = 0;
+    m_Head = 0;
+    m_Last = 0;
+    }
+
+
+protected:
+
+private:
+
+  struct ElementType
+    {
+    CodeType Code;
+    KeyType Key;
+    ValueType Value;
+    };
+
+  typedef std::vector<ElementType> ElementVectorType;
+  typedef std::list<ElementType> ElementListType;
+  typedef std::map<CodeType, ElementListType> OverflowMapType;
+
+  enum { NumberOfBuckets = 65 };
+
+  inline const ElementType & Front() const
+    {
+    if( !m_Overflow.empty() )
+      {
+      return m_Overflow.begin()->second.front();
+      }
+    return m_Buckets[0][ m_Head ];
+    }
+
+  /** 0 for m_Last, or 1 + the position of the highest bit which differs
+   * from m_Last */
+  inline unsigned int BucketIndex( CodeType code ) const
+    {
+    CodeType diff = code ^ m_Last;
+    if( diff == 0 )
+      {
+      return 0;
+      }
+#if defined(__GNUC__)
+    return 64 - __builtin_clzll( diff );
+#else
+    unsigned int b = 0;
+    while( diff != 0 )
+      {
+      diff >>= 1;
+      b++;
+      }
+    return b;
+#endif
+    }
+
+  /** move the values of the smallest non empty bucket to the lower buckets.
+   * The bucket 0 must be empty. */
+  void Redistribute()
+    {
+    assert( m_Buckets[0].empty() );
+    unsigned int i = 1;
+    while( m_Buckets[i].empty() )
+      {
+      i++;
+      assert( i < NumberOfBuckets );
+      }
+
+    ElementVectorType & bucket = m_Buckets[i];
+    CodeType minimum = bucket[0].Code;
+    for( typename ElementVectorType::const_iterator it=bucket.begin(); it!=bucket.end(); it++ )
+      {
+      minimum = std::min( minimum, it->Code );
+      }
+    m_Last = minimum;
+
+    // all the values go in the lower buckets, in the same order
+    for( typename ElementVectorType::const_iterator it=bucket.begin(); it!=bucket.end(); it++ )
+      {
+      const unsigned int b = this->BucketIndex( it->Code );
+      assert( b < i );
+      m_Buckets[b].push_back( *it );
+      }
+    bucket.clear();
+    }
+
+  ElementVectorType m_Buckets[NumberOfBuckets];
+  // the position of the first value in the bucket 0
+  unsigned long m_Head;
+  CodeType m_Last;
+  OverflowMapType m_Overflow;
+  unsigned long m_Size;
+  unsigned long m_RadixSize;
+
+};
+
 template <typename TValue, typename TCompare >
 class HierarchicalQueue<unsigned char, TValue, TCompare>
 : public VectorHierarchicalQueue<unsigned char, TValue, TCompare>
@@ -256,6 +776,78 @@ class HierarchicalQueue<bool, TValue, TCompare>
 {
 };
 
+template <typename TValue>
+class HierarchicalQueue<float, TValue, std::less<float> >
+: public RadixHierarchicalQueue<float, TValue, std::less<float>, false>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<float, TValue, std::greater<float> >
+: public RadixHierarchicalQueue<float, TValue, std::greater<float>, true>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<double, TValue, std::less<double> >
+: public RadixHierarchicalQueue<double, TValue, std::less<double>, false>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<double, TValue, std::greater<double> >
+: public RadixHierarchicalQueue<double, TValue, std::greater<double>, true>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<int, TValue, std::less<int> >
+: public RadixHierarchicalQueue<int, TValue, std::less<int>, false>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<int, TValue, std::greater<int> >
+: public RadixHierarchicalQueue<int, TValue, std::greater<int>, true>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<unsigned int, TValue, std::less<unsigned int> >
+: public RadixHierarchicalQueue<unsigned int, TValue, std::less<unsigned int>, false>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<unsigned int, TValue, std::greater<unsigned int> >
+: public RadixHierarchicalQueue<unsigned int, TValue, std::greater<unsigned int>, true>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<long, TValue, std::less<long> >
+: public RadixHierarchicalQueue<long, TValue, std::less<long>, false>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<long, TValue, std::greater<long> >
+: public RadixHierarchicalQueue<long, TValue, std::greater<long>, true>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<unsigned long, TValue, std::less<unsigned long> >
+: public RadixHierarchicalQueue<unsigned long, TValue, std::less<unsigned long>, false>
+{
+};
+
+template <typename TValue>
+class HierarchicalQueue<unsigned long, TValue, std::greater<unsigned long> >
+: public RadixHierarchicalQueue<unsigned long, TValue, std::greater<unsigned long>, true>
+{
+};
+
 
 } // end namespace itk
 
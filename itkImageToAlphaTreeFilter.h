@@ -0,0 +1,223 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkImageToAlphaTreeFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkImageToAlphaTreeFilter_h
+#define __itkImageToAlphaTreeFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkComponentTreeAccumulator.h"
+#include <vector>
+#include <utility>
+#include <cmath>
+
+namespace itk {
+
+namespace Functor {
+
+/** \class MaximumComponentDifference
+ * \brief The largest absolute difference between the components of two pixels
+ *
+ * This is the default dissimilarity of ImageToAlphaTreeFilter. The pixels
+ * must provide Size() and operator[], like RGBPixel, Vector or
+ * VariableLengthVector.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ImageToAlphaTreeFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template< class TInput, class TOutput >
+class MaximumComponentDifference
+{
+public:
+  inline TOutput operator()( const TInput & a, const TInput & b ) const
+    {
+    double m = 0;
+    for( unsigned int i=0; i<a.Size(); i++ )
+      {
+      const double d = std::fabs( static_cast< double >( a[i] ) - static_cast< double >( b[i] ) );
+      if( d > m )
+        {
+        m = d;
+        }
+      }
+    return static_cast< TOutput >( m );
+    }
+};
+
+}
+
+
+/** \class ImageToAlphaTreeFilter
+ * \brief Convert a multichannel image to an alpha tree
+ *
+ * The alpha-connected component of a pixel is the set of pixels which can
+ * be reached from it by a path where the dissimilarity between two
+ * successive pixels is lower or equal to alpha. Those components, also
+ * called quasi-flat zones, form a hierarchy when alpha grows: the alpha
+ * tree. Its leaves are the flat zones, with alpha equal to 0, and its root
+ * is the whole image.
+ *
+ * Only a dissimilarity between the neighbor pixels is required, so the
+ * pixels don't have to be totally ordered, and a single tree is built for
+ * all the channels of the image, where a max tree would have to be built
+ * for each channel. The dissimilarity is given by the TDissimilarity
+ * functor, which returns a value of the pixel type of the output tree. By
+ * default, it is the largest absolute difference between the components of
+ * the pixels. See MaximumComponentDifference.
+ *
+ * The output is a ComponentTree where the value of each node is its alpha
+ * level, so the attribute filters of the component trees can be used on
+ * it. The reconstruction filters produce an image of alpha levels: with
+ * AttributeFilteringComponentTreeToImageFilter, each pixel gets the
+ * level of the smallest component which contains it and is kept by the
+ * filtering. Only the flat zones have some pixels.
+ *
+ * The tree is built with a union-find on the edges between the neighbor
+ * pixels, processed by increasing dissimilarity. The edges are sorted with
+ * a counting sort when the dissimilarity is an integer with a small range,
+ * and with std::sort otherwise. The flat zones are labeled first, with the
+ * edges of null dissimilarity, and the nodes of the same level are merged
+ * while the tree is built, so there is no node to remove at the end.
+ *
+ * The attributes which can be merged in constant time can be computed
+ * while the tree is built, with the TAccumulator template parameter. See
+ * NullComponentTreeAccumulator.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ImageToMaximumTreeFilter ComponentTree MaximumComponentDifference
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TInputImage, class TOutputImage,
+         class TDissimilarity=Functor::MaximumComponentDifference< typename TInputImage::PixelType, typename TOutputImage::PixelType >,
+         class TAccumulator=Functor::NullComponentTreeAccumulator< typename TOutputImage::NodeType > >
+class ITK_EXPORT ImageToAlphaTreeFilter :
+    public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageToAlphaTreeFilter Self;
+  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename InputImageType::Pointer         InputImagePointer;
+  typedef typename InputImageType::ConstPointer    InputImageConstPointer;
+  typedef typename InputImageType::RegionType      InputImageRegionType;
+  typedef typename InputImageType::PixelType       InputImagePixelType;
+  typedef typename InputImageType::OffsetType      OffsetType;
+  typedef typename InputImageType::OffsetValueType OffsetValueType;
+  typedef typename OutputImageType::Pointer        OutputImagePointer;
+  typedef typename OutputImageType::ConstPointer   OutputImageConstPointer;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+  typedef typename OutputImageType::NodeType       NodeType;
+  typedef typename OutputImageType::AttributeType  AttributeType;
+  typedef typename OutputImageType::IndexType      IndexType;
+  typedef TDissimilarity                           DissimilarityType;
+  typedef TAccumulator                             AccumulatorType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ImageToAlphaTreeFilter,
+               ImageToImageFilter);
+
+  /**
+   * Set/Get whether the connected components are defined strictly by
+   * face connectivity or by face+edge+vertex connectivity.  Default is
+   * FullyConnectedOff.
+   */
+  itkSetMacro(FullyConnected, bool);
+  itkGetConstReferenceMacro(FullyConnected, bool);
+  itkBooleanMacro(FullyConnected);
+
+  /**
+   * Set/Get whether the output tree is run-length encoded. Default is
+   * RunLengthEncodingOff.
+   */
+  itkSetMacro(RunLengthEncoding, bool);
+  itkGetConstReferenceMacro(RunLengthEncoding, bool);
+  itkBooleanMacro(RunLengthEncoding);
+
+protected:
+  ImageToAlphaTreeFilter();
+  ~ImageToAlphaTreeFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** ImageToAlphaTreeFilter needs the entire input be
+   * available. Thus, it needs to provide an implementation of
+   * GenerateInputRequestedRegion(). */
+  void GenerateInputRequestedRegion() ;
+
+  /** ImageToAlphaTreeFilter will produce the entire output. */
+  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
+
+  /** Compute and sort the edges, then build the tree */
+  void GenerateData();
+
+  /** An edge is stored with its dissimilarity and its position, which is
+   * the offset of the pixel multiplied by the number of neighbors, plus the
+   * position of the other pixel in the neighbors. */
+  typedef std::pair< OutputImagePixelType, OffsetValueType > EdgeType;
+  typedef std::vector< EdgeType > EdgesType;
+
+  /** Sort the edges by dissimilarity, then by position */
+  void SortEdges( EdgesType & edges ) const;
+
+  /** Compute the strides of the input buffer, and the neighbors already
+   * visited in a raster scan with the current connectivity */
+  void ComputeNeighbors( OffsetValueType * strides, std::vector< OffsetType > & neighbors,
+                         std::vector< OffsetValueType > & neighborOffsets ) const;
+
+  /** Return the root of a pixel in the union-find structure, with path
+   * halving */
+  static inline OffsetValueType FindRoot( std::vector< OffsetValueType > & zpar, OffsetValueType p )
+    {
+    while( zpar[p] != p )
+      {
+      zpar[p] = zpar[ zpar[p] ];
+      p = zpar[p];
+      }
+    return p;
+    }
+
+private:
+  ImageToAlphaTreeFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  bool                m_FullyConnected;
+  bool                m_RunLengthEncoding;
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageToAlphaTreeFilter.txx"
+#endif
+
+#endif
+
+
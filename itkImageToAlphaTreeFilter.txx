@@ -0,0 +1,396 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkImageToAlphaTreeFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkImageToAlphaTreeFilter_txx
+#define __itkImageToAlphaTreeFilter_txx
+
+#include "itkImageToAlphaTreeFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+#include "itkNumericTraits.h"
+#include <algorithm>
+
+
+namespace itk {
+
+template <class TInputImage, class TOutputImage, class TDissimilarity, class TAccumulator>
+ImageToAlphaTreeFilter<TInputImage, TOutputImage, TDissimilarity, TAccumulator>
+::ImageToAlphaTreeFilter()
+{
+  m_FullyConnected = false;
+  m_RunLengthEncoding = false;
+}
+
+
+template <class TInputImage, class TOutputImage, class TDissimilarity, class TAccumulator>
+void
+ImageToAlphaTreeFilter<TInputImage, TOutputImage, TDissimilarity, TAccumulator>
+::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  // We need all the input.
+  InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
+
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+template <class TInputImage, class TOutputImage, class TDissimilarity, class TAccumulator>
+void
+ImageToAlphaTreeFilter<TInputImage, TOutputImage, TDissimilarity, TAccumulator>
+::EnlargeOutputRequestedRegion(DataObject *)
+{
+  this->GetOutput()
+    ->SetRequestedRegion( this->GetOutput()->GetLargestPossibleRegion() );
+}
+
+
+template<class TInputImage, class TOutputImage, class TDissimilarity, class TAccumulator>
+void
+ImageToAlphaTreeFilter<TInputImage, TOutputImage, TDissimilarity, TAccumulator>
+::GenerateData()
+{
+  // Allocate the output
+  this->AllocateOutputs();
+
+  OutputImageType * output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+  const InputImageRegionType & region = input->GetRequestedRegion();
+  const typename InputImageRegionType::SizeType & size = region.GetSize();
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+
+  ProgressReporter progress(this, 0, numberOfPixels * 2);
+
+  // copy the pixels, to access them by offset whatever the image type
+  std::vector< InputImagePixelType > pixels;
+  pixels.reserve( numberOfPixels );
+  ImageRegionConstIterator< InputImageType > iIt( input, region );
+  for( iIt.GoToBegin(); !iIt.IsAtEnd(); ++iIt )
+    {
+    pixels.push_back( iIt.Get() );
+    }
+
+  OffsetValueType strides[ImageDimension];
+  std::vector< OffsetType > neighbors;
+  std::vector< OffsetValueType > neighborOffsets;
+  this->ComputeNeighbors( strides, neighbors, neighborOffsets );
+  const unsigned int numberOfNeighbors = neighbors.size();
+
+  // compute the dissimilarity of the edges, with the neighbors already
+  // visited, so each edge is stored once
+  DissimilarityType dissimilarity;
+  EdgesType edges;
+  edges.reserve( numberOfPixels * numberOfNeighbors );
+  IndexType idx;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    const OffsetValueType p = i;
+    OffsetValueType o = p;
+    bool border = false;
+    for( int d=ImageDimension-1; d>=0; d-- )
+      {
+      idx[d] = o / strides[d];
+      o -= idx[d] * strides[d];
+      if( idx[d] == 0 || idx[d] == static_cast< long >( size[d] ) - 1 )
+        {
+        border = true;
+        }
+      }
+    for( unsigned int j=0; j<numberOfNeighbors; j++ )
+      {
+      if( border )
+        {
+        bool inside = true;
+        for( unsigned int d=0; d<ImageDimension; d++ )
+          {
+          const long c = idx[d] + neighbors[j][d];
+          if( c < 0 || c >= static_cast< long >( size[d] ) )
+            {
+            inside = false;
+            }
+          }
+        if( !inside )
+          {
+          continue;
+          }
+        }
+      const OffsetValueType n = p + neighborOffsets[j];
+      edges.push_back( EdgeType( dissimilarity( pixels[p], pixels[n] ), p * numberOfNeighbors + j ) );
+      }
+    progress.CompletedPixel();
+    }
+  std::vector< InputImagePixelType >().swap( pixels );
+
+  this->SortEdges( edges );
+
+  // label the flat zones with the edges of null dissimilarity
+  const OutputImagePixelType zero = NumericTraits< OutputImagePixelType >::Zero;
+  std::vector< OffsetValueType > zpar( numberOfPixels );
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    zpar[i] = i;
+    }
+  unsigned long e = 0;
+  for( ; e<edges.size() && !( zero < edges[e].first ); e++ )
+    {
+    const OffsetValueType p = edges[e].second / numberOfNeighbors;
+    const OffsetValueType n = p + neighborOffsets[ edges[e].second % numberOfNeighbors ];
+    const OffsetValueType r1 = FindRoot( zpar, p );
+    const OffsetValueType r2 = FindRoot( zpar, n );
+    if( r1 != r2 )
+      {
+      zpar[r2] = r1;
+      }
+    }
+
+  // the flat zones are the leaves, and the only nodes with some pixels.
+  // nodes stores the node of the root of each component in the union-find.
+  AccumulatorType accumulator;
+  accumulator.SetComponentTree( output );
+  std::vector< NodeType * > nodes( numberOfPixels, NULL );
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    const OffsetValueType r = FindRoot( zpar, i );
+    if( nodes[r] == NULL )
+      {
+      NodeType * node = new NodeType();
+      node->SetPixel( zero );
+      if( AccumulatorType::Active )
+        {
+        accumulator.Initialize( node );
+        }
+      nodes[r] = node;
+      }
+    output->NodeAddIndex( nodes[r], i );
+    if( AccumulatorType::Active )
+      {
+      accumulator.AddPixel( nodes[r], i );
+      }
+    progress.CompletedPixel();
+    }
+
+  // then merge the components by increasing dissimilarity. A component
+  // created at the current level absorbs the other one, or the components
+  // at the same level are merged, so there is a single node per level.
+  unsigned long numberOfComponents = 0;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    if( nodes[i] != NULL )
+      {
+      numberOfComponents++;
+      }
+    }
+  for( ; e<edges.size() && numberOfComponents > 1; e++ )
+    {
+    const OffsetValueType p = edges[e].second / numberOfNeighbors;
+    const OffsetValueType n = p + neighborOffsets[ edges[e].second % numberOfNeighbors ];
+    const OffsetValueType r1 = FindRoot( zpar, p );
+    const OffsetValueType r2 = FindRoot( zpar, n );
+    if( r1 == r2 )
+      {
+      continue;
+      }
+    const OutputImagePixelType & alpha = edges[e].first;
+    NodeType * node1 = nodes[r1];
+    NodeType * node2 = nodes[r2];
+    NodeType * node;
+    if( node1->GetPixel() == alpha && node2->GetPixel() == alpha )
+      {
+      // both have been created at this level: node2 has no pixels, only its
+      // children are moved
+      typename NodeType::ChildrenListType & children = node2->GetChildren();
+      for( typename NodeType::ChildrenListType::iterator it=children.begin(); it!=children.end(); it++ )
+        {
+        (*it)->SetParent( node1 );
+        }
+      node1->TakeChildrenFrom( node2 );
+      if( AccumulatorType::Active )
+        {
+        accumulator.Merge( node1, node2 );
+        }
+      delete node2;
+      node = node1;
+      }
+    else if( node1->GetPixel() == alpha )
+      {
+      node1->AddChild( node2 );
+      if( AccumulatorType::Active )
+        {
+        accumulator.Merge( node1, node2 );
+        }
+      node = node1;
+      }
+    else if( node2->GetPixel() == alpha )
+      {
+      node2->AddChild( node1 );
+      if( AccumulatorType::Active )
+        {
+        accumulator.Merge( node2, node1 );
+        }
+      node = node2;
+      }
+    else
+      {
+      node = new NodeType();
+      node->SetPixel( alpha );
+      if( AccumulatorType::Active )
+        {
+        accumulator.Initialize( node );
+        }
+      node->AddChild( node1 );
+      node->AddChild( node2 );
+      if( AccumulatorType::Active )
+        {
+        accumulator.Merge( node, node1 );
+        accumulator.Merge( node, node2 );
+        }
+      }
+    zpar[r2] = r1;
+    nodes[r1] = node;
+    nodes[r2] = NULL;
+    numberOfComponents--;
+    }
+
+  // the image is connected, so there is a single component left
+  assert( numberOfComponents == 1 );
+  NodeType * root = nodes[ FindRoot( zpar, 0 ) ];
+  assert( root != NULL );
+  assert( output->NodeCountIndexes( root ) == numberOfPixels );
+
+  // to be sure that root parent is NULL
+  root->SetParent( NULL );
+
+  // keep a pointer on the root node
+  output->SetRoot( root );
+
+  if( m_RunLengthEncoding )
+    {
+    output->EncodeRunLength();
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TDissimilarity, class TAccumulator>
+void
+ImageToAlphaTreeFilter<TInputImage, TOutputImage, TDissimilarity, TAccumulator>
+::SortEdges( EdgesType & edges ) const
+{
+  if( edges.empty() )
+    {
+    return;
+    }
+
+  // a counting sort is linear when the dissimilarities are integers in a
+  // range not much larger than the number of edges
+  if( NumericTraits< OutputImagePixelType >::is_integer )
+    {
+    OutputImagePixelType minimum = edges[0].first;
+    OutputImagePixelType maximum = edges[0].first;
+    for( typename EdgesType::const_iterator it=edges.begin(); it!=edges.end(); it++ )
+      {
+      minimum = std::min( minimum, it->first );
+      maximum = std::max( maximum, it->first );
+      }
+    const double range = static_cast< double >( maximum ) - static_cast< double >( minimum ) + 1;
+    if( range <= edges.size() + 65536.0 )
+      {
+      // the position of the first edge of each value. The edges are
+      // already ordered by position, and the counting sort is stable.
+      std::vector< unsigned long > starts( static_cast< unsigned long >( range ) + 1, 0 );
+      for( typename EdgesType::const_iterator it=edges.begin(); it!=edges.end(); it++ )
+        {
+        starts[ static_cast< unsigned long >( it->first - minimum ) + 1 ]++;
+        }
+      for( unsigned long i=1; i<starts.size(); i++ )
+        {
+        starts[i] += starts[i-1];
+        }
+      EdgesType sorted( edges.size() );
+      for( typename EdgesType::const_iterator it=edges.begin(); it!=edges.end(); it++ )
+        {
+        sorted[ starts[ static_cast< unsigned long >( it->first - minimum ) ]++ ] = *it;
+        }
+      edges.swap( sorted );
+      return;
+      }
+    }
+
+  std::sort( edges.begin(), edges.end() );
+}
+
+
+template<class TInputImage, class TOutputImage, class TDissimilarity, class TAccumulator>
+void
+ImageToAlphaTreeFilter<TInputImage, TOutputImage, TDissimilarity, TAccumulator>
+::ComputeNeighbors( OffsetValueType * strides, std::vector< OffsetType > & neighbors,
+                    std::vector< OffsetValueType > & neighborOffsets ) const
+{
+  const typename InputImageRegionType::SizeType & size = this->GetInput()->GetRequestedRegion().GetSize();
+  strides[0] = 1;
+  for( unsigned int d=1; d<ImageDimension; d++ )
+    {
+    strides[d] = strides[d-1] * size[d-1];
+    }
+  unsigned long neighborhoodSize = 1;
+  for( unsigned int d=0; d<ImageDimension; d++ )
+    {
+    neighborhoodSize *= 3;
+    }
+  neighbors.clear();
+  neighborOffsets.clear();
+  for( unsigned long i=0; i<neighborhoodSize; i++ )
+    {
+    OffsetType o;
+    unsigned long r = i;
+    unsigned int nbOfNonZero = 0;
+    OffsetValueType offset = 0;
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      o[d] = static_cast< long >( r % 3 ) - 1;
+      r /= 3;
+      if( o[d] != 0 )
+        {
+        nbOfNonZero++;
+        }
+      offset += o[d] * strides[d];
+      }
+    // only the neighbors already visited in a raster scan
+    if( offset < 0 && ( m_FullyConnected || nbOfNonZero == 1 ) )
+      {
+      neighbors.push_back( o );
+      neighborOffsets.push_back( offset );
+      }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TDissimilarity, class TAccumulator>
+void
+ImageToAlphaTreeFilter<TInputImage, TOutputImage, TDissimilarity, TAccumulator>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FullyConnected: "  << m_FullyConnected << std::endl;
+  os << indent << "RunLengthEncoding: "  << m_RunLengthEncoding << std::endl;
+}
+
+}// end namespace itk
+#endif
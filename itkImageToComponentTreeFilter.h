@@ -18,6 +18,11 @@
 #define __itkImageToComponentTreeFilter_h
 
 #include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+#include "itkComponentTreeAccumulator.h"
+#include <string>
+#include <vector>
+#include <utility>
 
 namespace itk {
   
@@ -38,12 +43,85 @@ namespace itk {
 /** \class ImageToComponentTreeFilter
  * \brief The base class to convert an itk::Image to a itk::ComponentTree
  *
+ * Several algorithms are available, and can be chosen with SetAlgorithm():
+ * - UnionFind: the pixels are sorted by value in a map, and the nodes are
+ * merged with a union-find like algorithm.
+ * - Flooding: the image is flooded from a pixel, by following the
+ * pixels in a HierarchicalQueue, and the nodes are built with a stack of the
+ * components being flooded, as described by Salembier et al. and by
+ * Nister and Stewenius. There is no sort of the pixels, and the algorithm
+ * is not recursive. It is usually the fastest for the images with a small
+ * pixel type, like unsigned char or unsigned short, for which the
+ * HierarchicalQueue uses a vector of buckets.
+ * - RankTransform: the pixels are sorted with several threads, and their
+ * values are replaced by their rank in the sorted values. The tree is then
+ * built with a union-find on the pixels, as described by Berger et al.,
+ * which only compares the ranks. The pixel values are only used to set
+ * the value of the nodes. This algorithm is well suited for the floating
+ * point and 32 bits pixel types, with a lot of different values.
+ * - FlatZones: the flat zones, the connected components of pixels with the
+ * same value, are labeled first with a union-find in a raster scan. The
+ * tree is then built with the union-find of RankTransform on the adjacency
+ * graph of the zones rather than on the pixels, and the pixels are linked
+ * to the node of their zone at the end. This algorithm is much faster on
+ * the images with a few large flat zones, like the label images or the
+ * posterized images, but slower than the others on the noisy images. It is
+ * never chosen automatically.
+ * - Auto: the algorithm is chosen when the tree is built, from the pixel
+ * type, the size of the image and the number of threads. Flooding is used
+ * for the integer pixel types up to 16 bits, when the image has at least as
+ * many pixels as the pixel type has values, so the buckets of the queue are
+ * not more expensive than the image itself, and UnionFind for the smaller
+ * images. When several threads are available and the image is large enough
+ * to give a large part of the sort to each of them, RankTransform is used
+ * instead of Flooding, which is not threaded. RankTransform is used for the
+ * other pixel types. This is the default.
+ * The algorithm which will be used can be read with SelectAlgorithm() once
+ * the output information is known, and the algorithm actually used with
+ * GetSelectedAlgorithm() after the update of the filter.
+ *
+ * All the algorithms produce the same tree, but the children of a node may
+ * not be in the same order.
+ *
+ * The peak memory used by each algorithm can be estimated with
+ * EstimatePeakMemory(), once the output information is known. A memory
+ * budget can be set with SetMemoryBudget(): when the estimated memory of the
+ * selected algorithm exceeds the budget, the filter throws an exception
+ * before allocating anything, or, with the Fallback policy, uses the
+ * algorithm with the smallest estimate if it fits in the budget. The number
+ * of nodes is not known before building the tree, so it is estimated with
+ * SetEstimatedNodesPerPixel(). The default value, 1, is an upper bound.
+ *
+ * With RunLengthEncodingOn(), the output tree is run-length encoded once
+ * built. See ComponentTree::EncodeRunLength().
+ *
+ * SetMinimumSize() removes the nodes with less pixels than the minimum
+ * size, including their children, during the construction: their pixels
+ * are added to their parent. The output is the same as the one of
+ * AttributeFilteringComponentTreeFilter on the number of pixels of the
+ * nodes with the DIRECT, MAXIMUM or MINIMUM filtering types, but the removed
+ * nodes are never all in memory. Flooding deletes
+ * them as soon as they are complete, RankTransform and FlatZones don't
+ * create them, and UnionFind removes them after the construction.
+ *
+ * The pixels sorted by SortPixels() can be given to another filter with
+ * SetSortedPixels(), to build several trees with a single sort. See
+ * ImageToMaximumAndMinimumTreeFilter.
+ *
+ * The attributes which can be merged in constant time, like the number of
+ * pixels or the sum of the pixel values, can be computed while the tree is
+ * built, with the TAccumulator template parameter, rather than with a
+ * filter which visits all the pixels again. See NullComponentTreeAccumulator
+ * for the interface of the accumulators. UnionFind computes the attributes
+ * again after the construction when a minimum size is set.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
- * \sa ImageToMaximumTreeFilter ImageToMinimumTreeFilter ComponentTree
+ * \sa ImageToMaximumTreeFilter ImageToMinimumTreeFilter ComponentTree NullComponentTreeAccumulator
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
  */
-template<class TInputImage, class TOutputImage, class TCompare>
+template<class TInputImage, class TOutputImage, class TCompare,
+         class TAccumulator=Functor::NullComponentTreeAccumulator< typename TOutputImage::NodeType > >
 class ITK_EXPORT ImageToComponentTreeFilter : 
     public ImageToImageFilter<TInputImage, TOutputImage>
 {
@@ -69,6 +147,12 @@ public:
   typedef typename OutputImageType::NodeType       NodeType;
   typedef typename OutputImageType::AttributeType  AttributeType;
   typedef typename OutputImageType::IndexType      IndexType;
+  typedef typename InputImageType::OffsetType      OffsetType;
+  typedef typename InputImageType::OffsetValueType OffsetValueType;
+  typedef TAccumulator                             AccumulatorType;
+
+  typedef std::pair< InputImagePixelType, OffsetValueType > PixelOffsetPairType;
+  typedef std::vector< PixelOffsetPairType > PixelOffsetPairsType;
   
   /** ImageDimension constants */
   itkStaticConstMacro(ImageDimension, unsigned int,
@@ -91,6 +175,189 @@ public:
   itkGetConstReferenceMacro(FullyConnected, bool);
   itkBooleanMacro(FullyConnected);
 
+  /**
+   * Set/Get whether the output tree is run-length encoded. Default is
+   * RunLengthEncodingOff.
+   */
+  itkSetMacro(RunLengthEncoding, bool);
+  itkGetConstReferenceMacro(RunLengthEncoding, bool);
+  itkBooleanMacro(RunLengthEncoding);
+
+  /**
+   * Set/Get the minimum number of pixels of the nodes. The root is always
+   * kept. Default is 0.
+   */
+  itkSetMacro(MinimumSize, unsigned long);
+  itkGetConstReferenceMacro(MinimumSize, unsigned long);
+
+  static const int UNION_FIND=0;
+  static const int FLOODING=1;
+  static const int AUTO=2;
+  static const int RANK_TRANSFORM=3;
+  static const int FLAT_ZONES=4;
+
+  static int GetAlgorithmFromName( const std::string & s )
+    {
+    if( s == "UnionFind" )
+      {
+      return UNION_FIND;
+      }
+    else if( s == "Flooding" )
+      {
+      return FLOODING;
+      }
+    else if( s == "Auto" )
+      {
+      return AUTO;
+      }
+    else if( s == "RankTransform" )
+      {
+      return RANK_TRANSFORM;
+      }
+    else if( s == "FlatZones" )
+      {
+      return FLAT_ZONES;
+      }
+    // can't recognize the namespace
+    itkGenericExceptionMacro( << "Unknown algorithm." );
+    }
+
+  static std::string GetNameFromAlgorithm( const int & a )
+    {
+    switch( a )
+      {
+      case UNION_FIND:
+        return "UnionFind";
+        break;
+      case FLOODING:
+        return "Flooding";
+        break;
+      case AUTO:
+        return "Auto";
+        break;
+      case RANK_TRANSFORM:
+        return "RankTransform";
+        break;
+      case FLAT_ZONES:
+        return "FlatZones";
+        break;
+      }
+    // can't recognize the namespace
+    itkGenericExceptionMacro( << "Unknown algorithm." );
+    }
+
+  /** Set/Get the algorithm used to build the tree. Default is AUTO. */
+  itkGetMacro(Algorithm, int);
+
+  /** Get the algorithm used during the last update. It is never AUTO. */
+  itkGetMacro(SelectedAlgorithm, int);
+
+  void SetAlgorithm( std::string algorithm )
+    {
+    this->SetAlgorithm( GetAlgorithmFromName( algorithm ) );
+    }
+
+  void SetAlgorithm( const int & algorithm )
+    {
+    if( m_Algorithm != algorithm )
+      {
+      GetNameFromAlgorithm( algorithm ); // to validate the algorithm
+      m_Algorithm = algorithm;
+      this->Modified();
+      }
+    }
+
+  /** Set/Get the memory budget, in bytes. 0 means no budget. Default is 0. */
+  itkSetMacro(MemoryBudget, unsigned long);
+  itkGetConstReferenceMacro(MemoryBudget, unsigned long);
+
+  /** Set/Get the estimated number of nodes per pixel, used to estimate the
+   * memory used by the tree. Default is 1. */
+  itkSetClampMacro(EstimatedNodesPerPixel, double, 0.0, 1.0);
+  itkGetConstReferenceMacro(EstimatedNodesPerPixel, double);
+
+  static const int FAIL=0;
+  static const int FALLBACK=1;
+
+  static int GetMemoryBudgetPolicyFromName( const std::string & s )
+    {
+    if( s == "Fail" )
+      {
+      return FAIL;
+      }
+    else if( s == "Fallback" )
+      {
+      return FALLBACK;
+      }
+    // can't recognize the namespace
+    itkGenericExceptionMacro( << "Unknown memory budget policy." );
+    }
+
+  static std::string GetNameFromMemoryBudgetPolicy( const int & a )
+    {
+    switch( a )
+      {
+      case FAIL:
+        return "Fail";
+        break;
+      case FALLBACK:
+        return "Fallback";
+        break;
+      }
+    // can't recognize the namespace
+    itkGenericExceptionMacro( << "Unknown memory budget policy." );
+    }
+
+  /** Set/Get what to do when the memory budget would be exceeded. Default
+   * is FAIL. */
+  itkGetMacro(MemoryBudgetPolicy, int);
+
+  void SetMemoryBudgetPolicy( std::string policy )
+    {
+    this->SetMemoryBudgetPolicy( GetMemoryBudgetPolicyFromName( policy ) );
+    }
+
+  void SetMemoryBudgetPolicy( const int & policy )
+    {
+    if( m_MemoryBudgetPolicy != policy )
+      {
+      GetNameFromMemoryBudgetPolicy( policy ); // to validate the policy
+      m_MemoryBudgetPolicy = policy;
+      this->Modified();
+      }
+    }
+
+  /** Return the algorithm which will be used to build the tree, before the
+   * memory budget is applied. It is the algorithm set, or the one chosen
+   * for the input and the number of threads when the algorithm is AUTO. The
+   * output information must be up to date. */
+  virtual int SelectAlgorithm() const;
+
+  /** Estimate the peak memory, in bytes, used to build the tree with an
+   * algorithm, including the tree itself. The output information must be
+   * up to date. */
+  unsigned long EstimatePeakMemory( int algorithm ) const;
+
+  /** Get the estimated peak memory of the algorithm used during the last
+   * update. */
+  itkGetConstReferenceMacro(EstimatedPeakMemory, unsigned long);
+
+  /** Sort the pixels of the buffered region of an image, in the order of
+   * the comparator, with several threads. */
+  void SortPixels( const InputImageType * image, PixelOffsetPairsType & pairs );
+
+  /** Build the next tree from pixels already sorted in the order of the
+   * comparator, for example with SortPixels(), rather than sorting them
+   * again. The filter takes the content of pairs, which is empty on return,
+   * and releases it once the tree is built. The RankTransform algorithm is
+   * used, whatever the algorithm set. */
+  void SetSortedPixels( PixelOffsetPairsType & pairs )
+    {
+    m_SortedPixels.swap( pairs );
+    PixelOffsetPairsType().swap( pairs );
+    this->Modified();
+    }
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
 /*  itkConceptMacro(InputEqualityComparableCheck,
@@ -118,6 +385,106 @@ protected:
   /** Single-threaded version of GenerateData.  This filter delegates
    * to GrayscaleGeodesicErodeImageFilter. */
   void GenerateData();
+
+  /** Change the selected algorithm, or throw an exception, according to
+   * the memory budget */
+  void ApplyMemoryBudget();
+
+  /** Build the tree with the union-find like algorithm */
+  void UnionFindGenerateData();
+
+  /** Build the tree by flooding the image */
+  void FloodingGenerateData();
+
+  /** Build the tree with a union-find on the ranks of the pixels */
+  void RankTransformGenerateData();
+
+  /** Build the tree with a union-find on the adjacency graph of the flat
+   * zones */
+  void FlatZonesGenerateData();
+
+  typedef std::vector< InputImagePixelType > LevelsType;
+
+  /** Order the pixels with the comparator, and with their offset for the
+   * pixels with the same value */
+  class PixelOffsetPairCompare
+    {
+    public:
+    inline bool operator()( const PixelOffsetPairType & a, const PixelOffsetPairType & b ) const
+      {
+      if( m_Compare( a.first, b.first ) )
+        {
+        return true;
+        }
+      if( m_Compare( b.first, a.first ) )
+        {
+        return false;
+        }
+      return a.second < b.second;
+      }
+    TCompare m_Compare;
+    };
+
+  /** Build the tree from the sorted pixels and the sorted values. TRank
+   * must be able to store the number of values. */
+  template<class TRank>
+  void RankUnionFind( PixelOffsetPairsType & pairs, const LevelsType & levels );
+
+  /** Build the tree from the sorted zones and the sorted values. The
+   * neighbors of the zone z are the zones adjacency[adjacencyStart[z]] to
+   * adjacency[adjacencyStart[z+1]-1], and labels is the zone of each
+   * pixel. */
+  template<class TRank>
+  void ZoneUnionFind( PixelOffsetPairsType & pairs, const LevelsType & levels,
+                      const std::vector< OffsetValueType > & labels,
+                      const std::vector< OffsetValueType > & adjacencyStart,
+                      const std::vector< OffsetValueType > & adjacency );
+
+  /** Sort the pixels with several threads: a chunk is sorted by each
+   * thread, then the chunks are merged */
+  void ThreadedSort( PixelOffsetPairsType & pairs );
+
+  void ThreadedSortChunk( int threadId, int numberOfThreads );
+
+  static ITK_THREAD_RETURN_TYPE SortThreaderCallback( void * arg );
+
+  /** Compute the strides of the input buffer, and the neighbors of a pixel
+   * with the current connectivity */
+  void ComputeNeighbors( OffsetValueType * strides, std::vector< OffsetType > & neighbors,
+                         std::vector< OffsetValueType > & neighborOffsets ) const;
+
+  /** Compute the index of a pixel from its offset, and return true if some of
+   * its neighbors may be out of the image */
+  inline bool ComputeIndexOnBorder( OffsetValueType offset, const OffsetValueType * strides,
+                                    const typename InputImageRegionType::SizeType & size, IndexType & idx ) const
+    {
+    bool border = false;
+    for( int d=ImageDimension-1; d>=0; d-- )
+      {
+      idx[d] = offset / strides[d];
+      offset -= idx[d] * strides[d];
+      if( idx[d] == 0 || idx[d] == static_cast< long >( size[d] ) - 1 )
+        {
+        border = true;
+        }
+      }
+    return border;
+    }
+
+  /** Return true if the neighbor of the pixel at idx is in the image */
+  inline bool IsNeighborInside( const IndexType & idx, const OffsetType & neighbor,
+                                const typename InputImageRegionType::SizeType & size ) const
+    {
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      const long c = idx[d] + neighbor[d];
+      if( c < 0 || c >= static_cast< long >( size[d] ) )
+        {
+        return false;
+        }
+      }
+    return true;
+    }
   
   /** Merge node2 in node1 without setting the parent. This operation is
     * performed in constant time
@@ -127,6 +494,18 @@ protected:
   /** Set the parent of all the nodes of the tree */
   void SetChildrenParent( NodeType* node );
 
+  /** Add a complete component to its parent, or merge it in its parent if
+   * it is smaller than the minimum size */
+  void AddComponent( NodeType * parent, NodeType * child, unsigned long childSize );
+
+  /** Merge the children smaller than the minimum size in their parent,
+   * and return the number of pixels of the node and its children */
+  unsigned long RemoveSmallNodes( NodeType * node );
+
+  /** Compute the attributes of a node and its children with the
+   * accumulator */
+  void AccumulateAttributes( NodeType * node );
+
   /** return the ancestor (deepest parent) of a node and perform path
    *  compression on all the node on the path
    */
@@ -140,6 +519,23 @@ private:
   void operator=(const Self&); //purposely not implemented
 
   bool                m_FullyConnected;
+  bool                m_RunLengthEncoding;
+  unsigned long       m_MinimumSize;
+  int                 m_Algorithm;
+  int                 m_SelectedAlgorithm;
+
+  unsigned long       m_MemoryBudget;
+  double              m_EstimatedNodesPerPixel;
+  int                 m_MemoryBudgetPolicy;
+  unsigned long       m_EstimatedPeakMemory;
+
+  // the pixels given with SetSortedPixels()
+  PixelOffsetPairsType m_SortedPixels;
+
+  // the data shared by the threads during the sort
+  PixelOffsetPairsType * m_SortPairs;
+  std::vector< unsigned long > m_SortBounds;
+  int                 m_SortWidth;
 } ; // end of class
 
 } // end namespace itk
@@ -30,19 +30,32 @@
 #include "itkShapedNeighborhoodIterator.h"
 #include "itkConstantBoundaryConditionWithoutDefault.h"
 #include "itkProgressReporter.h"
+#include "itkHierarchicalQueue.h"
+#include <vector>
+#include <limits>
 
 namespace itk {
 
-template <class TInputImage, class TOutputImage, class TCompare>
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+template <class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::ImageToComponentTreeFilter()
 {
   m_FullyConnected = false;
+  m_RunLengthEncoding = false;
+  m_MinimumSize = 0;
+  m_Algorithm = AUTO;
+  m_SelectedAlgorithm = UNION_FIND;
+  m_MemoryBudget = 0;
+  m_EstimatedNodesPerPixel = 1.0;
+  m_MemoryBudgetPolicy = FAIL;
+  m_EstimatedPeakMemory = 0;
+  m_SortPairs = NULL;
+  m_SortWidth = 0;
 }
 
-template <class TInputImage, class TOutputImage, class TCompare>
+template <class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
 void 
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::GenerateInputRequestedRegion()
 {
   // call the superclass' implementation of this method
@@ -58,9 +71,9 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
 }
 
 
-template <class TInputImage, class TOutputImage, class TCompare>
+template <class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
 void 
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::EnlargeOutputRequestedRegion(DataObject *)
 {
   this->GetOutput()
@@ -68,17 +81,249 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
 }
 
 
-template<class TInputImage, class TOutputImage, class TCompare>
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
 void
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::GenerateData()
 {
+  // choose the algorithm before allocating anything, to fail fast if
+  // the memory budget is exceeded. The pixels already sorted can only be
+  // used by RankTransform.
+  if( !m_SortedPixels.empty() )
+    {
+    m_SelectedAlgorithm = RANK_TRANSFORM;
+    }
+  else
+    {
+    m_SelectedAlgorithm = this->SelectAlgorithm();
+    this->ApplyMemoryBudget();
+    }
+  m_EstimatedPeakMemory = this->EstimatePeakMemory( m_SelectedAlgorithm );
+  itkDebugMacro( << "Building the tree with the " << GetNameFromAlgorithm( m_SelectedAlgorithm )
+                 << " algorithm. Estimated peak memory: " << m_EstimatedPeakMemory << " bytes." );
+
   // Allocate the output
   this->AllocateOutputs();
+
+  if( m_SelectedAlgorithm == FLOODING )
+    {
+    this->FloodingGenerateData();
+    }
+  else if( m_SelectedAlgorithm == RANK_TRANSFORM )
+    {
+    this->RankTransformGenerateData();
+    }
+  else if( m_SelectedAlgorithm == FLAT_ZONES )
+    {
+    this->FlatZonesGenerateData();
+    }
+  else
+    {
+    this->UnionFindGenerateData();
+    if( m_MinimumSize > 0 )
+      {
+      this->RemoveSmallNodes( this->GetOutput()->GetRoot() );
+      if( AccumulatorType::Active )
+        {
+        // the pixels of the removed nodes now have the value of their new
+        // node
+        this->AccumulateAttributes( this->GetOutput()->GetRoot() );
+        }
+      }
+    }
+
+  if( m_RunLengthEncoding )
+    {
+    this->GetOutput()->EncodeRunLength();
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+int
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::SelectAlgorithm() const
+{
+  if( m_Algorithm != AUTO )
+    {
+    return m_Algorithm;
+    }
+
+  typedef std::numeric_limits< InputImagePixelType > LimitsType;
+  if( LimitsType::is_integer && LimitsType::digits <= 16 )
+    {
+    // the queue has a bucket per possible pixel value
+    const unsigned long numberOfLevels = 1UL << ( LimitsType::digits + ( LimitsType::is_signed ? 1 : 0 ) );
+    const unsigned long numberOfPixels = this->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+    if( numberOfPixels >= numberOfLevels )
+      {
+      // flooding is linear but not threaded. The sort of RankTransform is
+      // worth it only when each thread has a large chunk to sort.
+      const unsigned long minimumPixelsPerThread = 65536;
+      const unsigned long numberOfThreads = this->GetNumberOfThreads();
+      if( numberOfThreads > 1 && numberOfPixels / numberOfThreads >= minimumPixelsPerThread )
+        {
+        return RANK_TRANSFORM;
+        }
+      return FLOODING;
+      }
+    }
+  else
+    {
+    // too many possible values for the queue, and for the map of the
+    // union-find algorithm
+    return RANK_TRANSFORM;
+    }
+  return UNION_FIND;
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+unsigned long
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::EstimatePeakMemory( int algorithm ) const
+{
+  if( algorithm == AUTO )
+    {
+    algorithm = this->SelectAlgorithm();
+    }
+
+  const double numberOfPixels = this->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+  const double offsetSize = sizeof( OffsetValueType );
+  const double pointerSize = sizeof( void * );
+
+  // the number of different values in the image can't be greater than the
+  // number of possible values, or than the number of pixels
+  typedef std::numeric_limits< InputImagePixelType > LimitsType;
+  const bool smallInteger = LimitsType::is_integer && LimitsType::digits <= 16;
+  double numberOfLevels = numberOfPixels;
+  if( smallInteger )
+    {
+    numberOfLevels = std::min( numberOfLevels, static_cast< double >( 1UL << ( LimitsType::digits + ( LimitsType::is_signed ? 1 : 0 ) ) ) );
+    }
+
+  // the tree itself: the linked list array and the nodes
+  const double numberOfNodes = numberOfPixels * m_EstimatedNodesPerPixel;
+  const double tree = numberOfPixels * offsetSize + numberOfNodes * OutputImageType::GetNodeMemorySize();
+
+  const double rankSize = smallInteger ? sizeof( unsigned short ) : sizeof( unsigned long );
+
+  double peak = tree;
+  if( algorithm == UNION_FIND )
+    {
+    // the map of the offsets by value, with a deque per value, and the
+    // image of the nodes
+    const double mapEntry = 4 * pointerSize + sizeof( InputImagePixelType ) + sizeof( std::deque< OffsetValueType > ) + 512;
+    peak += numberOfPixels * offsetSize + numberOfLevels * mapEntry + numberOfPixels * pointerSize;
+    }
+  else if( algorithm == FLOODING )
+    {
+    // the accessible flags, the queue and the stack of the components
+    double queue = numberOfPixels * offsetSize;
+    if( smallInteger )
+      {
+      queue += numberOfLevels * ( sizeof( std::vector< OffsetValueType > ) + sizeof( unsigned long ) );
+      }
+    else
+      {
+      // the radix heap stores the key and its code with the values
+      queue += numberOfPixels * ( sizeof( InputImagePixelType ) + sizeof( unsigned long long ) );
+      }
+    peak += numberOfPixels / 8 + queue + numberOfNodes * pointerSize;
+    }
+  else if( algorithm == RANK_TRANSFORM )
+    {
+    // the ranks and the order are used during the whole construction, with
+    // the sorted pairs, then with the union-find arrays, then with the image
+    // of the nodes
+    const double common = numberOfPixels * ( rankSize + offsetSize );
+    const double sortPhase = numberOfPixels * sizeof( PixelOffsetPairType );
+    const double unionFindPhase = numberOfPixels * 2 * offsetSize;
+    const double nodesPhase = numberOfPixels * ( offsetSize + pointerSize );
+    peak += common + std::max( sortPhase, std::max( unionFindPhase, nodesPhase ) );
+    }
+  else if( algorithm == FLAT_ZONES )
+    {
+    // the labels of the pixels, the adjacency graph and the union-find on
+    // the zones. There are at least as many zones as nodes, and the number
+    // of edges of the graph is estimated from the number of neighbors.
+    unsigned long numberOfNeighbors = 2 * ImageDimension;
+    if( m_FullyConnected )
+      {
+      numberOfNeighbors = 1;
+      for( unsigned int d=0; d<ImageDimension; d++ )
+        {
+        numberOfNeighbors *= 3;
+        }
+      numberOfNeighbors--;
+      }
+    const double numberOfZones = numberOfNodes;
+    const double numberOfEdges = numberOfZones * numberOfNeighbors / 2;
+    const double graph = numberOfEdges * 4 * offsetSize + numberOfZones * offsetSize;
+    const double unionFind = numberOfZones * ( sizeof( PixelOffsetPairType ) + rankSize + 3 * offsetSize + pointerSize );
+    peak += numberOfPixels * offsetSize + graph + unionFind;
+    }
+
+  return static_cast< unsigned long >( peak );
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::ApplyMemoryBudget()
+{
+  if( m_MemoryBudget == 0 )
+    {
+    return;
+    }
+
+  const unsigned long estimate = this->EstimatePeakMemory( m_SelectedAlgorithm );
+  if( estimate <= m_MemoryBudget )
+    {
+    return;
+    }
+
+  if( m_MemoryBudgetPolicy == FALLBACK )
+    {
+    // use the leanest algorithm
+    const int algorithms[] = { UNION_FIND, FLOODING, RANK_TRANSFORM };
+    int leanest = m_SelectedAlgorithm;
+    unsigned long leanestEstimate = estimate;
+    for( unsigned int i=0; i<sizeof( algorithms ) / sizeof( int ); i++ )
+      {
+      const unsigned long e = this->EstimatePeakMemory( algorithms[i] );
+      if( e < leanestEstimate )
+        {
+        leanest = algorithms[i];
+        leanestEstimate = e;
+        }
+      }
+    if( leanestEstimate <= m_MemoryBudget )
+      {
+      itkDebugMacro( << "The " << GetNameFromAlgorithm( m_SelectedAlgorithm ) << " algorithm would need "
+                     << estimate << " bytes. Falling back to the " << GetNameFromAlgorithm( leanest ) << " algorithm." );
+      m_SelectedAlgorithm = leanest;
+      return;
+      }
+    }
+
+  itkExceptionMacro( << "The " << GetNameFromAlgorithm( m_SelectedAlgorithm ) << " algorithm would need about "
+                     << estimate << " bytes, which exceeds the memory budget of " << m_MemoryBudget << " bytes." );
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::UnionFindGenerateData()
+{
   OutputImageType * output = this->GetOutput();
 
   // instantiate the comparator
   TCompare compare;
+  AccumulatorType accumulator;
+  accumulator.SetComponentTree( output );
   
   // setup the progress reporter
   ProgressReporter progress(this, 0, this->GetInput()->GetRequestedRegion().GetNumberOfPixels()*2);
@@ -172,6 +417,10 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
           if( n == NULL )
             {
             output->NodeAddIndex( nn, iIt.GetIndex() );
+            if( AccumulatorType::Active )
+              {
+              accumulator.AddPixel( nn, *idxIt );
+              }
             n = nn;
             }
           else
@@ -190,6 +439,11 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
         n = new NodeType();
         n->SetPixel( p );
         output->NodeAddIndex( n, iIt.GetIndex() );
+        if( AccumulatorType::Active )
+          {
+          accumulator.Initialize( n );
+          accumulator.AddPixel( n, *idxIt );
+          }
         }
 
       nIt.SetCenterPixel( n );
@@ -211,6 +465,11 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
             assert( compare( nn->GetPixel(), n->GetPixel() ) || nn->GetPixel() == n->GetPixel() );
             assert( !n->HasChild( nn ) );
             n->AddChild( nn );
+            if( AccumulatorType::Active )
+              {
+              // all the pixels of nn and of its children have been processed
+              accumulator.Merge( n, nn );
+              }
             }
           else if( nn != n )
             {
@@ -255,9 +514,997 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
 }
 
 
-template<class TInputImage, class TOutputImage, class TCompare>
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::FloodingGenerateData()
+{
+  OutputImageType * output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+
+  // the comparator gives the order of the flooding: the pixels which come
+  // first are the deepest in the tree
+  TCompare compare;
+  AccumulatorType accumulator;
+  accumulator.SetComponentTree( output );
+
+  const InputImageRegionType & region = input->GetRequestedRegion();
+  const typename InputImageRegionType::SizeType & size = region.GetSize();
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+  const InputImagePixelType * buffer = input->GetBufferPointer();
+
+  ProgressReporter progress(this, 0, numberOfPixels);
+
+  // the offsets of the neighbors in the buffer, and their position in the
+  // neighborhood to check the borders of the image
+  OffsetValueType strides[ImageDimension];
+  std::vector< OffsetType > neighbors;
+  std::vector< OffsetValueType > neighborOffsets;
+  this->ComputeNeighbors( strides, neighbors, neighborOffsets );
+  const unsigned int numberOfNeighbors = neighbors.size();
+
+  // a pixel is accessible once it has been put in the queue or in a
+  // component
+  std::vector< bool > accessible( numberOfPixels, false );
+
+  typedef HierarchicalQueue< InputImagePixelType, OffsetValueType, TCompare > QueueType;
+  QueueType queue;
+
+  // the components being flooded, from the highest in the tree to the deepest,
+  // and their number of pixels
+  typedef std::vector< NodeType * > ComponentStackType;
+  ComponentStackType stack;
+  std::vector< unsigned long > sizes;
+
+  // start from the first pixel
+  OffsetValueType current = 0;
+  accessible[ current ] = true;
+  NodeType * node = new NodeType();
+  node->SetPixel( buffer[ current ] );
+  if( AccumulatorType::Active )
+    {
+    accumulator.Initialize( node );
+    }
+  stack.push_back( node );
+  sizes.push_back( 0 );
+
+  IndexType idx;
+  while( true )
+    {
+    const InputImagePixelType currentValue = buffer[ current ];
+
+    const bool border = this->ComputeIndexOnBorder( current, strides, size, idx );
+
+    // search a neighbor deeper than the current pixel
+    bool deeper = false;
+    for( unsigned int i=0; i<numberOfNeighbors; i++ )
+      {
+      if( border && !this->IsNeighborInside( idx, neighbors[i], size ) )
+        {
+        continue;
+        }
+
+      const OffsetValueType n = current + neighborOffsets[i];
+      if( accessible[ n ] )
+        {
+        continue;
+        }
+      accessible[ n ] = true;
+
+      const InputImagePixelType & nValue = buffer[ n ];
+      if( compare( nValue, currentValue ) )
+        {
+        // flood the neighbor first. The current pixel will be visited again
+        // to explore its other neighbors
+        queue.Push( currentValue, current );
+        current = n;
+        node = new NodeType();
+        node->SetPixel( nValue );
+        if( AccumulatorType::Active )
+          {
+          accumulator.Initialize( node );
+          }
+        stack.push_back( node );
+        sizes.push_back( 0 );
+        deeper = true;
+        break;
+        }
+      queue.Push( nValue, n );
+      }
+
+    if( deeper )
+      {
+      continue;
+      }
+
+    // all the neighbors have been explored: the pixel is in the deepest
+    // component
+    output->NodeAddIndex( stack.back(), current );
+    if( AccumulatorType::Active )
+      {
+      accumulator.AddPixel( stack.back(), current );
+      }
+    sizes.back()++;
+    progress.CompletedPixel();
+
+    if( queue.Empty() )
+      {
+      break;
+      }
+
+    current = queue.FrontValue();
+    const InputImagePixelType nextValue = queue.FrontKey();
+    queue.Pop();
+
+    if( nextValue != stack.back()->GetPixel() )
+      {
+      // the next pixel is higher in the tree: the deeper components are
+      // complete, and are added to their parent
+      assert( compare( stack.back()->GetPixel(), nextValue ) );
+      while( true )
+        {
+        NodeType * top = stack.back();
+        const unsigned long topSize = sizes.back();
+        stack.pop_back();
+        sizes.pop_back();
+        if( stack.empty() || compare( nextValue, stack.back()->GetPixel() ) )
+          {
+          // there is no component at that level yet
+          node = new NodeType();
+          node->SetPixel( nextValue );
+          if( AccumulatorType::Active )
+            {
+            accumulator.Initialize( node );
+            }
+          this->AddComponent( node, top, topSize );
+          stack.push_back( node );
+          sizes.push_back( topSize );
+          break;
+          }
+        this->AddComponent( stack.back(), top, topSize );
+        sizes.back() += topSize;
+        if( stack.back()->GetPixel() == nextValue )
+          {
+          break;
+          }
+        }
+      }
+    }
+
+  // all the pixels have been flooded: the remaining components are nested
+  while( stack.size() > 1 )
+    {
+    NodeType * top = stack.back();
+    const unsigned long topSize = sizes.back();
+    stack.pop_back();
+    sizes.pop_back();
+    this->AddComponent( stack.back(), top, topSize );
+    sizes.back() += topSize;
+    }
+
+  NodeType * root = stack.back();
+  assert( output->NodeCountIndexes( root ) == numberOfPixels );
+
+  // to be sure that root parent is NULL
+  root->SetParent( NULL );
+
+  // keep a pointer on the root node
+  output->SetRoot( root );
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::RankTransformGenerateData()
+{
+  const InputImageType * input = this->GetInput();
+  const unsigned long numberOfPixels = input->GetRequestedRegion().GetNumberOfPixels();
+
+  // sort the pixels, the deepest first, or use the ones already sorted
+  PixelOffsetPairsType pairs;
+  if( !m_SortedPixels.empty() )
+    {
+    pairs.swap( m_SortedPixels );
+    if( pairs.size() != numberOfPixels )
+      {
+      itkExceptionMacro( << "The number of sorted pixels doesn't match the size of the input." );
+      }
+    }
+  else
+    {
+    this->SortPixels( input, pairs );
+    }
+
+  // the pixel values, indexed by rank
+  LevelsType levels;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    if( levels.empty() || levels.back() != pairs[i].first )
+      {
+      levels.push_back( pairs[i].first );
+      }
+    }
+
+  // use the smallest type which can store the ranks
+  if( levels.size() <= static_cast< unsigned long >( NumericTraits< unsigned short >::max() ) + 1 )
+    {
+    this->template RankUnionFind< unsigned short >( pairs, levels );
+    }
+  else
+    {
+    this->template RankUnionFind< unsigned long >( pairs, levels );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+template<class TRank>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::RankUnionFind( PixelOffsetPairsType & pairs, const LevelsType & levels )
+{
+  OutputImageType * output = this->GetOutput();
+  const InputImageRegionType & region = this->GetInput()->GetRequestedRegion();
+  const typename InputImageRegionType::SizeType & size = region.GetSize();
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+
+  ProgressReporter progress(this, 0, numberOfPixels * 2);
+
+  // replace the values by their rank, and keep the order of the pixels
+  std::vector< TRank > ranks( numberOfPixels );
+  std::vector< OffsetValueType > order( numberOfPixels );
+  TRank rank = 0;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    if( pairs[i].first != levels[ rank ] )
+      {
+      rank++;
+      }
+    ranks[ pairs[i].second ] = rank;
+    order[i] = pairs[i].second;
+    }
+  PixelOffsetPairsType().swap( pairs );
+
+  OffsetValueType strides[ImageDimension];
+  std::vector< OffsetType > neighbors;
+  std::vector< OffsetValueType > neighborOffsets;
+  this->ComputeNeighbors( strides, neighbors, neighborOffsets );
+  const unsigned int numberOfNeighbors = neighbors.size();
+
+  // union-find from the deepest pixels. zpar is the union-find structure,
+  // with path compression, and parent the tree of the pixels.
+  std::vector< OffsetValueType > parent( numberOfPixels );
+  std::vector< OffsetValueType > zpar( numberOfPixels, -1 );
+  IndexType idx;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    const OffsetValueType p = order[i];
+    parent[p] = p;
+    zpar[p] = p;
+    const bool border = this->ComputeIndexOnBorder( p, strides, size, idx );
+    for( unsigned int j=0; j<numberOfNeighbors; j++ )
+      {
+      if( border && !this->IsNeighborInside( idx, neighbors[j], size ) )
+        {
+        continue;
+        }
+      const OffsetValueType n = p + neighborOffsets[j];
+      if( zpar[n] == -1 )
+        {
+        // not processed yet
+        continue;
+        }
+      // find the root of n, with path halving
+      OffsetValueType r = n;
+      while( zpar[r] != r )
+        {
+        zpar[r] = zpar[ zpar[r] ];
+        r = zpar[r];
+        }
+      if( r != p )
+        {
+        parent[r] = p;
+        zpar[r] = p;
+        }
+      }
+    progress.CompletedPixel();
+    }
+
+  // make the parent of each pixel the canonical pixel of its node: the root
+  // of the union-find for its level component, which is the last pixel of
+  // the component processed above
+  for( long i=numberOfPixels-1; i>=0; i-- )
+    {
+    const OffsetValueType p = order[i];
+    const OffsetValueType q = parent[p];
+    if( ranks[ parent[q] ] == ranks[q] )
+      {
+      parent[p] = parent[q];
+      }
+    }
+
+  // the number of pixels of the node of each canonical pixel, computed in
+  // zpar which is not used anymore. The parent of a pixel is always
+  // processed after it.
+  std::vector< OffsetValueType > & sizes = zpar;
+  if( m_MinimumSize > 0 )
+    {
+    std::fill( sizes.begin(), sizes.end(), 1 );
+    for( unsigned long i=0; i<numberOfPixels; i++ )
+      {
+      const OffsetValueType p = order[i];
+      if( parent[p] != p )
+        {
+        sizes[ parent[p] ] += sizes[p];
+        }
+      }
+    }
+  else
+    {
+    std::vector< OffsetValueType >().swap( zpar );
+    }
+
+  // create the nodes, from the root to the leaves, so the node of the
+  // parent already exists
+  AccumulatorType accumulator;
+  accumulator.SetComponentTree( output );
+  std::vector< NodeType * > nodes( numberOfPixels, NULL );
+  const OffsetValueType rootOffset = order[ numberOfPixels - 1 ];
+  for( long i=numberOfPixels-1; i>=0; i-- )
+    {
+    const OffsetValueType p = order[i];
+    const OffsetValueType q = parent[p];
+    NodeType * node;
+    if( m_MinimumSize > 0 && p != q && ranks[p] != ranks[q]
+        && static_cast< unsigned long >( sizes[p] ) < m_MinimumSize )
+      {
+      // the node is too small: its pixels go to the node of its parent
+      assert( nodes[q] != NULL );
+      node = nodes[q];
+      nodes[p] = node;
+      }
+    else if( p == q || ranks[p] != ranks[q] )
+      {
+      // p is a canonical pixel
+      node = new NodeType();
+      node->SetPixel( levels[ ranks[p] ] );
+      if( AccumulatorType::Active )
+        {
+        accumulator.Initialize( node );
+        }
+      if( p != q )
+        {
+        assert( nodes[q] != NULL );
+        nodes[q]->AddChild( node );
+        }
+      nodes[p] = node;
+      }
+    else
+      {
+      assert( nodes[q] != NULL );
+      node = nodes[q];
+      }
+    output->NodeAddIndex( node, p );
+    if( AccumulatorType::Active )
+      {
+      accumulator.AddPixel( node, p );
+      }
+    progress.CompletedPixel();
+    }
+
+  if( AccumulatorType::Active )
+    {
+    // merge the attributes of the nodes in their parent, from the deepest
+    // nodes, so the attributes are complete when they are merged
+    for( unsigned long i=0; i<numberOfPixels; i++ )
+      {
+      const OffsetValueType p = order[i];
+      const OffsetValueType q = parent[p];
+      if( ranks[p] != ranks[q] && nodes[p] != nodes[q] )
+        {
+        accumulator.Merge( nodes[q], nodes[p] );
+        }
+      }
+    }
+
+  NodeType * root = nodes[ rootOffset ];
+  assert( root != NULL );
+  assert( output->NodeCountIndexes( root ) == numberOfPixels );
+
+  // to be sure that root parent is NULL
+  root->SetParent( NULL );
+
+  // keep a pointer on the root node
+  output->SetRoot( root );
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::FlatZonesGenerateData()
+{
+  const InputImageType * input = this->GetInput();
+  const InputImageRegionType & region = input->GetRequestedRegion();
+  const typename InputImageRegionType::SizeType & size = region.GetSize();
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+  const InputImagePixelType * buffer = input->GetBufferPointer();
+
+  OffsetValueType strides[ImageDimension];
+  std::vector< OffsetType > allNeighbors;
+  std::vector< OffsetValueType > allNeighborOffsets;
+  this->ComputeNeighbors( strides, allNeighbors, allNeighborOffsets );
+
+  // only the neighbors already visited in a raster scan are needed
+  std::vector< OffsetType > neighbors;
+  std::vector< OffsetValueType > neighborOffsets;
+  for( unsigned int j=0; j<allNeighbors.size(); j++ )
+    {
+    if( allNeighborOffsets[j] < 0 )
+      {
+      neighbors.push_back( allNeighbors[j] );
+      neighborOffsets.push_back( allNeighborOffsets[j] );
+      }
+    }
+  const unsigned int numberOfNeighbors = neighbors.size();
+
+  // label the flat zones with a union-find on the pixels. The root of a
+  // zone is always its first pixel in the raster order, so the parent of a
+  // pixel is always before it.
+  std::vector< OffsetValueType > labels( numberOfPixels );
+  IndexType idx;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    const OffsetValueType p = i;
+    labels[p] = p;
+    const bool border = this->ComputeIndexOnBorder( p, strides, size, idx );
+    for( unsigned int j=0; j<numberOfNeighbors; j++ )
+      {
+      if( border && !this->IsNeighborInside( idx, neighbors[j], size ) )
+        {
+        continue;
+        }
+      const OffsetValueType n = p + neighborOffsets[j];
+      if( buffer[n] != buffer[p] )
+        {
+        continue;
+        }
+      // find the roots, with path halving
+      OffsetValueType r1 = n;
+      while( labels[r1] != r1 )
+        {
+        labels[r1] = labels[ labels[r1] ];
+        r1 = labels[r1];
+        }
+      OffsetValueType r2 = p;
+      while( labels[r2] != r2 )
+        {
+        labels[r2] = labels[ labels[r2] ];
+        r2 = labels[r2];
+        }
+      if( r1 < r2 )
+        {
+        labels[r2] = r1;
+        }
+      else if( r2 < r1 )
+        {
+        labels[r1] = r2;
+        }
+      }
+    }
+
+  // replace the roots by consecutive labels, and keep the value of the zones
+  // in the pairs to sort
+  PixelOffsetPairsType pairs;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    if( labels[i] == static_cast< OffsetValueType >( i ) )
+      {
+      labels[i] = pairs.size();
+      pairs.push_back( PixelOffsetPairType( buffer[i], labels[i] ) );
+      }
+    else
+      {
+      labels[i] = labels[ labels[i] ];
+      }
+    }
+  const unsigned long numberOfZones = pairs.size();
+
+  // the edges of the adjacency graph of the zones. The duplicated edges are
+  // mostly found along the lines, so the last one is checked before the
+  // sort.
+  typedef std::pair< OffsetValueType, OffsetValueType > EdgeType;
+  std::vector< EdgeType > edges;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    const OffsetValueType p = i;
+    const OffsetValueType lp = labels[p];
+    const bool border = this->ComputeIndexOnBorder( p, strides, size, idx );
+    for( unsigned int j=0; j<numberOfNeighbors; j++ )
+      {
+      if( border && !this->IsNeighborInside( idx, neighbors[j], size ) )
+        {
+        continue;
+        }
+      const OffsetValueType ln = labels[ p + neighborOffsets[j] ];
+      if( ln == lp )
+        {
+        continue;
+        }
+      const EdgeType edge( std::min( lp, ln ), std::max( lp, ln ) );
+      if( edges.empty() || edges.back() != edge )
+        {
+        edges.push_back( edge );
+        }
+      }
+    }
+  std::sort( edges.begin(), edges.end() );
+  edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+  // store the graph in the compressed sparse row format
+  std::vector< OffsetValueType > adjacencyStart( numberOfZones + 1, 0 );
+  for( typename std::vector< EdgeType >::const_iterator it=edges.begin(); it!=edges.end(); it++ )
+    {
+    adjacencyStart[ it->first + 1 ]++;
+    adjacencyStart[ it->second + 1 ]++;
+    }
+  for( unsigned long z=0; z<numberOfZones; z++ )
+    {
+    adjacencyStart[ z + 1 ] += adjacencyStart[ z ];
+    }
+  std::vector< OffsetValueType > adjacency( adjacencyStart[ numberOfZones ] );
+  std::vector< OffsetValueType > position( adjacencyStart.begin(), adjacencyStart.end() - 1 );
+  for( typename std::vector< EdgeType >::const_iterator it=edges.begin(); it!=edges.end(); it++ )
+    {
+    adjacency[ position[ it->first ]++ ] = it->second;
+    adjacency[ position[ it->second ]++ ] = it->first;
+    }
+  std::vector< EdgeType >().swap( edges );
+  std::vector< OffsetValueType >().swap( position );
+
+  // sort the zones, the deepest first
+  this->ThreadedSort( pairs );
+
+  LevelsType levels;
+  for( unsigned long i=0; i<numberOfZones; i++ )
+    {
+    if( levels.empty() || levels.back() != pairs[i].first )
+      {
+      levels.push_back( pairs[i].first );
+      }
+    }
+
+  if( levels.size() <= static_cast< unsigned long >( NumericTraits< unsigned short >::max() ) + 1 )
+    {
+    this->template ZoneUnionFind< unsigned short >( pairs, levels, labels, adjacencyStart, adjacency );
+    }
+  else
+    {
+    this->template ZoneUnionFind< unsigned long >( pairs, levels, labels, adjacencyStart, adjacency );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+template<class TRank>
 void
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::ZoneUnionFind( PixelOffsetPairsType & pairs, const LevelsType & levels,
+                 const std::vector< OffsetValueType > & labels,
+                 const std::vector< OffsetValueType > & adjacencyStart,
+                 const std::vector< OffsetValueType > & adjacency )
+{
+  OutputImageType * output = this->GetOutput();
+  const unsigned long numberOfPixels = labels.size();
+  const unsigned long numberOfZones = pairs.size();
+
+  ProgressReporter progress(this, 0, numberOfZones * 2 + numberOfPixels);
+
+  // replace the values by their rank, and keep the order of the zones
+  std::vector< TRank > ranks( numberOfZones );
+  std::vector< OffsetValueType > order( numberOfZones );
+  TRank rank = 0;
+  for( unsigned long i=0; i<numberOfZones; i++ )
+    {
+    if( pairs[i].first != levels[ rank ] )
+      {
+      rank++;
+      }
+    ranks[ pairs[i].second ] = rank;
+    order[i] = pairs[i].second;
+    }
+  PixelOffsetPairsType().swap( pairs );
+
+  // union-find from the deepest zones, as in RankUnionFind()
+  std::vector< OffsetValueType > parent( numberOfZones );
+  std::vector< OffsetValueType > zpar( numberOfZones, -1 );
+  for( unsigned long i=0; i<numberOfZones; i++ )
+    {
+    const OffsetValueType z = order[i];
+    parent[z] = z;
+    zpar[z] = z;
+    for( OffsetValueType k=adjacencyStart[z]; k<adjacencyStart[z+1]; k++ )
+      {
+      const OffsetValueType n = adjacency[k];
+      if( zpar[n] == -1 )
+        {
+        // not processed yet
+        continue;
+        }
+      OffsetValueType r = n;
+      while( zpar[r] != r )
+        {
+        zpar[r] = zpar[ zpar[r] ];
+        r = zpar[r];
+        }
+      if( r != z )
+        {
+        parent[r] = z;
+        zpar[r] = z;
+        }
+      }
+    progress.CompletedPixel();
+    }
+
+  for( long i=numberOfZones-1; i>=0; i-- )
+    {
+    const OffsetValueType z = order[i];
+    const OffsetValueType q = parent[z];
+    if( ranks[ parent[q] ] == ranks[q] )
+      {
+      parent[z] = parent[q];
+      }
+    }
+
+  // the number of pixels of the node of each canonical zone, computed in
+  // zpar as in RankUnionFind()
+  std::vector< OffsetValueType > & sizes = zpar;
+  if( m_MinimumSize > 0 )
+    {
+    std::fill( sizes.begin(), sizes.end(), 0 );
+    for( unsigned long i=0; i<numberOfPixels; i++ )
+      {
+      sizes[ labels[i] ]++;
+      }
+    for( unsigned long i=0; i<numberOfZones; i++ )
+      {
+      const OffsetValueType z = order[i];
+      if( parent[z] != z )
+        {
+        sizes[ parent[z] ] += sizes[z];
+        }
+      }
+    }
+  else
+    {
+    std::vector< OffsetValueType >().swap( zpar );
+    }
+
+  // create the nodes, from the root to the leaves. The zones of the same
+  // node share the node of their canonical zone, and the zones of a node too
+  // small share the node of their parent.
+  AccumulatorType accumulator;
+  accumulator.SetComponentTree( output );
+  std::vector< NodeType * > nodes( numberOfZones, NULL );
+  for( long i=numberOfZones-1; i>=0; i-- )
+    {
+    const OffsetValueType z = order[i];
+    const OffsetValueType q = parent[z];
+    if( m_MinimumSize > 0 && z != q && ranks[z] != ranks[q]
+        && static_cast< unsigned long >( sizes[z] ) < m_MinimumSize )
+      {
+      assert( nodes[q] != NULL );
+      nodes[z] = nodes[q];
+      }
+    else if( z == q || ranks[z] != ranks[q] )
+      {
+      NodeType * node = new NodeType();
+      node->SetPixel( levels[ ranks[z] ] );
+      if( AccumulatorType::Active )
+        {
+        accumulator.Initialize( node );
+        }
+      if( z != q )
+        {
+        assert( nodes[q] != NULL );
+        nodes[q]->AddChild( node );
+        }
+      nodes[z] = node;
+      }
+    else
+      {
+      assert( nodes[q] != NULL );
+      nodes[z] = nodes[q];
+      }
+    progress.CompletedPixel();
+    }
+
+  // link the pixels to the node of their zone
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    output->NodeAddIndex( nodes[ labels[i] ], i );
+    if( AccumulatorType::Active )
+      {
+      accumulator.AddPixel( nodes[ labels[i] ], i );
+      }
+    progress.CompletedPixel();
+    }
+
+  if( AccumulatorType::Active )
+    {
+    // merge the attributes of the nodes in their parent, as in
+    // RankUnionFind()
+    for( unsigned long i=0; i<numberOfZones; i++ )
+      {
+      const OffsetValueType z = order[i];
+      const OffsetValueType q = parent[z];
+      if( ranks[z] != ranks[q] && nodes[z] != nodes[q] )
+        {
+        accumulator.Merge( nodes[q], nodes[z] );
+        }
+      }
+    }
+
+  NodeType * root = nodes[ order[ numberOfZones - 1 ] ];
+  assert( root != NULL );
+  assert( output->NodeCountIndexes( root ) == numberOfPixels );
+
+  // to be sure that root parent is NULL
+  root->SetParent( NULL );
+
+  // keep a pointer on the root node
+  output->SetRoot( root );
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::SortPixels( const InputImageType * image, PixelOffsetPairsType & pairs )
+{
+  assert( image != NULL );
+  const unsigned long numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  const InputImagePixelType * buffer = image->GetBufferPointer();
+
+  pairs.resize( numberOfPixels );
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    pairs[i].first = buffer[i];
+    pairs[i].second = i;
+    }
+  this->ThreadedSort( pairs );
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::ThreadedSort( PixelOffsetPairsType & pairs )
+{
+  // don't use threads for the small images
+  const unsigned long minimumChunkSize = 4096;
+  int numberOfThreads = this->GetNumberOfThreads();
+  if( static_cast< unsigned long >( numberOfThreads ) > pairs.size() / minimumChunkSize )
+    {
+    numberOfThreads = std::max( 1, static_cast< int >( pairs.size() / minimumChunkSize ) );
+    }
+
+  // sort a chunk per thread
+  m_SortBounds.resize( numberOfThreads + 1 );
+  for( int i=0; i<=numberOfThreads; i++ )
+    {
+    m_SortBounds[i] = pairs.size() * i / numberOfThreads;
+    }
+  m_SortPairs = &pairs;
+  m_SortWidth = 0;
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( numberOfThreads );
+  threader->SetSingleMethod( this->SortThreaderCallback, this );
+  threader->SingleMethodExecute();
+
+  // then merge the sorted chunks two by two, with a thread per merge
+  for( m_SortWidth=1; m_SortWidth<numberOfThreads; m_SortWidth*=2 )
+    {
+    const int numberOfMerges = ( numberOfThreads + 2 * m_SortWidth - 1 ) / ( 2 * m_SortWidth );
+    threader = MultiThreader::New();
+    threader->SetNumberOfThreads( numberOfMerges );
+    threader->SetSingleMethod( this->SortThreaderCallback, this );
+    threader->SingleMethodExecute();
+    }
+
+  m_SortPairs = NULL;
+  m_SortBounds.clear();
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::ThreadedSortChunk( int threadId, int numberOfThreads )
+{
+  PixelOffsetPairCompare compare;
+  typename PixelOffsetPairsType::iterator begin = m_SortPairs->begin();
+  const int numberOfChunks = m_SortBounds.size() - 1;
+  if( m_SortWidth == 0 )
+    {
+    for( int c=threadId; c<numberOfChunks; c+=numberOfThreads )
+      {
+      std::sort( begin + m_SortBounds[ c ], begin + m_SortBounds[ c + 1 ], compare );
+      }
+    }
+  else
+    {
+    for( int first=threadId * 2 * m_SortWidth; first<numberOfChunks; first+=numberOfThreads * 2 * m_SortWidth )
+      {
+      const int middle = first + m_SortWidth;
+      const int last = std::min( numberOfChunks, middle + m_SortWidth );
+      if( middle < numberOfChunks )
+        {
+        std::inplace_merge( begin + m_SortBounds[ first ], begin + m_SortBounds[ middle ],
+                            begin + m_SortBounds[ last ], compare );
+        }
+      }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+ITK_THREAD_RETURN_TYPE
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::SortThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self * filter = static_cast< Self * >( info->UserData );
+  filter->ThreadedSortChunk( info->ThreadID, info->NumberOfThreads );
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::ComputeNeighbors( OffsetValueType * strides, std::vector< OffsetType > & neighbors,
+                    std::vector< OffsetValueType > & neighborOffsets ) const
+{
+  const typename InputImageRegionType::SizeType & size = this->GetInput()->GetRequestedRegion().GetSize();
+  strides[0] = 1;
+  for( unsigned int d=1; d<ImageDimension; d++ )
+    {
+    strides[d] = strides[d-1] * size[d-1];
+    }
+  unsigned long neighborhoodSize = 1;
+  for( unsigned int d=0; d<ImageDimension; d++ )
+    {
+    neighborhoodSize *= 3;
+    }
+  neighbors.clear();
+  neighborOffsets.clear();
+  for( unsigned long i=0; i<neighborhoodSize; i++ )
+    {
+    OffsetType o;
+    unsigned long r = i;
+    unsigned int nbOfNonZero = 0;
+    OffsetValueType offset = 0;
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      o[d] = static_cast< long >( r % 3 ) - 1;
+      r /= 3;
+      if( o[d] != 0 )
+        {
+        nbOfNonZero++;
+        }
+      offset += o[d] * strides[d];
+      }
+    if( nbOfNonZero != 0 && ( m_FullyConnected || nbOfNonZero == 1 ) )
+      {
+      neighbors.push_back( o );
+      neighborOffsets.push_back( offset );
+      }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::AddComponent( NodeType * parent, NodeType * child, unsigned long childSize )
+{
+  AccumulatorType accumulator;
+  accumulator.SetComponentTree( this->GetOutput() );
+  if( childSize < m_MinimumSize )
+    {
+    // the children of the child are smaller, so they have already been
+    // merged in the child
+    assert( child->GetChildren().empty() );
+    if( AccumulatorType::Active )
+      {
+      // the pixels take the value of the parent
+      for( typename NodeType::IndexType current=child->GetFirstIndex();
+           current != NodeType::EndIndex;
+           current = this->GetOutput()->GetLinkedListArray()[ current ] )
+        {
+        accumulator.AddPixel( parent, current );
+        }
+      }
+    this->GetOutput()->NodeMerge( parent, child );
+    delete child;
+    }
+  else
+    {
+    if( AccumulatorType::Active )
+      {
+      accumulator.Merge( parent, child );
+      }
+    parent->AddChild( child );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+unsigned long
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::RemoveSmallNodes( NodeType * node )
+{
+  assert( node != NULL );
+  OutputImageType * output = this->GetOutput();
+
+  unsigned long size = output->NodeCountOwnIndexes( node );
+  typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  typename NodeType::ChildrenListType::iterator it=childrenList->begin();
+  while( it!=childrenList->end() )
+    {
+    const unsigned long childSize = this->RemoveSmallNodes( *it );
+    size += childSize;
+    if( childSize < m_MinimumSize )
+      {
+      // the children of the child are smaller, and have already been
+      // merged in the child
+      output->NodeMerge( node, *it );
+      typename NodeType::ChildrenListType::iterator toRemove = it;
+      it++;
+      delete *toRemove;
+      childrenList->erase( toRemove );
+      }
+    else
+      {
+      it++;
+      }
+    }
+  return size;
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
+::AccumulateAttributes( NodeType * node )
+{
+  assert( node != NULL );
+  AccumulatorType accumulator;
+  OutputImageType * output = this->GetOutput();
+  accumulator.SetComponentTree( output );
+
+  accumulator.Initialize( node );
+  for( typename NodeType::IndexType current=node->GetFirstIndex();
+       current != NodeType::EndIndex;
+       current = output->GetLinkedListArray()[ current ] )
+    {
+    accumulator.AddPixel( node, current );
+    }
+
+  typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  for( typename NodeType::ChildrenListType::iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+    {
+    this->AccumulateAttributes( *it );
+    accumulator.Merge( node, *it );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+void
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::LightMerge( NodeType* node1, NodeType* node2)
 {
   assert( node1 != node2 );
@@ -265,6 +1512,12 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
 //   assert( !node2->GetIndexes().empty() );
   // assert( this->GetPixel() <= node->GetPixel() );
   
+  if( AccumulatorType::Active )
+    {
+    AccumulatorType accumulator;
+    accumulator.Merge( node1, node2 );
+    }
+
   // merge the index and the children list
   this->GetOutput()->NodeTakeIndexesFrom( node1, node2 );
   node1->TakeChildrenFrom( node2 );
@@ -278,9 +1531,9 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
 }
 
 
-template<class TInputImage, class TOutputImage, class TCompare>
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
 void
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::SetChildrenParent( NodeType* node )
 {
   assert( node != NULL );
@@ -292,9 +1545,9 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
 }
 
 
-template<class TInputImage, class TOutputImage, class TCompare>
-typename ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>::NodeType *
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+typename ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>::NodeType *
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::GetAncestor( NodeType* node )
 {
   assert( node != NULL );
@@ -313,9 +1566,9 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
 }
 
 
-template<class TInputImage, class TOutputImage, class TCompare>
-typename ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>::NodeType *
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
+typename ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>::NodeType *
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::GetReference( NodeType* node )
 {
   if( node == NULL )
@@ -340,14 +1593,22 @@ ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
 }
 
 
-template<class TInputImage, class TOutputImage, class TCompare>
+template<class TInputImage, class TOutputImage, class TCompare, class TAccumulator>
 void
-ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare>
+ImageToComponentTreeFilter<TInputImage, TOutputImage, TCompare, TAccumulator>
 ::PrintSelf(std::ostream &os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
 
   os << indent << "FullyConnected: "  << m_FullyConnected << std::endl;
+  os << indent << "RunLengthEncoding: "  << m_RunLengthEncoding << std::endl;
+  os << indent << "MinimumSize: "  << m_MinimumSize << std::endl;
+  os << indent << "Algorithm: "  << GetNameFromAlgorithm(m_Algorithm) << " (" << m_Algorithm << ")" << std::endl;
+  os << indent << "SelectedAlgorithm: "  << GetNameFromAlgorithm(m_SelectedAlgorithm) << " (" << m_SelectedAlgorithm << ")" << std::endl;
+  os << indent << "MemoryBudget: "  << m_MemoryBudget << std::endl;
+  os << indent << "EstimatedNodesPerPixel: "  << m_EstimatedNodesPerPixel << std::endl;
+  os << indent << "MemoryBudgetPolicy: "  << GetNameFromMemoryBudgetPolicy(m_MemoryBudgetPolicy) << " (" << m_MemoryBudgetPolicy << ")" << std::endl;
+  os << indent << "EstimatedPeakMemory: "  << m_EstimatedPeakMemory << std::endl;
 }
   
 }// end namespace itk
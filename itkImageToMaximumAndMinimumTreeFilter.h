@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkImageToMaximumAndMinimumTreeFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkImageToMaximumAndMinimumTreeFilter_h
+#define __itkImageToMaximumAndMinimumTreeFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkImageToMinimumTreeFilter.h"
+#include <string>
+
+namespace itk {
+
+/** \class ImageToMaximumAndMinimumTreeFilter
+ * \brief Convert an image to a max tree and a min tree with a single sort of the pixels
+ *
+ * The self-dual filters need both the max tree and the min tree of the
+ * same image. Building them with ImageToMaximumTreeFilter and
+ * ImageToMinimumTreeFilter sorts the pixels twice when the pixel type has
+ * too many values for the Flooding algorithm. This filter sorts them once
+ * in that case, in the order of the min tree, with all the threads, and
+ * reverses the sorted pixels for the max tree. Both trees are then built
+ * with the RankTransform algorithm.
+ *
+ * The integer pixel types up to 16 bits don't need a sort: the two trees
+ * are built independently, with the algorithm selected by each filter -
+ * usually Flooding - and the threads are shared between the two filters.
+ *
+ * In both cases, the two trees are built on two threads when at least two
+ * threads are available.
+ *
+ * The max tree is the first output, and can be read with GetMaximumTree();
+ * the min tree is the second output, and can be read with
+ * GetMinimumTree(). The trees are the same as the ones produced by
+ * ImageToMaximumTreeFilter and ImageToMinimumTreeFilter.
+ *
+ * When the pixels are sorted, they are stored twice while the trees are
+ * built, so the peak memory is about the same as the one of the two
+ * filters run concurrently.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ImageToMaximumTreeFilter ImageToMinimumTreeFilter ImageToComponentTreeFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TInputImage, class TOutputImage,
+         class TAccumulator=Functor::NullComponentTreeAccumulator< typename TOutputImage::NodeType > >
+class ITK_EXPORT ImageToMaximumAndMinimumTreeFilter : 
+    public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageToMaximumAndMinimumTreeFilter Self;
+  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename InputImageType::Pointer         InputImagePointer;
+  typedef typename InputImageType::ConstPointer    InputImageConstPointer;
+  typedef typename InputImageType::RegionType      InputImageRegionType;
+  typedef typename InputImageType::PixelType       InputImagePixelType;
+  typedef typename OutputImageType::Pointer        OutputImagePointer;
+  typedef typename OutputImageType::ConstPointer   OutputImageConstPointer;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+  typedef typename OutputImageType::NodeType       NodeType;
+  typedef typename OutputImageType::AttributeType  AttributeType;
+  typedef typename OutputImageType::IndexType      IndexType;
+  typedef TAccumulator                             AccumulatorType;
+
+  typedef ImageToMaximumTreeFilter< InputImageType, OutputImageType, AccumulatorType > MaximumTreeFilterType;
+  typedef ImageToMinimumTreeFilter< InputImageType, OutputImageType, AccumulatorType > MinimumTreeFilterType;
+  typedef typename MinimumTreeFilterType::PixelOffsetPairsType PixelOffsetPairsType;
+  
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(ImageToMaximumAndMinimumTreeFilter, 
+               ImageToImageFilter);
+
+  /**
+   * Set/Get whether the connected components are defined strictly by
+   * face connectivity or by face+edge+vertex connectivity.  Default is
+   * FullyConnectedOff.  For objects that are 1 pixel wide, use
+   * FullyConnectedOn.
+   */
+  itkSetMacro(FullyConnected, bool);
+  itkGetConstReferenceMacro(FullyConnected, bool);
+  itkBooleanMacro(FullyConnected);
+
+  /**
+   * Set/Get whether the output trees are run-length encoded. Default is
+   * RunLengthEncodingOff.
+   */
+  itkSetMacro(RunLengthEncoding, bool);
+  itkGetConstReferenceMacro(RunLengthEncoding, bool);
+  itkBooleanMacro(RunLengthEncoding);
+
+  /**
+   * Set/Get the minimum number of pixels of the nodes of both trees.
+   * Default is 0.
+   */
+  itkSetMacro(MinimumSize, unsigned long);
+  itkGetConstReferenceMacro(MinimumSize, unsigned long);
+
+  /** Return the max tree */
+  OutputImageType * GetMaximumTree()
+    {
+    return this->GetOutput( 0 );
+    }
+
+  /** Return the min tree */
+  OutputImageType * GetMinimumTree()
+    {
+    return this->GetOutput( 1 );
+    }
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+/*  itkConceptMacro(InputEqualityComparableCheck,
+    (Concept::EqualityComparable<InputImagePixelType>));
+  itkConceptMacro(IntConvertibleToInputCheck,
+    (Concept::Convertible<int, InputImagePixelType>));
+  itkConceptMacro(InputOStreamWritableCheck,
+    (Concept::OStreamWritable<InputImagePixelType>));*/
+  /** End concept checking */
+#endif
+
+protected:
+  ImageToMaximumAndMinimumTreeFilter();
+  ~ImageToMaximumAndMinimumTreeFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** ImageToMaximumAndMinimumTreeFilter needs the entire input be
+   * available. Thus, it needs to provide an implementation of
+   * GenerateInputRequestedRegion(). */
+  void GenerateInputRequestedRegion() ;
+
+  /** ImageToMaximumAndMinimumTreeFilter will produce the entire outputs. */
+  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
+  
+  /** Sort the pixels, then build the two trees */
+  void GenerateData();
+
+  /** Build the tree of a thread: the max tree for the thread 0, and the min
+   * tree for the thread 1 */
+  void ThreadedBuildTree( int threadId );
+
+  static ITK_THREAD_RETURN_TYPE BuildTreeThreaderCallback( void * arg );
+
+private:
+  ImageToMaximumAndMinimumTreeFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  bool                m_FullyConnected;
+  bool                m_RunLengthEncoding;
+  unsigned long       m_MinimumSize;
+
+  // the filters which build the trees, and the error messages of the threads
+  ProcessObject *     m_TreeFilters[2];
+  std::string         m_ErrorMessages[2];
+} ; // end of class
+
+} // end namespace itk
+  
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageToMaximumAndMinimumTreeFilter.txx"
+#endif
+
+#endif
+
+
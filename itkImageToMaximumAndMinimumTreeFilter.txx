@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkImageToMaximumAndMinimumTreeFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkImageToMaximumAndMinimumTreeFilter_txx
+#define __itkImageToMaximumAndMinimumTreeFilter_txx
+
+#include "itkImageToMaximumAndMinimumTreeFilter.h"
+#include "itkProgressReporter.h"
+#include "itkMultiThreader.h"
+#include <limits>
+#include <exception>
+
+
+namespace itk {
+
+template <class TInputImage, class TOutputImage, class TAccumulator>
+ImageToMaximumAndMinimumTreeFilter<TInputImage, TOutputImage, TAccumulator>
+::ImageToMaximumAndMinimumTreeFilter()
+{
+  m_FullyConnected = false;
+  m_RunLengthEncoding = false;
+  m_MinimumSize = 0;
+  m_TreeFilters[0] = NULL;
+  m_TreeFilters[1] = NULL;
+
+  // the max tree is the first output, and the min tree the second one
+  this->SetNumberOfRequiredOutputs( 2 );
+  this->ProcessObject::SetNthOutput( 1, this->MakeOutput( 1 ) );
+}
+
+
+template <class TInputImage, class TOutputImage, class TAccumulator>
+void 
+ImageToMaximumAndMinimumTreeFilter<TInputImage, TOutputImage, TAccumulator>
+::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+  
+  // We need all the input.
+  InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
+  
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+template <class TInputImage, class TOutputImage, class TAccumulator>
+void 
+ImageToMaximumAndMinimumTreeFilter<TInputImage, TOutputImage, TAccumulator>
+::EnlargeOutputRequestedRegion(DataObject *)
+{
+  for( unsigned int i=0; i<2; i++ )
+    {
+    this->GetOutput( i )
+      ->SetRequestedRegion( this->GetOutput( i )->GetLargestPossibleRegion() );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TAccumulator>
+void
+ImageToMaximumAndMinimumTreeFilter<TInputImage, TOutputImage, TAccumulator>
+::GenerateData()
+{
+  ProgressReporter progress(this, 0, 2);
+
+  // the trees are built by the usual filters. Each one gets its own graft
+  // of the input, so the two pipelines don't share any object.
+  typename MaximumTreeFilterType::Pointer maxFilter = MaximumTreeFilterType::New();
+  typename MinimumTreeFilterType::Pointer minFilter = MinimumTreeFilterType::New();
+  InputImagePointer maxInput = InputImageType::New();
+  maxInput->Graft( this->GetInput() );
+  maxFilter->SetInput( maxInput );
+  maxFilter->SetFullyConnected( m_FullyConnected );
+  maxFilter->SetRunLengthEncoding( m_RunLengthEncoding );
+  maxFilter->SetMinimumSize( m_MinimumSize );
+
+  InputImagePointer minInput = InputImageType::New();
+  minInput->Graft( this->GetInput() );
+  minFilter->SetInput( minInput );
+  minFilter->SetFullyConnected( m_FullyConnected );
+  minFilter->SetRunLengthEncoding( m_RunLengthEncoding );
+  minFilter->SetMinimumSize( m_MinimumSize );
+
+  typedef std::numeric_limits< InputImagePixelType > LimitsType;
+  if( LimitsType::is_integer && LimitsType::digits <= 16 )
+    {
+    // the filters can use the linear Flooding algorithm, which is faster
+    // than a sort of the pixels: build the trees independently, and share
+    // the threads between them when they are built concurrently
+    const int numberOfThreads = this->GetNumberOfThreads() >= 2 ? this->GetNumberOfThreads() / 2 : 1;
+    maxFilter->SetNumberOfThreads( numberOfThreads );
+    minFilter->SetNumberOfThreads( numberOfThreads );
+    }
+  else
+    {
+    // sort the pixels once, in the order of the min tree, with all the
+    // threads. The same pixels in the reverse order are in the order of the
+    // max tree.
+    maxFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+    minFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+    PixelOffsetPairsType pairs;
+    minFilter->SortPixels( this->GetInput(), pairs );
+    PixelOffsetPairsType reversedPairs( pairs.rbegin(), pairs.rend() );
+    maxFilter->SetSortedPixels( reversedPairs );
+    minFilter->SetSortedPixels( pairs );
+    }
+  progress.CompletedPixel();
+
+  // build the trees, concurrently if possible
+  m_TreeFilters[0] = maxFilter;
+  m_TreeFilters[1] = minFilter;
+  m_ErrorMessages[0] = "";
+  m_ErrorMessages[1] = "";
+  if( this->GetNumberOfThreads() >= 2 )
+    {
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetNumberOfThreads( 2 );
+    threader->SetSingleMethod( this->BuildTreeThreaderCallback, this );
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    this->ThreadedBuildTree( 0 );
+    this->ThreadedBuildTree( 1 );
+    }
+  m_TreeFilters[0] = NULL;
+  m_TreeFilters[1] = NULL;
+
+  for( unsigned int i=0; i<2; i++ )
+    {
+    if( !m_ErrorMessages[i].empty() )
+      {
+      itkExceptionMacro( << m_ErrorMessages[i] );
+      }
+    }
+
+  // share the trees with the outputs, in constant time
+  this->GraftNthOutput( 0, maxFilter->GetOutput() );
+  this->GraftNthOutput( 1, minFilter->GetOutput() );
+  progress.CompletedPixel();
+}
+
+
+template<class TInputImage, class TOutputImage, class TAccumulator>
+void
+ImageToMaximumAndMinimumTreeFilter<TInputImage, TOutputImage, TAccumulator>
+::ThreadedBuildTree( int threadId )
+{
+  // the exceptions can't go through the threader, so they are kept to be
+  // thrown again by GenerateData()
+  try
+    {
+    m_TreeFilters[ threadId ]->Update();
+    }
+  catch( ExceptionObject & e )
+    {
+    m_ErrorMessages[ threadId ] = e.GetDescription();
+    }
+  catch( std::exception & e )
+    {
+    m_ErrorMessages[ threadId ] = e.what();
+    }
+  catch( ... )
+    {
+    m_ErrorMessages[ threadId ] = "Unknown exception while building the tree.";
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TAccumulator>
+ITK_THREAD_RETURN_TYPE
+ImageToMaximumAndMinimumTreeFilter<TInputImage, TOutputImage, TAccumulator>
+::BuildTreeThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self * filter = static_cast< Self * >( info->UserData );
+  filter->ThreadedBuildTree( info->ThreadID );
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+template<class TInputImage, class TOutputImage, class TAccumulator>
+void
+ImageToMaximumAndMinimumTreeFilter<TInputImage, TOutputImage, TAccumulator>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FullyConnected: "  << m_FullyConnected << std::endl;
+  os << indent << "RunLengthEncoding: "  << m_RunLengthEncoding << std::endl;
+  os << indent << "MinimumSize: "  << m_MinimumSize << std::endl;
+}
+
+}// end namespace itk
+#endif
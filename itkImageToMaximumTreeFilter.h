@@ -30,14 +30,15 @@ namespace itk {
  *
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters ImageToMinimumTreeFilter
  */
-template<class TInputImage, class TOutputImage>
+template<class TInputImage, class TOutputImage,
+         class TAccumulator=Functor::NullComponentTreeAccumulator< typename TOutputImage::NodeType > >
 class ITK_EXPORT ImageToMaximumTreeFilter : 
-    public ImageToComponentTreeFilter<TInputImage, TOutputImage, std::greater<typename TInputImage::PixelType> >
+    public ImageToComponentTreeFilter<TInputImage, TOutputImage, std::greater<typename TInputImage::PixelType>, TAccumulator >
 {
 public:
   /** Standard class typedefs. */
   typedef ImageToMaximumTreeFilter Self;
-  typedef ImageToComponentTreeFilter<TInputImage, TOutputImage, std::greater<typename TInputImage::PixelType> > Superclass;
+  typedef ImageToComponentTreeFilter<TInputImage, TOutputImage, std::greater<typename TInputImage::PixelType>, TAccumulator > Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
 
@@ -55,6 +56,7 @@ public:
   typedef typename OutputImageType::NodeType       NodeType;
   typedef typename OutputImageType::AttributeType  AttributeType;
   typedef typename OutputImageType::IndexType      IndexType;
+  typedef TAccumulator                             AccumulatorType;
   
   /** ImageDimension constants */
   itkStaticConstMacro(ImageDimension, unsigned int,
@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkImageToTreeOfShapesFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkImageToTreeOfShapesFilter_h
+#define __itkImageToTreeOfShapesFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkComponentTreeAccumulator.h"
+#include <vector>
+
+namespace itk {
+
+/** \class ImageToTreeOfShapesFilter
+ * \brief Convert an image to a tree of shapes
+ *
+ * The shapes are the connected components of the upper and of the lower
+ * level sets of the image, with their holes filled. They form a tree, the
+ * tree of shapes or inclusion tree, which contains both the bright and
+ * the dark objects of the image. It is self-dual, so a single attribute
+ * filtering of the tree processes the bright and the dark objects in the
+ * same way, where a max tree and a min tree must be filtered one after the
+ * other. The output is a ComponentTree, so the attribute and the
+ * reconstruction filters of the component trees can be used on it, but the
+ * children of a node can be brighter or darker than the node.
+ *
+ * The tree is built with the quasi-linear algorithm of Geraud et al.:
+ * - the image gets a border with the median value of the pixels on its
+ * border, so the root of the tree is the shape which contains the border.
+ * - the image is interpolated on a grid two times finer, where the new
+ * samples take the maximum of their neighbors with FullyConnectedOn(), or
+ * their minimum with FullyConnectedOff(), to make the image well composed.
+ * - the interpolated image is immersed in the Khalimsky grid, two times
+ * finer again, where each face gets the interval of the values of its
+ * neighbors.
+ * - the faces are sorted by a propagation from the border with a
+ * hierarchical queue, which always processes the faces of the current
+ * level first, then the level the nearest to the current one.
+ * - the tree of the faces is built with a union-find in the reverse order
+ * of the propagation, as in the RankTransform algorithm of
+ * ImageToComponentTreeFilter, and only the faces of the original pixels
+ * are kept in the output.
+ *
+ * With FullyConnectedOn(), the upper level sets are fully connected and
+ * the lower level sets are face connected. With FullyConnectedOff(), it is
+ * the opposite. Default is FullyConnectedOn().
+ *
+ * The Khalimsky grid has about 4^d faces per pixel, where d is the image
+ * dimension, so the memory used to build the tree is much larger than the
+ * one used to build a max tree.
+ *
+ * The attributes which can be merged in constant time can be computed
+ * while the tree is built, with the TAccumulator template parameter. See
+ * NullComponentTreeAccumulator.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa ImageToMaximumTreeFilter ImageToMinimumTreeFilter ComponentTree
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TInputImage, class TOutputImage,
+         class TAccumulator=Functor::NullComponentTreeAccumulator< typename TOutputImage::NodeType > >
+class ITK_EXPORT ImageToTreeOfShapesFilter :
+    public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageToTreeOfShapesFilter Self;
+  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename InputImageType::Pointer         InputImagePointer;
+  typedef typename InputImageType::ConstPointer    InputImageConstPointer;
+  typedef typename InputImageType::RegionType      InputImageRegionType;
+  typedef typename InputImageType::PixelType       InputImagePixelType;
+  typedef typename InputImageType::SizeType        SizeType;
+  typedef typename OutputImageType::Pointer        OutputImagePointer;
+  typedef typename OutputImageType::ConstPointer   OutputImageConstPointer;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+  typedef typename OutputImageType::NodeType       NodeType;
+  typedef typename OutputImageType::AttributeType  AttributeType;
+  typedef typename OutputImageType::IndexType      IndexType;
+  typedef typename InputImageType::OffsetValueType OffsetValueType;
+  typedef TAccumulator                             AccumulatorType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ImageToTreeOfShapesFilter,
+               ImageToImageFilter);
+
+  /**
+   * Set/Get whether the upper level sets are fully connected and the lower
+   * level sets face connected, or the opposite. Default is
+   * FullyConnectedOn.
+   */
+  itkSetMacro(FullyConnected, bool);
+  itkGetConstReferenceMacro(FullyConnected, bool);
+  itkBooleanMacro(FullyConnected);
+
+  /**
+   * Set/Get whether the output tree is run-length encoded. Default is
+   * RunLengthEncodingOff.
+   */
+  itkSetMacro(RunLengthEncoding, bool);
+  itkGetConstReferenceMacro(RunLengthEncoding, bool);
+  itkBooleanMacro(RunLengthEncoding);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+/*  itkConceptMacro(InputEqualityComparableCheck,
+    (Concept::EqualityComparable<InputImagePixelType>));
+  itkConceptMacro(IntConvertibleToInputCheck,
+    (Concept::Convertible<int, InputImagePixelType>));
+  itkConceptMacro(InputOStreamWritableCheck,
+    (Concept::OStreamWritable<InputImagePixelType>));*/
+  /** End concept checking */
+#endif
+
+protected:
+  ImageToTreeOfShapesFilter();
+  ~ImageToTreeOfShapesFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** ImageToTreeOfShapesFilter needs the entire input be
+   * available. Thus, it needs to provide an implementation of
+   * GenerateInputRequestedRegion(). */
+  void GenerateInputRequestedRegion() ;
+
+  /** ImageToTreeOfShapesFilter will produce the entire output. */
+  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
+
+  /** Compute the levels of the image, then build the tree */
+  void GenerateData();
+
+  typedef std::vector< InputImagePixelType > LevelsType;
+
+  /** Build the tree from the sorted values of the image and the value of
+   * the border. TRank must be able to store the number of values. */
+  template<class TRank>
+  void TreeOfShapes( const LevelsType & levels, const InputImagePixelType & borderValue );
+
+  /** Compute a grid two times finer than the input one, where each sample
+   * gets the smallest lower bound and the largest upper bound of its
+   * neighbors in the input grid. */
+  template<class TRank>
+  void Upsample( const SizeType & inputSize, const std::vector< TRank > & inputLower,
+                 const std::vector< TRank > & inputUpper, SizeType & outputSize,
+                 std::vector< TRank > & outputLower, std::vector< TRank > & outputUpper ) const;
+
+  /** Compute the strides of a grid, and return its number of elements */
+  static unsigned long ComputeStrides( const SizeType & size, OffsetValueType * strides )
+    {
+    unsigned long count = 1;
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      strides[d] = count;
+      count *= size[d];
+      }
+    return count;
+    }
+
+  /** Compute the index of an element of a grid from its offset */
+  static void ComputeIndex( OffsetValueType offset, const OffsetValueType * strides, IndexType & idx )
+    {
+    for( int d=ImageDimension-1; d>=0; d-- )
+      {
+      idx[d] = offset / strides[d];
+      offset -= idx[d] * strides[d];
+      }
+    }
+
+private:
+  ImageToTreeOfShapesFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  bool                m_FullyConnected;
+  bool                m_RunLengthEncoding;
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageToTreeOfShapesFilter.txx"
+#endif
+
+#endif
+
+
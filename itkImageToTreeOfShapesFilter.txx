@@ -0,0 +1,498 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkImageToTreeOfShapesFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkImageToTreeOfShapesFilter_txx
+#define __itkImageToTreeOfShapesFilter_txx
+
+#include "itkImageToTreeOfShapesFilter.h"
+#include "itkProgressReporter.h"
+#include "itkNumericTraits.h"
+#include "itkHierarchicalQueue.h"
+#include <algorithm>
+
+
+namespace itk {
+
+template <class TInputImage, class TOutputImage, class TAccumulator>
+ImageToTreeOfShapesFilter<TInputImage, TOutputImage, TAccumulator>
+::ImageToTreeOfShapesFilter()
+{
+  m_FullyConnected = true;
+  m_RunLengthEncoding = false;
+}
+
+
+template <class TInputImage, class TOutputImage, class TAccumulator>
+void
+ImageToTreeOfShapesFilter<TInputImage, TOutputImage, TAccumulator>
+::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  // We need all the input.
+  InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
+
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+template <class TInputImage, class TOutputImage, class TAccumulator>
+void
+ImageToTreeOfShapesFilter<TInputImage, TOutputImage, TAccumulator>
+::EnlargeOutputRequestedRegion(DataObject *)
+{
+  this->GetOutput()
+    ->SetRequestedRegion( this->GetOutput()->GetLargestPossibleRegion() );
+}
+
+
+template<class TInputImage, class TOutputImage, class TAccumulator>
+void
+ImageToTreeOfShapesFilter<TInputImage, TOutputImage, TAccumulator>
+::GenerateData()
+{
+  // Allocate the output
+  this->AllocateOutputs();
+
+  const InputImageType * input = this->GetInput();
+  const SizeType & size = input->GetRequestedRegion().GetSize();
+  const InputImagePixelType * buffer = input->GetBufferPointer();
+  OffsetValueType strides[ImageDimension];
+  const unsigned long numberOfPixels = ComputeStrides( size, strides );
+
+  // the value of the border is the median of the values on the border of
+  // the image, so the root is the same for the image and its inverse
+  LevelsType borderValues;
+  IndexType idx;
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    ComputeIndex( i, strides, idx );
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      if( idx[d] == 0 || idx[d] == static_cast< long >( size[d] ) - 1 )
+        {
+        borderValues.push_back( buffer[i] );
+        break;
+        }
+      }
+    }
+  typename LevelsType::iterator median = borderValues.begin() + borderValues.size() / 2;
+  std::nth_element( borderValues.begin(), median, borderValues.end() );
+  const InputImagePixelType borderValue = *median;
+  LevelsType().swap( borderValues );
+
+  // the values of the image, sorted
+  LevelsType levels( buffer, buffer + numberOfPixels );
+  levels.push_back( borderValue );
+  std::sort( levels.begin(), levels.end() );
+  levels.erase( std::unique( levels.begin(), levels.end() ), levels.end() );
+
+  // use the smallest type which can store the ranks
+  if( levels.size() <= static_cast< unsigned long >( NumericTraits< unsigned short >::max() ) + 1 )
+    {
+    this->template TreeOfShapes< unsigned short >( levels, borderValue );
+    }
+  else
+    {
+    this->template TreeOfShapes< unsigned long >( levels, borderValue );
+    }
+
+  if( m_RunLengthEncoding )
+    {
+    this->GetOutput()->EncodeRunLength();
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TAccumulator>
+template<class TRank>
+void
+ImageToTreeOfShapesFilter<TInputImage, TOutputImage, TAccumulator>
+::TreeOfShapes( const LevelsType & levels, const InputImagePixelType & borderValue )
+{
+  OutputImageType * output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+  const SizeType & size = input->GetRequestedRegion().GetSize();
+  const InputImagePixelType * buffer = input->GetBufferPointer();
+  OffsetValueType strides[ImageDimension];
+  const unsigned long numberOfPixels = ComputeStrides( size, strides );
+  IndexType idx;
+
+  // the ranks of the image with a border of one pixel
+  SizeType borderedSize;
+  for( unsigned int d=0; d<ImageDimension; d++ )
+    {
+    borderedSize[d] = size[d] + 2;
+    }
+  OffsetValueType borderedStrides[ImageDimension];
+  const unsigned long numberOfBorderedPixels = ComputeStrides( borderedSize, borderedStrides );
+  const TRank borderRank = std::lower_bound( levels.begin(), levels.end(), borderValue ) - levels.begin();
+  std::vector< TRank > ranks( numberOfBorderedPixels, borderRank );
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    ComputeIndex( i, strides, idx );
+    OffsetValueType o = 0;
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      o += ( idx[d] + 1 ) * borderedStrides[d];
+      }
+    ranks[o] = std::lower_bound( levels.begin(), levels.end(), buffer[i] ) - levels.begin();
+    }
+
+  // interpolate the image with the maximum or the minimum of the neighbors
+  SizeType interpolatedSize;
+  std::vector< TRank > lower;
+  std::vector< TRank > upper;
+  this->Upsample( borderedSize, ranks, ranks, interpolatedSize, lower, upper );
+  if( m_FullyConnected )
+    {
+    ranks.swap( upper );
+    }
+  else
+    {
+    ranks.swap( lower );
+    }
+  std::vector< TRank >().swap( lower );
+  std::vector< TRank >().swap( upper );
+
+  // then immerse it in the Khalimsky grid, where each face gets the interval
+  // of the values of its neighbors
+  SizeType kSize;
+  this->Upsample( interpolatedSize, ranks, ranks, kSize, lower, upper );
+  std::vector< TRank >().swap( ranks );
+  OffsetValueType kStrides[ImageDimension];
+  const unsigned long numberOfFaces = ComputeStrides( kSize, kStrides );
+
+  ProgressReporter progress(this, 0, numberOfFaces * 3);
+
+  // sort the faces by propagation from the border, with a hierarchical
+  // queue indexed by the ranks. The level of a face is the nearest value to
+  // the current level in its interval. The non empty levels are marked in
+  // a LevelBitmap, so the nearest one is found without testing all the
+  // levels in between.
+  std::vector< std::vector< OffsetValueType > > queue( levels.size() );
+  LevelBitmap nonEmptyLevels;
+  nonEmptyLevels.Initialize( levels.size() );
+  std::vector< bool > queued( numberOfFaces, false );
+  std::vector< TRank > faceRanks( numberOfFaces );
+  std::vector< OffsetValueType > order( numberOfFaces );
+  TRank level = borderRank;
+  assert( lower[0] == borderRank && upper[0] == borderRank );
+  queue[ level ].push_back( 0 );
+  nonEmptyLevels.Set( level );
+  queued[0] = true;
+  for( unsigned long i=0; i<numberOfFaces; i++ )
+    {
+    if( queue[ level ].empty() )
+      {
+      // go to the nearest level with some faces
+      unsigned long above = 0;
+      unsigned long below = 0;
+      const bool hasAbove = nonEmptyLevels.Next( level, above );
+      const bool hasBelow = nonEmptyLevels.Previous( level, below );
+      assert( hasAbove || hasBelow );
+      if( hasAbove && ( !hasBelow || above - level <= level - below ) )
+        {
+        level = above;
+        }
+      else
+        {
+        level = below;
+        }
+      }
+    const OffsetValueType p = queue[ level ].back();
+    queue[ level ].pop_back();
+    if( queue[ level ].empty() )
+      {
+      nonEmptyLevels.Clear( level );
+      }
+    faceRanks[p] = level;
+    order[i] = p;
+
+    ComputeIndex( p, kStrides, idx );
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      for( int s=-1; s<=1; s+=2 )
+        {
+        const long c = idx[d] + s;
+        if( c < 0 || c >= static_cast< long >( kSize[d] ) )
+          {
+          continue;
+          }
+        const OffsetValueType n = p + s * kStrides[d];
+        if( queued[n] )
+          {
+          continue;
+          }
+        queued[n] = true;
+        TRank l = level;
+        if( lower[n] > level )
+          {
+          l = lower[n];
+          }
+        else if( upper[n] < level )
+          {
+          l = upper[n];
+          }
+        if( queue[l].empty() )
+          {
+          nonEmptyLevels.Set( l );
+          }
+        queue[l].push_back( n );
+        }
+      }
+    progress.CompletedPixel();
+    }
+  std::vector< std::vector< OffsetValueType > >().swap( queue );
+  std::vector< bool >().swap( queued );
+  std::vector< TRank >().swap( lower );
+  std::vector< TRank >().swap( upper );
+
+  // union-find from the last faces of the propagation, which are the
+  // deepest in the tree. zpar is the union-find structure, with path
+  // compression, and parent the tree of the faces.
+  std::vector< OffsetValueType > parent( numberOfFaces );
+  std::vector< OffsetValueType > zpar( numberOfFaces, -1 );
+  for( long i=numberOfFaces-1; i>=0; i-- )
+    {
+    const OffsetValueType p = order[i];
+    parent[p] = p;
+    zpar[p] = p;
+    ComputeIndex( p, kStrides, idx );
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      for( int s=-1; s<=1; s+=2 )
+        {
+        const long c = idx[d] + s;
+        if( c < 0 || c >= static_cast< long >( kSize[d] ) )
+          {
+          continue;
+          }
+        const OffsetValueType n = p + s * kStrides[d];
+        if( zpar[n] == -1 )
+          {
+          // not processed yet
+          continue;
+          }
+        // find the root of n, with path halving
+        OffsetValueType r = n;
+        while( zpar[r] != r )
+          {
+          zpar[r] = zpar[ zpar[r] ];
+          r = zpar[r];
+          }
+        if( r != p )
+          {
+          parent[r] = p;
+          zpar[r] = p;
+          }
+        }
+      }
+    progress.CompletedPixel();
+    }
+  std::vector< OffsetValueType >().swap( zpar );
+
+  // make the parent of each face the canonical face of its node: the root
+  // of the union-find for its level component, which is the last face of
+  // the component processed above, so the first one in the propagation
+  // order
+  for( unsigned long i=0; i<numberOfFaces; i++ )
+    {
+    const OffsetValueType p = order[i];
+    const OffsetValueType q = parent[p];
+    if( faceRanks[ parent[q] ] == faceRanks[q] )
+      {
+      parent[p] = parent[q];
+      }
+    }
+
+  // only the faces of the original pixels are kept. They are at the
+  // positions multiple of 4 in the Khalimsky grid, shifted by the border.
+  std::vector< OffsetValueType > faces( numberOfPixels );
+  std::vector< bool > hasPixels( numberOfFaces, false );
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    ComputeIndex( i, strides, idx );
+    OffsetValueType f = 0;
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      f += 4 * ( idx[d] + 1 ) * kStrides[d];
+      }
+    const OffsetValueType q = parent[f];
+    if( f != q && faceRanks[f] == faceRanks[q] )
+      {
+      f = q;
+      }
+    faces[i] = f;
+    hasPixels[f] = true;
+    }
+
+  // create the nodes of the canonical faces with some pixels, from the
+  // root to the leaves. The other canonical faces share the node of their
+  // parent.
+  AccumulatorType accumulator;
+  accumulator.SetComponentTree( output );
+  std::vector< NodeType * > nodes( numberOfFaces, NULL );
+  NodeType * root = NULL;
+  for( unsigned long i=0; i<numberOfFaces; i++ )
+    {
+    const OffsetValueType p = order[i];
+    const OffsetValueType q = parent[p];
+    if( p == q || faceRanks[p] != faceRanks[q] )
+      {
+      NodeType * parentNode = NULL;
+      if( p != q )
+        {
+        parentNode = nodes[q];
+        assert( parentNode != NULL );
+        }
+      if( hasPixels[p] )
+        {
+        NodeType * node = new NodeType();
+        node->SetPixel( levels[ faceRanks[p] ] );
+        if( AccumulatorType::Active )
+          {
+          accumulator.Initialize( node );
+          }
+        if( parentNode != NULL )
+          {
+          parentNode->AddChild( node );
+          }
+        else
+          {
+          assert( root == NULL );
+          root = node;
+          }
+        nodes[p] = node;
+        }
+      else
+        {
+        nodes[p] = parentNode;
+        }
+      }
+    progress.CompletedPixel();
+    }
+
+  for( unsigned long i=0; i<numberOfPixels; i++ )
+    {
+    output->NodeAddIndex( nodes[ faces[i] ], i );
+    if( AccumulatorType::Active )
+      {
+      accumulator.AddPixel( nodes[ faces[i] ], i );
+      }
+    }
+
+  if( AccumulatorType::Active )
+    {
+    // merge the attributes of the nodes in their parent, from the last
+    // faces of the propagation
+    for( long i=numberOfFaces-1; i>=0; i-- )
+      {
+      const OffsetValueType p = order[i];
+      const OffsetValueType q = parent[p];
+      if( faceRanks[p] != faceRanks[q] && hasPixels[p] )
+        {
+        accumulator.Merge( nodes[q], nodes[p] );
+        }
+      }
+    }
+
+  // the border has the median value of the pixels of the border, so the
+  // root always has some pixels
+  assert( root != NULL );
+  assert( output->NodeCountIndexes( root ) == numberOfPixels );
+
+  // to be sure that root parent is NULL
+  root->SetParent( NULL );
+
+  // keep a pointer on the root node
+  output->SetRoot( root );
+}
+
+
+template<class TInputImage, class TOutputImage, class TAccumulator>
+template<class TRank>
+void
+ImageToTreeOfShapesFilter<TInputImage, TOutputImage, TAccumulator>
+::Upsample( const SizeType & inputSize, const std::vector< TRank > & inputLower,
+            const std::vector< TRank > & inputUpper, SizeType & outputSize,
+            std::vector< TRank > & outputLower, std::vector< TRank > & outputUpper ) const
+{
+  OffsetValueType inputStrides[ImageDimension];
+  ComputeStrides( inputSize, inputStrides );
+  for( unsigned int d=0; d<ImageDimension; d++ )
+    {
+    outputSize[d] = 2 * inputSize[d] - 1;
+    }
+  OffsetValueType outputStrides[ImageDimension];
+  const unsigned long numberOfSamples = ComputeStrides( outputSize, outputStrides );
+  outputLower.resize( numberOfSamples );
+  outputUpper.resize( numberOfSamples );
+
+  // a sample with an odd coordinate is between two samples of the input
+  // grid in that dimension
+  IndexType idx;
+  unsigned int odd[ImageDimension];
+  for( unsigned long i=0; i<numberOfSamples; i++ )
+    {
+    ComputeIndex( i, outputStrides, idx );
+    OffsetValueType base = 0;
+    unsigned int numberOfOdd = 0;
+    for( unsigned int d=0; d<ImageDimension; d++ )
+      {
+      base += ( idx[d] / 2 ) * inputStrides[d];
+      if( idx[d] % 2 )
+        {
+        odd[ numberOfOdd++ ] = d;
+        }
+      }
+    TRank l = inputLower[ base ];
+    TRank u = inputUpper[ base ];
+    for( unsigned int m=1; m<( 1u << numberOfOdd ); m++ )
+      {
+      OffsetValueType o = base;
+      for( unsigned int j=0; j<numberOfOdd; j++ )
+        {
+        if( m & ( 1u << j ) )
+          {
+          o += inputStrides[ odd[j] ];
+          }
+        }
+      l = std::min( l, inputLower[o] );
+      u = std::max( u, inputUpper[o] );
+      }
+    outputLower[i] = l;
+    outputUpper[i] = u;
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TAccumulator>
+void
+ImageToTreeOfShapesFilter<TInputImage, TOutputImage, TAccumulator>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FullyConnected: "  << m_FullyConnected << std::endl;
+  os << indent << "RunLengthEncoding: "  << m_RunLengthEncoding << std::endl;
+}
+
+}// end namespace itk
+#endif
@@ -56,6 +56,9 @@ namespace itk
  * manage memory using (and perhaps overriding) the implementations of
  * ReleaseInputs() and AllocateOutputs() provided here.
  *
+ * AllocateOutputs() decodes the output tree when it is run-length encoded,
+ * so the subclasses can always use the linked list array.
+ *
  * \ingroup ImageFilters
  */
 template <class TInputImage>
@@ -85,9 +85,15 @@ InPlaceComponentTreeFilter<TInputImage>
     {
     Superclass::AllocateOutputs();
     // copy the content of the input image to the output image
+    const typename InputImageType::ContainerType * inputContainer = this->GetInput()->GetContainer();
+    typename OutputImageType::ContainerType * outputContainer = this->GetOutput()->GetContainer();
     this->GetOutput()->SetRoot( this->GetInput()->GetRoot()->Clone() );
-    this->GetOutput()->GetLinkedListArray() = this->GetInput()->GetLinkedListArray();
+    outputContainer->GetLinkedListArray() = inputContainer->GetLinkedListArray();
+    outputContainer->GetRuns() = inputContainer->GetRuns();
+    outputContainer->SetRunLengthEncoded( inputContainer->GetRunLengthEncoded() );
     }
+  // the subclasses modify the pixels of the nodes with the linked list array
+  this->GetOutput()->DecodeRunLength();
 }
 
 template<class TInputImage>
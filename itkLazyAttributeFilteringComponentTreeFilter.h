@@ -0,0 +1,478 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkLazyAttributeFilteringComponentTreeFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkLazyAttributeFilteringComponentTreeFilter_h
+#define __itkLazyAttributeFilteringComponentTreeFilter_h
+
+#include "itkAttributeFilteringComponentTreeFilter.h"
+#include "itkMatrix.h"
+#include "itkVector.h"
+#include "vnl/algo/vnl_symmetric_eigensystem.h"
+#include <vector>
+#include <algorithm>
+
+namespace itk {
+
+/** \class ComponentTreeNodeMemo
+ * \brief Store a value for some of the nodes of a component tree
+ *
+ * The values are stored in a vector, in the order they are set, and the
+ * position of the value of a node is stored at the offset of the last pixel
+ * of the node. When a node is merged in another one, the pixels of the
+ * merged node are added at the beginning of the pixel list of the other, so
+ * the last pixel of the nodes which are kept doesn't change, and their
+ * value is still found. The nodes must have some pixels.
+ *
+ * Initialize() allocates one position per pixel of the tree. The memo
+ * must be cleared when the nodes are deleted or modified.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa LazyAttributeFilteringComponentTreeFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template< class TNode, class TValue >
+class ITK_EXPORT ComponentTreeNodeMemo
+{
+public:
+  typedef TNode NodeType;
+  typedef TValue ValueType;
+
+  void Initialize( unsigned long numberOfPixels )
+    {
+    m_Positions.assign( numberOfPixels, -1 );
+    m_Values.clear();
+    }
+
+  bool IsInitialized() const
+    {
+    return !m_Positions.empty();
+    }
+
+  /** Forget all the values, and release the memory */
+  void Clear()
+    {
+    std::vector< long >().swap( m_Positions );
+    std::vector< ValueType >().swap( m_Values );
+    }
+
+  inline bool Contains( const NodeType * node ) const
+    {
+    assert( node->GetLastIndex() != NodeType::EndIndex );
+    return m_Positions[ node->GetLastIndex() ] >= 0;
+    }
+
+  /** Return the value of a node, which must be in the memo */
+  inline const ValueType & Get( const NodeType * node ) const
+    {
+    assert( this->Contains( node ) );
+    return m_Values[ m_Positions[ node->GetLastIndex() ] ];
+    }
+
+  /** Return the value of a node, after adding the node to the memo with a
+   * default value if it is not there */
+  inline ValueType & Set( const NodeType * node )
+    {
+    long & position = m_Positions[ node->GetLastIndex() ];
+    if( position < 0 )
+      {
+      position = m_Values.size();
+      m_Values.push_back( ValueType() );
+      }
+    return m_Values[ position ];
+    }
+
+  /** Forget the value of a node */
+  inline void Erase( const NodeType * node )
+    {
+    m_Positions[ node->GetLastIndex() ] = -1;
+    }
+
+private:
+  std::vector< long > m_Positions;
+  std::vector< ValueType > m_Values;
+};
+
+
+namespace Functor {
+
+/**
+ * Compute the number of pixels of a node and its children. The number of
+ * pixels of each node is memoized, so the one of a node is the number of
+ * its own pixels plus the memoized values of its children.
+ */
+template< class TImage >
+class ITK_EXPORT NumberOfPixelsComponentTreeNodeFunction
+{
+public:
+  typedef TImage ImageType;
+  typedef typename ImageType::NodeType NodeType;
+  typedef unsigned long AttributeType;
+
+  inline AttributeType operator()( const ImageType * tree, const NodeType * node ) const
+    {
+    if( !m_Counts.IsInitialized() )
+      {
+      m_Counts.Initialize( tree->GetLargestPossibleRegion().GetNumberOfPixels() );
+      }
+
+    // compute the missing values from the deepest nodes, without recursion
+    std::vector< const NodeType * > stack;
+    stack.push_back( node );
+    while( !stack.empty() )
+      {
+      const NodeType * n = stack.back();
+      if( m_Counts.Contains( n ) )
+        {
+        stack.pop_back();
+        continue;
+        }
+      bool ready = true;
+      const typename NodeType::ChildrenListType & children = n->GetChildren();
+      for( typename NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+        {
+        if( !m_Counts.Contains( *it ) )
+          {
+          stack.push_back( *it );
+          ready = false;
+          }
+        }
+      if( ready )
+        {
+        stack.pop_back();
+        AttributeType count = tree->NodeCountOwnIndexes( n );
+        for( typename NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+          {
+          count += m_Counts.Get( *it );
+          }
+        m_Counts.Set( n ) = count;
+        }
+      }
+    return m_Counts.Get( node );
+    }
+
+  /** Forget the memoized values */
+  void Clear()
+    {
+    m_Counts.Clear();
+    }
+
+  /** Forget the memoized values of a node and of its ancestors */
+  void Invalidate( const NodeType * node )
+    {
+    for( ; node != NULL && m_Counts.IsInitialized(); node = node->GetParent() )
+      {
+      m_Counts.Erase( node );
+      }
+    }
+
+private:
+  mutable ComponentTreeNodeMemo< NodeType, AttributeType > m_Counts;
+};
+
+/**
+ * Compute the compactness of a node and its children, as done by
+ * CompactnessComponentTreeFilter. The moments of each node are memoized, so
+ * the ones of a node are computed from its own pixels and from the
+ * memoized moments of its children.
+ */
+template< class TImage >
+class ITK_EXPORT CompactnessComponentTreeNodeFunction
+{
+public:
+  typedef TImage ImageType;
+  typedef typename ImageType::NodeType NodeType;
+  typedef typename ImageType::IndexType IndexType;
+  typedef typename ImageType::PointType PointType;
+  typedef double AttributeType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  typedef Matrix< double, ImageDimension, ImageDimension >   MatrixType;
+  typedef Vector< double, ImageDimension > VectorType;
+
+  /** The non normalized moments of the pixels of a node and its children */
+  struct MomentsType
+    {
+    double     Sum;
+    VectorType FirstOrder;
+    MatrixType SecondOrder;
+    };
+
+  AttributeType operator()( const ImageType * tree, const NodeType * node ) const
+    {
+    if( !m_Moments.IsInitialized() )
+      {
+      m_Moments.Initialize( tree->GetLargestPossibleRegion().GetNumberOfPixels() );
+      }
+
+    // compute the missing moments from the deepest nodes, without recursion
+    std::vector< const NodeType * > stack;
+    stack.push_back( node );
+    while( !stack.empty() )
+      {
+      const NodeType * n = stack.back();
+      if( m_Moments.Contains( n ) )
+        {
+        stack.pop_back();
+        continue;
+        }
+      bool ready = true;
+      const typename NodeType::ChildrenListType & children = n->GetChildren();
+      for( typename NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+        {
+        if( !m_Moments.Contains( *it ) )
+          {
+          stack.push_back( *it );
+          ready = false;
+          }
+        }
+      if( ready )
+        {
+        stack.pop_back();
+        this->ComputeMoments( tree, n );
+        }
+      }
+
+    const MomentsType & moments = m_Moments.Get( node );
+    const double sum = moments.Sum;
+    if( sum == 0.0 )
+      {
+      return 0.0;
+      }
+
+    // normalize using the total mass and center the second order moments
+    VectorType cog;
+    for(unsigned int i=0; i<ImageDimension; i++)
+      {
+      cog[i] = moments.FirstOrder[i] / sum;
+      }
+    MatrixType cm;
+    for(unsigned int i=0; i<ImageDimension; i++)
+      {
+      for(unsigned int j=0; j<ImageDimension; j++)
+        {
+        cm[i][j] = moments.SecondOrder[i][j] / sum - cog[i] * cog[j];
+        }
+      }
+
+    vnl_symmetric_eigensystem<double> eigen( cm.GetVnlMatrix() );
+    const vnl_diag_matrix<double> & pm = eigen.D;
+
+    double compactness = 1.0;
+    if( pm(ImageDimension-1, ImageDimension-1) != 0 )
+      {
+      compactness = vcl_sqrt( pm(0, 0) / pm(ImageDimension-1, ImageDimension-1) );
+      }
+    return std::max( 0.0, std::min( 1.0, compactness ) );
+    }
+
+  /** Forget the memoized moments */
+  void Clear()
+    {
+    m_Moments.Clear();
+    }
+
+  /** Forget the memoized moments of a node and of its ancestors */
+  void Invalidate( const NodeType * node )
+    {
+    for( ; node != NULL && m_Moments.IsInitialized(); node = node->GetParent() )
+      {
+      m_Moments.Erase( node );
+      }
+    }
+
+private:
+  /** Compute the moments of a node from its own pixels and the moments of
+   * its children, which must be already known */
+  void ComputeMoments( const ImageType * tree, const NodeType * node ) const
+    {
+    MomentsType & moments = m_Moments.Set( node );
+    moments.Sum = 0;
+    moments.FirstOrder.Fill( 0 );
+    moments.SecondOrder.Fill( 0 );
+
+    const typename NodeType::ChildrenListType & children = node->GetChildren();
+    for( typename NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+      {
+      const MomentsType & childMoments = m_Moments.Get( *it );
+      moments.Sum += childMoments.Sum;
+      moments.FirstOrder += childMoments.FirstOrder;
+      moments.SecondOrder += childMoments.SecondOrder;
+      }
+
+    for( typename NodeType::IndexType current=node->GetFirstIndex();
+       current != NodeType::EndIndex;
+       current = tree->GetLinkedListArray()[ current ] )
+      {
+      IndexType idx = tree->ComputeIndex( current );
+      moments.Sum += 1;
+      PointType physicalPosition;
+      tree->TransformIndexToPhysicalPoint(idx, physicalPosition);
+      for(unsigned int i=0; i<ImageDimension; i++)
+        {
+        moments.FirstOrder[i] += physicalPosition[i];
+        moments.SecondOrder[i][i] += physicalPosition[i] * physicalPosition[i];
+        for(unsigned int j=i+1; j<ImageDimension; j++)
+          {
+          double weight = physicalPosition[i] * physicalPosition[j];
+          moments.SecondOrder[i][j] += weight;
+          moments.SecondOrder[j][i] += weight;
+          }
+        }
+      }
+    }
+
+  mutable ComponentTreeNodeMemo< NodeType, MomentsType > m_Moments;
+};
+
+}
+
+
+/** \class LazyAttributeFilteringComponentTreeFilter
+ * \brief Remove some nodes based on an attribute computed on demand
+ *
+ * This filter behaves like AttributeFilteringComponentTreeFilter, but the
+ * attribute is not read from the nodes: it is computed by the attribute
+ * function only for the nodes visited by the filtering algorithm, and is
+ * memoized in the node with the attribute accessor. With the MAXIMUM
+ * filtering type, the nodes below a removed node are never evaluated, and
+ * all the nodes of the output tree but the root have their attribute
+ * computed. The attribute of a node usually depends on all the pixels of
+ * its subtree, so the function still has to read the pixels of the nodes
+ * which are not evaluated: only the final computation of the attribute,
+ * like the eigen analysis of the moments for the compactness, is saved for
+ * them.
+ *
+ * The attribute function is called with the tree and the node, and must
+ * only depend on the pixels of the node and of its descendants. Merging a
+ * removed node in its parent doesn't change the pixels of the parent's
+ * subtree, so the memoized values stay valid during the filtering. The
+ * function can keep some partial results of the nodes, like the number of
+ * pixels or the moments, to compute the attribute of a node from the ones
+ * of its children rather than from all the pixels of its subtree. It must
+ * provide a Clear() method to forget them: the filter calls it before and
+ * after each update, because the nodes are deleted or modified between the
+ * updates. It must also provide an Invalidate( node ) method, to forget the
+ * partial results of a node and of its ancestors. See
+ * NumberOfPixelsComponentTreeNodeFunction and
+ * CompactnessComponentTreeNodeFunction, which store their partial results
+ * in a ComponentTreeNodeMemo.
+ *
+ * GetNumberOfEvaluations() gives the number of nodes for which the attribute
+ * function has been called during the last update.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \sa AttributeFilteringComponentTreeFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TImage, class TAttributeFunction, class TAttibuteAccessor=typename Functor::AttributeComponentTreeNodeAccessor< typename TImage::NodeType > >
+class ITK_EXPORT LazyAttributeFilteringComponentTreeFilter :
+    public AttributeFilteringComponentTreeFilter<TImage, TAttibuteAccessor>
+{
+public:
+  /** Standard class typedefs. */
+  typedef LazyAttributeFilteringComponentTreeFilter Self;
+  typedef AttributeFilteringComponentTreeFilter<TImage, TAttibuteAccessor> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TImage ImageType;
+  typedef typename ImageType::Pointer         ImagePointer;
+  typedef typename ImageType::ConstPointer    ImageConstPointer;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::NodeType        NodeType;
+  typedef typename ImageType::IndexType       IndexType;
+
+  typedef TAttibuteAccessor AttributeAccessorType;
+  typedef typename AttributeAccessorType::AttributeType   AttributeType;
+
+  typedef TAttributeFunction AttributeFunctionType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(LazyAttributeFilteringComponentTreeFilter,
+               AttributeFilteringComponentTreeFilter);
+
+  /** Get/Set the function used to compute the attribute of a node */
+  AttributeFunctionType & GetAttributeFunction()
+    {
+    return m_AttributeFunction;
+    }
+  const AttributeFunctionType & GetAttributeFunction() const
+    {
+    return m_AttributeFunction;
+    }
+  void SetAttributeFunction( const AttributeFunctionType & function )
+    {
+    m_AttributeFunction = function;
+    this->Modified();
+    }
+
+  /** Get the number of nodes evaluated during the last update */
+  itkGetConstMacro(NumberOfEvaluations, unsigned long);
+
+  /** Forget the memoized attribute of a node and of its ancestors, and the
+   * partial results of the attribute function for them. It must be called
+   * by the subclasses which modify the pixels of a node during the
+   * filtering. */
+  void InvalidateNodeAttribute( const NodeType * node );
+
+protected:
+  LazyAttributeFilteringComponentTreeFilter();
+  ~LazyAttributeFilteringComponentTreeFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Single-threaded version of GenerateData.  This filter delegates
+   * to GrayscaleGeodesicErodeImageFilter. */
+  void GenerateData();
+
+  /** Compute the attribute of the node on the first call, and return
+   * the memoized value after that */
+  virtual AttributeType GetNodeAttribute( NodeType * node );
+
+private:
+  LazyAttributeFilteringComponentTreeFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  typedef ComponentTreeNodeMemo< NodeType, AttributeType > CacheType;
+
+  AttributeFunctionType m_AttributeFunction;
+
+  CacheType m_Cache;
+
+  unsigned long m_NumberOfEvaluations;
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLazyAttributeFilteringComponentTreeFilter.txx"
+#endif
+
+#endif
+
+
@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkLazyAttributeFilteringComponentTreeFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkLazyAttributeFilteringComponentTreeFilter_txx
+#define __itkLazyAttributeFilteringComponentTreeFilter_txx
+
+#include "itkLazyAttributeFilteringComponentTreeFilter.h"
+
+
+namespace itk {
+
+template <class TInputImage, class TAttributeFunction, class TAccessor>
+LazyAttributeFilteringComponentTreeFilter<TInputImage, TAttributeFunction, TAccessor>
+::LazyAttributeFilteringComponentTreeFilter()
+{
+  m_NumberOfEvaluations = 0;
+}
+
+
+template<class TInputImage, class TAttributeFunction, class TAccessor>
+void
+LazyAttributeFilteringComponentTreeFilter<TInputImage, TAttributeFunction, TAccessor>
+::GenerateData()
+{
+  m_Cache.Clear();
+  m_AttributeFunction.Clear();
+  m_NumberOfEvaluations = 0;
+
+  Superclass::GenerateData();
+
+  // the removed nodes have been deleted and the others modified - don't
+  // keep their values
+  m_Cache.Clear();
+  m_AttributeFunction.Clear();
+}
+
+
+template<class TInputImage, class TAttributeFunction, class TAccessor>
+typename LazyAttributeFilteringComponentTreeFilter<TInputImage, TAttributeFunction, TAccessor>::AttributeType
+LazyAttributeFilteringComponentTreeFilter<TInputImage, TAttributeFunction, TAccessor>
+::GetNodeAttribute( NodeType * node )
+{
+  assert(node != NULL);
+
+  if( !m_Cache.IsInitialized() )
+    {
+    m_Cache.Initialize( this->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels() );
+    }
+  if( m_Cache.Contains( node ) )
+    {
+    return m_Cache.Get( node );
+    }
+
+  AttributeType attribute = static_cast< AttributeType >( m_AttributeFunction( this->GetOutput(), node ) );
+  m_NumberOfEvaluations++;
+
+  // store the value in the node, so it is available to the downstream filters
+  AttributeAccessorType accessor;
+  accessor( node, attribute );
+  m_Cache.Set( node ) = attribute;
+
+  return attribute;
+}
+
+
+template<class TInputImage, class TAttributeFunction, class TAccessor>
+void
+LazyAttributeFilteringComponentTreeFilter<TInputImage, TAttributeFunction, TAccessor>
+::InvalidateNodeAttribute( const NodeType * node )
+{
+  // the attribute of the ancestors depends on the pixels of the node
+  for( const NodeType * n=node; n != NULL && m_Cache.IsInitialized(); n = n->GetParent() )
+    {
+    m_Cache.Erase( n );
+    }
+  m_AttributeFunction.Invalidate( node );
+}
+
+
+template<class TInputImage, class TAttributeFunction, class TAccessor>
+void
+LazyAttributeFilteringComponentTreeFilter<TInputImage, TAttributeFunction, TAccessor>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfEvaluations: " << m_NumberOfEvaluations << std::endl;
+}
+
+}// end namespace itk
+#endif
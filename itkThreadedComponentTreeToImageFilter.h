@@ -0,0 +1,151 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkThreadedComponentTreeToImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/03/28 19:59:05 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkThreadedComponentTreeToImageFilter_h
+#define __itkThreadedComponentTreeToImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+#include <vector>
+#include <utility>
+
+namespace itk {
+
+/** \class ThreadedComponentTreeToImageFilter
+ * \brief Base class for the filters which write a value per node of a component tree in an image
+ *
+ * The tree is traversed once to collect the nodes and the value to write
+ * for each of them, with CollectNodes() and GetNodeValue(). The pixels of
+ * the nodes are then written by several threads, directly in the buffer of
+ * the output image, at the offset stored in the linked list of the tree.
+ *
+ * The work is split by nodes rather than by output region, because there is
+ * no way to find the node of a pixel without traversing the tree first. Each
+ * pixel belongs to a single node, so the threads never write the same
+ * pixel. The threads take the nodes by small groups, as long as there are
+ * some nodes left, to balance the work when the nodes are of very
+ * different sizes.
+ *
+ * Only the requested region of the output is allocated and written, so
+ * the output can be streamed, for example by an ImageFileWriter, while the
+ * whole tree stays in memory. When the requested region is the largest
+ * possible region, the offsets of the linked list are used directly in the
+ * output buffer; otherwise the index of each pixel is computed and the
+ * pixels out of the requested region are skipped. All the pixels of the
+ * tree are still visited for each requested region.
+ *
+ * When the tree is run-length encoded, the runs are written with
+ * std::fill, and only the runs, not the pixels, are visited for each
+ * requested region.
+ *
+ * The subclasses must implement GetNodeValue(), and can override
+ * CollectNodes() when the value of a node depends on the other nodes.
+ *
+ * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
+ *
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+template<class TInputImage, class TOutputImage>
+class ITK_EXPORT ThreadedComponentTreeToImageFilter :
+    public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThreadedComponentTreeToImageFilter Self;
+  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename InputImageType::Pointer         InputImagePointer;
+  typedef typename InputImageType::ConstPointer    InputImageConstPointer;
+  typedef typename InputImageType::RegionType      InputImageRegionType;
+  typedef typename InputImageType::PixelType       InputImagePixelType;
+  typedef typename OutputImageType::Pointer        OutputImagePointer;
+  typedef typename OutputImageType::ConstPointer   OutputImageConstPointer;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+  typedef typename InputImageType::NodeType        NodeType;
+  typedef typename InputImageType::AttributeType   AttributeType;
+  typedef typename OutputImageType::IndexType      IndexType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Runtime information support. */
+  itkTypeMacro(ThreadedComponentTreeToImageFilter,
+               ImageToImageFilter);
+
+protected:
+  ThreadedComponentTreeToImageFilter();
+  ~ThreadedComponentTreeToImageFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** ThreadedComponentTreeToImageFilter needs the entire input be
+   * available. Thus, it needs to provide an implementation of
+   * GenerateInputRequestedRegion(). */
+  void GenerateInputRequestedRegion() ;
+
+  /** Collect the nodes, then write them with several threads. */
+  void GenerateData();
+
+  /** Add the node and its subtree to the nodes to write. The default
+   * implementation adds all the nodes, with the value returned by
+   * GetNodeValue(). */
+  virtual void CollectNodes( const NodeType * node );
+
+  /** Return the value to write for the pixels of a node */
+  virtual OutputImagePixelType GetNodeValue( const NodeType * node ) = 0;
+
+  /** Add a node to write with the given value */
+  void AddNode( const NodeType * node, const OutputImagePixelType & value )
+    {
+    m_Nodes.push_back( NodeValuePairType( node, value ) );
+    }
+
+  /** Write the nodes taken by a thread */
+  void ThreadedWriteNodes( int threadId );
+
+  static ITK_THREAD_RETURN_TYPE WriteNodesThreaderCallback( void * arg );
+
+private:
+  ThreadedComponentTreeToImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  typedef std::pair< const NodeType *, OutputImagePixelType > NodeValuePairType;
+  typedef std::vector< NodeValuePairType > NodeValuePairsType;
+
+  NodeValuePairsType m_Nodes;
+
+  // the next node to be taken by a thread
+  unsigned long m_NextNode;
+  SimpleFastMutexLock m_NextNodeLock;
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkThreadedComponentTreeToImageFilter.txx"
+#endif
+
+#endif
+
+
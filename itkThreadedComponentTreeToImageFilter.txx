@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkThreadedComponentTreeToImageFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2005/08/23 15:09:03 $
+  Version:   $Revision: 1.6 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkThreadedComponentTreeToImageFilter_txx
+#define __itkThreadedComponentTreeToImageFilter_txx
+
+#include "itkThreadedComponentTreeToImageFilter.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+
+
+namespace itk {
+
+template <class TInputImage, class TOutputImage>
+ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
+::ThreadedComponentTreeToImageFilter()
+{
+  m_NextNode = 0;
+}
+
+
+template <class TInputImage, class TOutputImage>
+void
+ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
+::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  // We need all the input.
+  InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
+
+  if ( !input )
+    { return; }
+
+  input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
+::GenerateData()
+{
+  // Allocate the output
+  this->AllocateOutputs();
+  ProgressReporter progress(this, 0, 2);
+
+  m_Nodes.clear();
+  this->CollectNodes( this->GetInput()->GetRoot() );
+  progress.CompletedPixel();
+
+  // don't use more threads than nodes
+  int numberOfThreads = this->GetNumberOfThreads();
+  if( static_cast< unsigned long >( numberOfThreads ) > m_Nodes.size() )
+    {
+    numberOfThreads = std::max( 1, static_cast< int >( m_Nodes.size() ) );
+    }
+
+  m_NextNode = 0;
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( numberOfThreads );
+  threader->SetSingleMethod( this->WriteNodesThreaderCallback, this );
+  threader->SingleMethodExecute();
+  progress.CompletedPixel();
+
+  // release the temporary data
+  NodeValuePairsType().swap( m_Nodes );
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
+::CollectNodes( const NodeType * node )
+{
+  assert(node != NULL);
+  this->AddNode( node, this->GetNodeValue( node ) );
+
+  const typename NodeType::ChildrenListType * childrenList = & node->GetChildren();
+  for( typename NodeType::ChildrenListType::const_iterator it=childrenList->begin(); it!=childrenList->end(); it++ )
+    {
+    this->CollectNodes( *it );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
+::ThreadedWriteNodes( int itkNotUsed(threadId) )
+{
+  // the nodes are taken by groups to not lock the mutex too often
+  const unsigned long groupSize = 64;
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
+  OutputImagePixelType * buffer = output->GetBufferPointer();
+  const typename InputImageType::LinkedListArrayType & linkedList = input->GetLinkedListArray();
+
+  // when the output buffer is the largest possible region of the input, the
+  // offsets in the linked list can be used directly
+  const OutputImageRegionType & outputRegion = output->GetBufferedRegion();
+  const bool fullOutput = ( outputRegion == input->GetLargestPossibleRegion() );
+  const bool runLengthEncoded = input->IsRunLengthEncoded();
+
+  while( true )
+    {
+    m_NextNodeLock.Lock();
+    const unsigned long begin = m_NextNode;
+    m_NextNode = std::min( static_cast< unsigned long >( m_Nodes.size() ), begin + groupSize );
+    const unsigned long end = m_NextNode;
+    m_NextNodeLock.Unlock();
+
+    if( begin == end )
+      {
+      return;
+      }
+
+    for( unsigned long i=begin; i<end; i++ )
+      {
+      const NodeType * node = m_Nodes[i].first;
+      const OutputImagePixelType & v = m_Nodes[i].second;
+      if( runLengthEncoded )
+        {
+        // write the whole runs at once, clipped to the output region
+        for( typename InputImageType::RunConstIterator it=input->NodeRunsBegin( node );
+             it!=input->NodeRunsEnd( node );
+             it++ )
+          {
+          if( fullOutput )
+            {
+            std::fill( buffer + it->Offset, buffer + it->Offset + it->Length, v );
+            }
+          else
+            {
+            IndexType idx = input->ComputeIndex( it->Offset );
+            const long runEnd = std::min( idx[0] + static_cast< long >( it->Length ),
+                                          outputRegion.GetIndex()[0] + static_cast< long >( outputRegion.GetSize()[0] ) );
+            idx[0] = std::max( idx[0], outputRegion.GetIndex()[0] );
+            if( idx[0] < runEnd && outputRegion.IsInside( idx ) )
+              {
+              OutputImagePixelType * runBegin = buffer + output->ComputeOffset( idx );
+              std::fill( runBegin, runBegin + ( runEnd - idx[0] ), v );
+              }
+            }
+          }
+        }
+      else if( fullOutput )
+        {
+        for( typename NodeType::IndexType current=node->GetFirstIndex();
+             current != NodeType::EndIndex;
+             current = linkedList[ current ] )
+          {
+          buffer[ current ] = v;
+          }
+        }
+      else
+        {
+        for( typename NodeType::IndexType current=node->GetFirstIndex();
+             current != NodeType::EndIndex;
+             current = linkedList[ current ] )
+          {
+          const IndexType idx = input->ComputeIndex( current );
+          if( outputRegion.IsInside( idx ) )
+            {
+            buffer[ output->ComputeOffset( idx ) ] = v;
+            }
+          }
+        }
+      }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage>
+ITK_THREAD_RETURN_TYPE
+ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
+::WriteNodesThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self * filter = static_cast< Self * >( info->UserData );
+  filter->ThreadedWriteNodes( info->ThreadID );
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+template<class TInputImage, class TOutputImage>
+void
+ThreadedComponentTreeToImageFilter<TInputImage, TOutputImage>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+}
+
+}// end namespace itk
+#endif
@@ -0,0 +1,163 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkLazyAttributeFilteringComponentTreeFilter.h"
+#include "itkComponentTreeToImageFilter.h"
+#include "itkCompactnessComponentTreeFilter.h"
+#include "itkAttributeFilteringComponentTreeFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include <vector>
+
+// the number of nodes of the tree
+template< class TTree >
+unsigned long CountNodes( const TTree * tree )
+{
+  unsigned long count = 0;
+  std::vector< const typename TTree::NodeType * > stack;
+  stack.push_back( tree->GetRoot() );
+  while( !stack.empty() )
+    {
+    const typename TTree::NodeType * node = stack.back();
+    stack.pop_back();
+    count++;
+    stack.insert( stack.end(), node->GetChildren().begin(), node->GetChildren().end() );
+    }
+  return count;
+}
+
+// the number of nodes visited by the MAXIMUM filtering: the children of the
+// kept nodes
+template< class TTree >
+unsigned long CountMaximumVisits( const TTree * tree, double lambda )
+{
+  unsigned long count = 0;
+  std::vector< const typename TTree::NodeType * > stack;
+  stack.push_back( tree->GetRoot() );
+  while( !stack.empty() )
+    {
+    const typename TTree::NodeType * node = stack.back();
+    stack.pop_back();
+    const typename TTree::NodeType::ChildrenListType & children = node->GetChildren();
+    for( typename TTree::NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+      {
+      count++;
+      if( !( (*it)->GetAttribute() < lambda ) )
+        {
+        stack.push_back( *it );
+        }
+      }
+    }
+  return count;
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 6 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity compactness type" << std::endl;
+    std::cerr << "  inputImage: an input image." << std::endl;
+    std::cerr << "  outputImage: the filtered image." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  compactness: the compactness of the components to remove" << std::endl;
+    std::cerr << "  type: the filtering type (can be Direct, Minimum, Maximum or Subtract)" << std::endl;
+    exit(1);
+    }
+
+  const int dim = 2;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, double > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[3] ) );
+
+  // the compactness is only computed for the nodes visited by the filter
+  typedef itk::Functor::CompactnessComponentTreeNodeFunction< TreeType > FunctionType;
+  typedef itk::LazyAttributeFilteringComponentTreeFilter< TreeType, FunctionType > FilteringType;
+  FilteringType::Pointer filter = FilteringType::New();
+  filter->SetInput( maxtree->GetOutput() );
+  filter->SetInPlace( false );
+  filter->SetLambda( atof( argv[4] ) );
+  filter->SetFilteringType( argv[5] );
+  itk::SimpleFilterWatcher watcher(filter, "filter");
+
+  typedef itk::ComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer filter2 = T2IType::New();
+  filter2->SetInput( filter->GetOutput() );
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( filter2->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  std::cout << "Number of evaluations: " << filter->GetNumberOfEvaluations() << std::endl;
+
+  // the same filtering, with the compactness computed for all the nodes
+  typedef itk::CompactnessComponentTreeFilter< TreeType > CompactnessType;
+  CompactnessType::Pointer compactness = CompactnessType::New();
+  compactness->SetInput( maxtree->GetOutput() );
+  compactness->SetInPlace( false );
+  compactness->Update();
+
+  typedef itk::AttributeFilteringComponentTreeFilter< TreeType > EagerFilteringType;
+  EagerFilteringType::Pointer eager = EagerFilteringType::New();
+  eager->SetInput( compactness->GetOutput() );
+  eager->SetInPlace( false );
+  eager->SetLambda( atof( argv[4] ) );
+  eager->SetFilteringType( argv[5] );
+
+  T2IType::Pointer eager2 = T2IType::New();
+  eager2->SetInput( eager->GetOutput() );
+  eager2->Update();
+
+  // the lazy filter must give the same image
+  typedef itk::ImageRegionConstIterator< IType > IteratorType;
+  IteratorType lIt( filter2->GetOutput(), filter2->GetOutput()->GetLargestPossibleRegion() );
+  IteratorType eIt( eager2->GetOutput(), eager2->GetOutput()->GetLargestPossibleRegion() );
+  for( lIt.GoToBegin(), eIt.GoToBegin(); !lIt.IsAtEnd(); ++lIt, ++eIt )
+    {
+    if( lIt.Get() != eIt.Get() )
+      {
+      std::cerr << "The lazy filtering doesn't match the filtering of the compactness filter." << std::endl;
+      return 1;
+      }
+    }
+
+  // and must evaluate at most each node once. The MAXIMUM filtering only
+  // evaluates the children of the kept nodes, and the DIRECT and SUBTRACT
+  // ones all the nodes but the root.
+  const unsigned long nodes = CountNodes( compactness->GetOutput() );
+  unsigned long expected = nodes;
+  if( filter->GetFilteringType() == FilteringType::MAXIMUM )
+    {
+    expected = CountMaximumVisits( compactness->GetOutput(), atof( argv[4] ) );
+    }
+  else if( filter->GetFilteringType() == FilteringType::DIRECT
+           || filter->GetFilteringType() == FilteringType::SUBTRACT )
+    {
+    expected = nodes - 1;
+    }
+  if( filter->GetFilteringType() == FilteringType::MINIMUM
+      ? filter->GetNumberOfEvaluations() > expected
+      : filter->GetNumberOfEvaluations() != expected )
+    {
+    std::cerr << "Unexpected number of evaluations: " << filter->GetNumberOfEvaluations()
+              << " for " << nodes << " nodes, expected " << expected << std::endl;
+    return 1;
+    }
+
+  return 0;
+}
+
@@ -0,0 +1,87 @@
+#include "itkImageFileReader.h"
+#include "itkTimeProbe.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkImageToMinimumTreeFilter.h"
+#include "itkImageToMaximumAndMinimumTreeFilter.h"
+
+// build the max tree and the min tree of an image with the two filters, one
+// after the other, then with ImageToMaximumAndMinimumTreeFilter
+template< class TPixel >
+void Benchmark( const char * fileName, bool fullyConnected, int nbOfRuns, const char * typeName )
+{
+  const int dim = 3;
+
+  typedef itk::Image< TPixel, dim > IType;
+  typedef itk::ComponentTree< TPixel, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->Update();
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxFilterType;
+  typename MaxFilterType::Pointer maxFilter = MaxFilterType::New();
+  maxFilter->SetInput( reader->GetOutput() );
+  maxFilter->SetFullyConnected( fullyConnected );
+
+  typedef itk::ImageToMinimumTreeFilter< IType, TreeType > MinFilterType;
+  typename MinFilterType::Pointer minFilter = MinFilterType::New();
+  minFilter->SetInput( reader->GetOutput() );
+  minFilter->SetFullyConnected( fullyConnected );
+
+  typedef itk::ImageToMaximumAndMinimumTreeFilter< IType, TreeType > MaxMinFilterType;
+  typename MaxMinFilterType::Pointer maxMinFilter = MaxMinFilterType::New();
+  maxMinFilter->SetInput( reader->GetOutput() );
+  maxMinFilter->SetFullyConnected( fullyConnected );
+
+  itk::TimeProbe separateTime;
+  for( int i=0; i<nbOfRuns; i++ )
+    {
+    maxFilter->Modified();
+    minFilter->Modified();
+    separateTime.Start();
+    maxFilter->Update();
+    minFilter->Update();
+    separateTime.Stop();
+    }
+
+  itk::TimeProbe dualTime;
+  for( int i=0; i<nbOfRuns; i++ )
+    {
+    maxMinFilter->Modified();
+    dualTime.Start();
+    maxMinFilter->Update();
+    dualTime.Stop();
+    }
+
+  std::cout << typeName << "\t" << "max tree + min tree" << "\t" << separateTime.GetMeanTime() << std::endl;
+  std::cout << typeName << "\t" << "max and min tree" << "\t" << dualTime.GetMeanTime() << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc < 3 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity [nbOfRuns]" << std::endl;
+    std::cerr << "  inputImage: an input image (up to dim=3)" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  nbOfRuns: the number of times the trees are built with each method. Default is 10." << std::endl;
+    exit(1);
+    }
+
+  int nbOfRuns = 10;
+  if( argc > 3 )
+    {
+    nbOfRuns = atoi( argv[3] );
+    }
+
+  // the pixels are sorted once for the float images, and the trees are
+  // built with Flooding for the unsigned char images
+  std::cout << "pixel type" << "\t" << "method" << "\t" << "mean time (s)" << std::endl;
+  Benchmark< unsigned char >( argv[1], atoi( argv[2] ), nbOfRuns, "unsigned char" );
+  Benchmark< float >( argv[1], atoi( argv[2] ), nbOfRuns, "float" );
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumAndMinimumTreeFilter.h"
+#include "itkComponentTreeToImageFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc != 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage maxOutputImage minOutputImage connectivity" << std::endl;
+    std::cerr << "  inputImage: an input image (up to dim=3)" << std::endl;
+    std::cerr << "  maxOutputImage: the image reconstructed from the max tree" << std::endl;
+    std::cerr << "  minOutputImage: the image reconstructed from the min tree" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    exit(1);
+    }
+    
+  const int dim = 3;
+  
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  // both trees are built with a single sort of the pixels
+  typedef itk::ImageToMaximumAndMinimumTreeFilter< IType, TreeType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( reader->GetOutput() );
+  filter->SetFullyConnected( atoi( argv[4] ) );
+  itk::SimpleFilterWatcher watcher(filter, "max and min trees");
+
+  typedef itk::ComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer maxToImage = T2IType::New();
+  maxToImage->SetInput( filter->GetMaximumTree() );
+
+  T2IType::Pointer minToImage = T2IType::New();
+  minToImage->SetInput( filter->GetMinimumTree() );
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( maxToImage->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  writer->SetInput( minToImage->GetOutput() );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  return 0;
+}
+
@@ -0,0 +1,55 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkComponentTreeToImageFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc != 6 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity size algorithm" << std::endl;
+    std::cerr << "  inputImage: an input image (up to dim=3)." << std::endl;
+    std::cerr << "  outputImage: the image reconstructed from the pruned tree." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  size: the minimum size of the components kept in the tree" << std::endl;
+    std::cerr << "  algorithm: the algorithm used to build the tree" << std::endl;
+    exit(1);
+    }
+    
+  const int dim = 3;
+  
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  // the small components are removed while the tree is built, as an
+  // opening on the number of pixels would do after the construction
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[3] ) );
+  maxtree->SetMinimumSize( atoi( argv[4] ) );
+  maxtree->SetAlgorithm( argv[5] );
+  itk::SimpleFilterWatcher watcher(maxtree, "max-tree");
+
+  typedef itk::ComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer filter2 = T2IType::New();
+  filter2->SetInput( maxtree->GetOutput() );
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( filter2->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  return 0;
+}
+
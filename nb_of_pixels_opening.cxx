@@ -44,6 +44,7 @@ int main(int argc, char * argv[])
   T2IType::Pointer filter2 = T2IType::New();
   filter2->SetInput( filter->GetOutput() );
   filter2->SetLambda( atoi( argv[4] ) );
+  filter2->SetFilteringType( T2IType::DIRECT );
 
   typedef itk::ImageFileWriter< IType > WriterType;
   WriterType::Pointer writer = WriterType::New();
@@ -0,0 +1,59 @@
+#include "itkImageFileReader.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkComponentTreeToPatternSpectrumFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc != 4 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity bins" << std::endl;
+    std::cerr << "  inputImage: an input image (up to dim=3)" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  bins: the number of bins of the pattern spectrum" << std::endl;
+    exit(1);
+    }
+
+  const int dim = 3;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[2] ) );
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType > IIType;
+  IIType::Pointer ii = IIType::New();
+  ii->SetInput( maxtree->GetOutput() );
+
+  typedef itk::ComponentTreeToPatternSpectrumFilter< TreeType > SpectrumType;
+  SpectrumType::Pointer spectrum = SpectrumType::New();
+  spectrum->SetInput( ii->GetOutput() );
+  spectrum->SetNumberOfBins( atoi( argv[3] ) );
+  itk::SimpleFilterWatcher watcher(spectrum, "filter");
+  spectrum->Update();
+
+  // print the pattern spectrum and the granulometry curve
+  const SpectrumType::HistogramType * histogram = spectrum->GetOutput();
+  double cumulated = 0;
+  for( unsigned int i=0; i<histogram->Size(); i++ )
+    {
+    cumulated += histogram->GetFrequency( i );
+    std::cout << histogram->GetMeasurement( i, 0 ) << "\t"
+              << histogram->GetFrequency( i ) << "\t"
+              << cumulated << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include "itkImageFileReader.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkCompactnessComponentTreeFilter.h"
+#include "itkComponentTreeToPatternSpectrum2DFilter.h"
+
+namespace itk
+{
+
+namespace Functor {
+
+template< class TComponentTreeNode, class TAttribute, int VIndex >
+class ITK_EXPORT ArrayAttributeComponentTreeNodeAccessor
+{
+public:
+  typedef TComponentTreeNode ComponentTreeNodeType;
+  typedef TAttribute AttributeType;
+  itkStaticConstMacro(Index, unsigned int, VIndex);
+
+  inline const AttributeType operator()( const ComponentTreeNodeType * node )
+    {
+    return node->GetAttribute()[ Index ];
+    }
+
+  inline void operator()( ComponentTreeNodeType * node, const AttributeType & value )
+    {
+    node->GetAttribute()[ Index ] = value;
+    }
+};
+
+}
+
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity sizeBins shapeBins" << std::endl;
+    std::cerr << "  inputImage: an input image." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  sizeBins: the number of bins for the size, spread logarithmically" << std::endl;
+    std::cerr << "  shapeBins: the number of bins for the compactness" << std::endl;
+    exit(1);
+    }
+
+  const int dim = 2;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, itk::FixedArray< double, 2 > > TreeType;
+  typedef TreeType::NodeType NodeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[2] ) );
+
+  typedef itk::Functor::ArrayAttributeComponentTreeNodeAccessor< NodeType, double, 0 > SizeAccessor;
+  typedef itk::Functor::ArrayAttributeComponentTreeNodeAccessor< NodeType, double, 1 > ShapeAccessor;
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType, SizeAccessor > SizeType;
+  SizeType::Pointer size = SizeType::New();
+  size->SetInput( maxtree->GetOutput() );
+
+  typedef itk::CompactnessComponentTreeFilter< TreeType, ShapeAccessor > ShapeType;
+  ShapeType::Pointer shape = ShapeType::New();
+  shape->SetInput( size->GetOutput() );
+
+  typedef itk::ComponentTreeToPatternSpectrum2DFilter< TreeType, SizeAccessor, ShapeAccessor > SpectrumType;
+  SpectrumType::Pointer spectrum = SpectrumType::New();
+  spectrum->SetInput( shape->GetOutput() );
+  SpectrumType::NumberOfBinsType bins;
+  bins[0] = atoi( argv[3] );
+  bins[1] = atoi( argv[4] );
+  spectrum->SetNumberOfBins( bins );
+  itk::SimpleFilterWatcher watcher(spectrum, "filter");
+  spectrum->Update();
+
+  // print the spectrum as a table, with a line per size class
+  const SpectrumType::HistogramType * histogram = spectrum->GetOutput();
+  SpectrumType::HistogramType::IndexType index;
+  index.SetSize( 2 );
+  for( unsigned int b0=0; b0<bins[0]; b0++ )
+    {
+    index[0] = b0;
+    std::cout << histogram->GetBinMin( 0, b0 );
+    for( unsigned int b1=0; b1<bins[1]; b1++ )
+      {
+      index[1] = b1;
+      std::cout << "\t" << histogram->GetFrequency( index );
+      }
+    std::cout << std::endl;
+    }
+  std::cout << "total volume: " << spectrum->GetTotalVolume() << std::endl;
+
+  return 0;
+}
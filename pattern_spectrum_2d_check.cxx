@@ -0,0 +1,176 @@
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMinimumMaximumImageCalculator.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkCompactnessComponentTreeFilter.h"
+#include "itkComponentTreeToPatternSpectrumFilter.h"
+#include "itkComponentTreeToPatternSpectrum2DFilter.h"
+
+namespace itk
+{
+
+namespace Functor {
+
+template< class TComponentTreeNode, class TAttribute, int VIndex >
+class ITK_EXPORT ArrayAttributeComponentTreeNodeAccessor
+{
+public:
+  typedef TComponentTreeNode ComponentTreeNodeType;
+  typedef TAttribute AttributeType;
+  itkStaticConstMacro(Index, unsigned int, VIndex);
+
+  inline const AttributeType operator()( const ComponentTreeNodeType * node )
+    {
+    return node->GetAttribute()[ Index ];
+    }
+
+  inline void operator()( ComponentTreeNodeType * node, const AttributeType & value )
+    {
+    node->GetAttribute()[ Index ] = value;
+    }
+};
+
+}
+
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 6 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity sizeBins shapeBins threads" << std::endl;
+    std::cerr << "  inputImage: an input image (dim=2)." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  sizeBins: the number of bins for the size" << std::endl;
+    std::cerr << "  shapeBins: the number of bins for the compactness" << std::endl;
+    std::cerr << "  threads: the number of threads used to bin the contributions" << std::endl;
+    std::cerr << "Compute the size-shape pattern spectrum of an image, and check it against the" << std::endl;
+    std::cerr << "volume of the image and the 1D size pattern spectrum." << std::endl;
+    exit(1);
+    }
+
+  const int dim = 2;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, itk::FixedArray< double, 2 > > TreeType;
+  typedef TreeType::NodeType NodeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[2] ) );
+
+  typedef itk::Functor::ArrayAttributeComponentTreeNodeAccessor< NodeType, double, 0 > SizeAccessor;
+  typedef itk::Functor::ArrayAttributeComponentTreeNodeAccessor< NodeType, double, 1 > ShapeAccessor;
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType, SizeAccessor > SizeType;
+  SizeType::Pointer size = SizeType::New();
+  size->SetInput( maxtree->GetOutput() );
+
+  typedef itk::CompactnessComponentTreeFilter< TreeType, ShapeAccessor > ShapeType;
+  ShapeType::Pointer shape = ShapeType::New();
+  shape->SetInput( size->GetOutput() );
+  shape->Update();
+
+  typedef itk::MinimumMaximumImageCalculator< IType > MinMaxType;
+  MinMaxType::Pointer minMax = MinMaxType::New();
+  minMax->SetImage( reader->GetOutput() );
+  minMax->ComputeMinimum();
+  double volume = 0;
+  for( itk::ImageRegionConstIterator< IType > it( reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    volume += it.Get() - minMax->GetMinimum();
+    }
+
+  typedef itk::ComponentTreeToPatternSpectrum2DFilter< TreeType, SizeAccessor, ShapeAccessor > Spectrum2DType;
+  Spectrum2DType::NumberOfBinsType bins;
+  bins[0] = atoi( argv[3] );
+  bins[1] = atoi( argv[4] );
+
+  int errors = 0;
+
+  // with the default log binning of the size, all the nodes but the root
+  // are counted, and the image goes down to its minimum
+  Spectrum2DType::Pointer spectrum = Spectrum2DType::New();
+  spectrum->SetInput( shape->GetOutput() );
+  spectrum->SetNumberOfBins( bins );
+  spectrum->SetNumberOfThreads( atoi( argv[5] ) );
+  spectrum->Update();
+
+  double spectrumVolume = 0;
+  for( unsigned long b=0; b<spectrum->GetSpectrum().size(); b++ )
+    {
+    spectrumVolume += spectrum->GetSpectrum()[b];
+    }
+  if( spectrum->GetTotalVolume() != volume || spectrumVolume != volume )
+    {
+    std::cerr << "Wrong volume: " << spectrum->GetTotalVolume() << " and " << spectrumVolume
+              << " in the spectrum instead of " << volume << std::endl;
+    errors++;
+    }
+
+  // with the same linear size bins, the sum of the shape classes is the 1D
+  // size pattern spectrum. The range of the size is a power of 2 to get
+  // the same bins with the two filters, and the compactness is in [0, 1].
+  double sizeMaximum = 1;
+  while( sizeMaximum < reader->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels() )
+    {
+    sizeMaximum *= 2;
+    }
+  Spectrum2DType::LogBinningType logBinning;
+  logBinning.Fill( false );
+  Spectrum2DType::BinBoundType binMinimum;
+  binMinimum.Fill( 0 );
+  Spectrum2DType::BinBoundType binMaximum;
+  binMaximum[0] = sizeMaximum;
+  binMaximum[1] = 1;
+
+  Spectrum2DType::Pointer linearSpectrum = Spectrum2DType::New();
+  linearSpectrum->SetInput( shape->GetOutput() );
+  linearSpectrum->SetNumberOfBins( bins );
+  linearSpectrum->SetNumberOfThreads( atoi( argv[5] ) );
+  linearSpectrum->SetLogBinning( logBinning );
+  linearSpectrum->SetAutoMinimumMaximum( false );
+  linearSpectrum->SetBinMinimum( binMinimum );
+  linearSpectrum->SetBinMaximum( binMaximum );
+  linearSpectrum->Update();
+
+  typedef itk::ComponentTreeToPatternSpectrumFilter< TreeType, SizeAccessor > SpectrumType;
+  SpectrumType::Pointer sizeSpectrum = SpectrumType::New();
+  sizeSpectrum->SetInput( shape->GetOutput() );
+  sizeSpectrum->SetNumberOfBins( bins[0] );
+  sizeSpectrum->SetAutoMinimumMaximum( false );
+  sizeSpectrum->SetBinMinimum( 0 );
+  sizeSpectrum->SetBinMaximum( sizeMaximum );
+  sizeSpectrum->Update();
+
+  for( unsigned int b0=0; b0<bins[0]; b0++ )
+    {
+    double sizeVolume = 0;
+    for( unsigned int b1=0; b1<bins[1]; b1++ )
+      {
+      sizeVolume += linearSpectrum->GetSpectrum()[ b0 + b1 * bins[0] ];
+      }
+    if( sizeVolume != sizeSpectrum->GetSpectrum()[b0] )
+      {
+      std::cerr << "Wrong volume in the size bin " << b0 << ": " << sizeVolume
+                << " instead of " << sizeSpectrum->GetSpectrum()[b0] << std::endl;
+      errors++;
+      }
+    }
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}
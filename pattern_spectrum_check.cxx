@@ -0,0 +1,129 @@
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMinimumMaximumImageCalculator.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkComponentTreeToPatternSpectrumFilter.h"
+#include "itkAttributeFilteringComponentTreeToImageFilter.h"
+#include <cmath>
+
+const int dim = 2;
+typedef unsigned char PType;
+typedef itk::Image< PType, dim > IType;
+typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+// the sum of the pixel values of an image
+double ComputeVolume( const IType * image )
+{
+  double volume = 0;
+  for( itk::ImageRegionConstIterator< IType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    volume += it.Get();
+    }
+  return volume;
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity bins lambda" << std::endl;
+    std::cerr << "  inputImage: an input image (dim=2)" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  bins: the number of bins of the pattern spectrum" << std::endl;
+    std::cerr << "  lambda: the size of an area opening" << std::endl;
+    std::cerr << "Compute the area pattern spectrum of an image, and check it against the volume" << std::endl;
+    std::cerr << "of the image and the volume removed by an area opening." << std::endl;
+    exit(1);
+    }
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[2] ) );
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType > SizeType;
+  SizeType::Pointer size = SizeType::New();
+  size->SetInput( maxtree->GetOutput() );
+  size->Update();
+
+  int errors = 0;
+
+  // the whole spectrum: all the nodes but the root are removed, and the
+  // image goes down to its minimum
+  typedef itk::ComponentTreeToPatternSpectrumFilter< TreeType > SpectrumType;
+  SpectrumType::Pointer spectrum = SpectrumType::New();
+  spectrum->SetInput( size->GetOutput() );
+  spectrum->SetNumberOfBins( atoi( argv[3] ) );
+  spectrum->Update();
+
+  typedef itk::MinimumMaximumImageCalculator< IType > MinMaxType;
+  MinMaxType::Pointer minMax = MinMaxType::New();
+  minMax->SetImage( reader->GetOutput() );
+  minMax->ComputeMinimum();
+  const double volume = ComputeVolume( reader->GetOutput() )
+    - static_cast< double >( minMax->GetMinimum() ) * reader->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+
+  if( spectrum->GetTotalVolume() != volume )
+    {
+    std::cerr << "Wrong total volume: " << spectrum->GetTotalVolume() << " instead of " << volume << std::endl;
+    errors++;
+    }
+
+  double spectrumVolume = 0;
+  double histogramVolume = 0;
+  const SpectrumType::HistogramType * histogram = spectrum->GetOutput();
+  for( unsigned int b=0; b<spectrum->GetSpectrum().size(); b++ )
+    {
+    spectrumVolume += spectrum->GetSpectrum()[b];
+    histogramVolume += histogram->GetFrequency( b );
+    }
+  if( spectrumVolume != volume )
+    {
+    std::cerr << "Wrong volume in the spectrum: " << spectrumVolume << " instead of " << volume << std::endl;
+    errors++;
+    }
+  // each bin is rounded to the nearest integer in the histogram
+  if( std::fabs( histogramVolume - volume ) > 0.5 * histogram->Size() )
+    {
+    std::cerr << "Wrong volume in the histogram: " << histogramVolume << " instead of " << volume << std::endl;
+    errors++;
+    }
+
+  // with the bins [0, lambda) and [lambda, 2 lambda], the first bin is the
+  // volume removed by the area opening of size lambda
+  const unsigned long lambda = atoi( argv[4] );
+  SpectrumType::Pointer lambdaSpectrum = SpectrumType::New();
+  lambdaSpectrum->SetInput( size->GetOutput() );
+  lambdaSpectrum->SetNumberOfBins( 2 );
+  lambdaSpectrum->SetAutoMinimumMaximum( false );
+  lambdaSpectrum->SetBinMinimum( 0 );
+  lambdaSpectrum->SetBinMaximum( 2 * lambda );
+  lambdaSpectrum->Update();
+
+  typedef itk::AttributeFilteringComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer opening = T2IType::New();
+  opening->SetInput( size->GetOutput() );
+  opening->SetLambda( lambda );
+  opening->Update();
+
+  const double removed = ComputeVolume( reader->GetOutput() ) - ComputeVolume( opening->GetOutput() );
+  if( lambdaSpectrum->GetSpectrum()[0] != removed )
+    {
+    std::cerr << "Wrong volume under " << lambda << ": " << lambdaSpectrum->GetSpectrum()[0]
+              << " instead of " << removed << " removed by the opening" << std::endl;
+    errors++;
+    }
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,58 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkComponentTreeToImageFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc != 4 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity" << std::endl;
+    std::cerr << "  inputImage: an input image (up to dim=3)" << std::endl;
+    std::cerr << "  outputImage: the output image, reconstructed from the run-length encoded tree" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    exit(1);
+    }
+    
+  const int dim = 3;
+  
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( reader->GetOutput() );
+  filter->SetFullyConnected( atoi( argv[3] ) );
+  filter->RunLengthEncodingOn();
+  itk::SimpleFilterWatcher watcher(filter, "max-tree");
+  filter->Update();
+
+  TreeType::MemoryFootprintType footprint = filter->GetOutput()->GetMemoryFootprint();
+  std::cout << "Nodes: " << footprint.NumberOfNodes << std::endl;
+  std::cout << "Linked list array: " << footprint.LinkedListArray << " bytes" << std::endl;
+  std::cout << "Runs: " << footprint.Runs << " bytes" << std::endl;
+  std::cout << "Total: " << footprint.Total << " bytes" << std::endl;
+
+  typedef itk::ComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer filter2 = T2IType::New();
+  filter2->SetInput( filter->GetOutput() );
+  itk::SimpleFilterWatcher cWatcher(filter2, "tree to img");
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( filter2->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  return 0;
+}
+
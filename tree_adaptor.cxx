@@ -0,0 +1,70 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+#include "itkExtractImageFilter.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkComponentTreeImageAdaptor.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc != 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity slice" << std::endl;
+    std::cerr << "  inputImage: a 3D input image." << std::endl;
+    std::cerr << "  outputImage: the value of the attribute for the pixels of the slice" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "  slice: the slice to extract on the last axis" << std::endl;
+    exit(1);
+    }
+    
+  const int dim = 3;
+  
+  typedef unsigned short PType;
+  typedef itk::Image< PType, dim > IType;
+  typedef itk::Image< PType, dim-1 > SliceType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[3] ) );
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( maxtree->GetOutput() );
+  itk::SimpleFilterWatcher watcher(filter, "filter");
+  filter->Update();
+
+  // view the attributes of the tree as an image, without producing the
+  // whole attribute image
+  typedef itk::Accessor::ComponentTreeNodeAttributePixelAccessor< TreeType::NodeType, PType > AccessorType;
+  typedef itk::ComponentTreeImageAdaptor< TreeType, AccessorType > AdaptorType;
+  AdaptorType::Pointer adaptor = AdaptorType::New();
+  adaptor->SetComponentTree( filter->GetOutput() );
+
+  IType::RegionType region = adaptor->GetLargestPossibleRegion();
+  region.SetIndex( dim-1, atoi( argv[4] ) );
+  region.SetSize( dim-1, 0 );
+
+  typedef itk::ExtractImageFilter< AdaptorType, SliceType > ExtractType;
+  ExtractType::Pointer extract = ExtractType::New();
+  extract->SetInput( adaptor );
+  extract->SetExtractionRegion( region );
+  itk::SimpleFilterWatcher eWatcher(extract, "extract");
+
+  typedef itk::ImageFileWriter< SliceType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( extract->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  return 0;
+}
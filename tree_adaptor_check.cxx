@@ -0,0 +1,134 @@
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkExtractImageFilter.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToMaximumTreeFilter.h"
+#include "itkNumberOfPixelsComponentTreeFilter.h"
+#include "itkComponentTreeToImageFilter.h"
+#include "itkComponentTreeAttributeToImageFilter.h"
+#include "itkComponentTreeImageAdaptor.h"
+
+// count the pixels which differ in the region of two images of the same size
+template< class TImage1, class TImage2 >
+unsigned long CountDifferences( const TImage1 * image1, const typename TImage1::RegionType & region1,
+                                const TImage2 * image2, const typename TImage2::RegionType & region2 )
+{
+  unsigned long differences = 0;
+  itk::ImageRegionConstIterator< TImage2 > it2( image2, region2 );
+  for( itk::ImageRegionConstIterator< TImage1 > it1( image1, region1 ); !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if( it1.Get() != it2.Get() )
+      {
+      differences++;
+      }
+    }
+  return differences;
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 3 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage connectivity" << std::endl;
+    std::cerr << "  inputImage: an input image (dim=2)." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected, or 0" << std::endl;
+    std::cerr << "View the pixel values and the attributes of a max tree with the adaptor, and" << std::endl;
+    std::cerr << "check them against the images produced by the filters." << std::endl;
+    exit(1);
+    }
+
+  const int dim = 2;
+
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+  typedef unsigned long AType;
+  typedef itk::Image< AType, dim > AIType;
+
+  typedef itk::ComponentTree< PType, dim, AType > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::ImageToMaximumTreeFilter< IType, TreeType > MaxTreeType;
+  MaxTreeType::Pointer maxtree = MaxTreeType::New();
+  maxtree->SetInput( reader->GetOutput() );
+  maxtree->SetFullyConnected( atoi( argv[2] ) );
+
+  typedef itk::NumberOfPixelsComponentTreeFilter< TreeType > SizeType;
+  SizeType::Pointer size = SizeType::New();
+  size->SetInput( maxtree->GetOutput() );
+  size->Update();
+
+  int errors = 0;
+
+  // the pixel values
+  typedef itk::ComponentTreeImageAdaptor< TreeType > ValueAdaptorType;
+  ValueAdaptorType::Pointer valueAdaptor = ValueAdaptorType::New();
+  valueAdaptor->SetComponentTree( size->GetOutput() );
+
+  typedef itk::ComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer t2i = T2IType::New();
+  t2i->SetInput( size->GetOutput() );
+  t2i->Update();
+
+  const IType::RegionType & region = t2i->GetOutput()->GetLargestPossibleRegion();
+  if( valueAdaptor->GetLargestPossibleRegion() != region )
+    {
+    std::cerr << "The region of the adaptor is not the region of the image." << std::endl;
+    return 1;
+    }
+
+  unsigned long differences = CountDifferences( valueAdaptor.GetPointer(), region, t2i->GetOutput(), region );
+  if( differences != 0 )
+    {
+    std::cerr << "The pixel values differ on " << differences << " pixels." << std::endl;
+    errors++;
+    }
+
+  // the adaptor can be used as the input of a filter, here on the center of
+  // the image
+  IType::RegionType centerRegion = region;
+  for( int i=0; i<dim; i++ )
+    {
+    centerRegion.SetIndex( i, region.GetIndex()[i] + region.GetSize()[i] / 4 );
+    centerRegion.SetSize( i, region.GetSize()[i] / 2 );
+    }
+  typedef itk::ExtractImageFilter< ValueAdaptorType, IType > ExtractType;
+  ExtractType::Pointer extract = ExtractType::New();
+  extract->SetInput( valueAdaptor );
+  extract->SetExtractionRegion( centerRegion );
+  extract->Update();
+
+  differences = CountDifferences( extract->GetOutput(), extract->GetOutput()->GetLargestPossibleRegion(), t2i->GetOutput(), centerRegion );
+  if( differences != 0 )
+    {
+    std::cerr << "The extracted pixel values differ on " << differences << " pixels." << std::endl;
+    errors++;
+    }
+
+  // the attributes
+  typedef itk::Accessor::ComponentTreeNodeAttributePixelAccessor< TreeType::NodeType, AType > AccessorType;
+  typedef itk::ComponentTreeImageAdaptor< TreeType, AccessorType > AttributeAdaptorType;
+  AttributeAdaptorType::Pointer attributeAdaptor = AttributeAdaptorType::New();
+  attributeAdaptor->SetComponentTree( size->GetOutput() );
+
+  typedef itk::ComponentTreeAttributeToImageFilter< TreeType, AIType > A2IType;
+  A2IType::Pointer a2i = A2IType::New();
+  a2i->SetInput( size->GetOutput() );
+  a2i->Update();
+
+  differences = CountDifferences( attributeAdaptor.GetPointer(), region, a2i->GetOutput(), region );
+  if( differences != 0 )
+    {
+    std::cerr << "The attributes differ on " << differences << " pixels." << std::endl;
+    errors++;
+    }
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}
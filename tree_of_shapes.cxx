@@ -0,0 +1,56 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToTreeOfShapesFilter.h"
+#include "itkComponentTreeAccumulator.h"
+#include "itkAttributeFilteringComponentTreeToImageFilter.h"
+
+int main(int argc, char * argv[])
+{
+  if( argc != 5 )
+    {
+    std::cerr << "usage: " << argv[0] << " inputImage outputImage connectivity size" << std::endl;
+    std::cerr << "  inputImage: an input image (up to dim=3)." << std::endl;
+    std::cerr << "  outputImage: the filtered image." << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected upper level sets, or 0" << std::endl;
+    std::cerr << "  size: the size of the shapes to remove" << std::endl;
+    exit(1);
+    }
+    
+  const int dim = 3;
+  
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim > IType;
+
+  typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  // the bright and the dark shapes are in the same tree, so removing the
+  // small shapes is a self-dual area filter, and not an opening or a closing
+  typedef itk::Functor::NumberOfPixelsComponentTreeAccumulator< TreeType::NodeType > AccumulatorType;
+  typedef itk::ImageToTreeOfShapesFilter< IType, TreeType, AccumulatorType > TreeOfShapesType;
+  TreeOfShapesType::Pointer tos = TreeOfShapesType::New();
+  tos->SetInput( reader->GetOutput() );
+  tos->SetFullyConnected( atoi( argv[3] ) );
+  itk::SimpleFilterWatcher watcher(tos, "tree of shapes");
+
+  typedef itk::AttributeFilteringComponentTreeToImageFilter< TreeType, IType > T2IType;
+  T2IType::Pointer filter2 = T2IType::New();
+  filter2->SetInput( tos->GetOutput() );
+  filter2->SetLambda( atoi( argv[4] ) );
+  filter2->SetFilteringType( T2IType::DIRECT );
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( filter2->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  return 0;
+}
+
@@ -0,0 +1,175 @@
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include "itkComponentTree.h"
+#include "itkImageToTreeOfShapesFilter.h"
+#include "itkComponentTreeAccumulator.h"
+#include "itkNumericTraits.h"
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+const int dim = 3;
+typedef unsigned char PType;
+typedef itk::Image< PType, dim > IType;
+typedef itk::ComponentTree< PType, dim, unsigned long > TreeType;
+typedef itk::Functor::NumberOfPixelsComponentTreeAccumulator< TreeType::NodeType > AccumulatorType;
+typedef itk::ImageToTreeOfShapesFilter< IType, TreeType, AccumulatorType > TreeOfShapesType;
+
+// the depth, the size and the level of all the nodes, sorted. The levels are
+// inverted when invert is true.
+struct NodeDescription
+{
+  unsigned long Depth;
+  unsigned long Size;
+  int           Level;
+
+  bool operator<( const NodeDescription & other ) const
+    {
+    if( Depth != other.Depth )
+      {
+      return Depth < other.Depth;
+      }
+    if( Size != other.Size )
+      {
+      return Size < other.Size;
+      }
+    return Level < other.Level;
+    }
+
+  bool operator==( const NodeDescription & other ) const
+    {
+    return Depth == other.Depth && Size == other.Size && Level == other.Level;
+    }
+};
+
+std::vector< NodeDescription > DescribeTree( const TreeType * tree, bool invert )
+{
+  std::vector< NodeDescription > description;
+  std::vector< std::pair< const TreeType::NodeType *, unsigned long > > stack;
+  stack.push_back( std::make_pair( tree->GetRoot(), 0ul ) );
+  while( !stack.empty() )
+    {
+    const TreeType::NodeType * node = stack.back().first;
+    const unsigned long depth = stack.back().second;
+    stack.pop_back();
+    NodeDescription d;
+    d.Depth = depth;
+    d.Size = node->GetAttribute();
+    d.Level = invert ? itk::NumericTraits< PType >::max() - node->GetPixel() : node->GetPixel();
+    description.push_back( d );
+    const TreeType::NodeType::ChildrenListType & children = node->GetChildren();
+    for( TreeType::NodeType::ChildrenListType::const_iterator it=children.begin(); it!=children.end(); it++ )
+      {
+      stack.push_back( std::make_pair( *it, depth + 1 ) );
+      }
+    }
+  std::sort( description.begin(), description.end() );
+  return description;
+}
+
+int main(int argc, char * argv[])
+{
+  if( argc != 2 )
+    {
+    std::cerr << "usage: " << argv[0] << " connectivity" << std::endl;
+    std::cerr << "  connectivity: 1 for fully connected upper level sets, or 0" << std::endl;
+    std::cerr << "Build the tree of shapes of a small synthetic image and of its inverse, and" << std::endl;
+    std::cerr << "check them against the known tree." << std::endl;
+    exit(1);
+    }
+
+  const bool fullyConnected = atoi( argv[1] );
+
+  // a bright 5x5 blob on a dark background, with a darker hole of one pixel
+  // in its center. The hole is a shape of the lower level sets, inside the
+  // blob, which is a shape of the upper level sets, inside the background.
+  const PType background = 10;
+  const PType blob = 200;
+  const PType hole = 50;
+
+  IType::IndexType idx;
+  idx.Fill( 0 );
+  IType::SizeType size;
+  size[0] = 9;
+  size[1] = 9;
+  size[2] = 1;
+  IType::RegionType region( idx, size );
+
+  IType::Pointer image = IType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  IType::Pointer inverted = IType::New();
+  inverted->SetRegions( region );
+  inverted->Allocate();
+  for( itk::ImageRegionIteratorWithIndex< IType > it( image, region ); !it.IsAtEnd(); ++it )
+    {
+    const IType::IndexType & i = it.GetIndex();
+    PType value = background;
+    if( i[0] >= 2 && i[0] <= 6 && i[1] >= 2 && i[1] <= 6 )
+      {
+      value = blob;
+      }
+    if( i[0] == 4 && i[1] == 4 )
+      {
+      value = hole;
+      }
+    it.Set( value );
+    inverted->SetPixel( i, itk::NumericTraits< PType >::max() - value );
+    }
+
+  TreeOfShapesType::Pointer tos = TreeOfShapesType::New();
+  tos->SetInput( image );
+  tos->SetFullyConnected( fullyConnected );
+  tos->Update();
+
+  int errors = 0;
+
+  // three nested nodes: the background with all the pixels, the blob with
+  // its hole, and the hole
+  const PType levels[3] = { background, blob, hole };
+  const unsigned long sizes[3] = { 81, 25, 1 };
+  const TreeType::NodeType * node = tos->GetOutput()->GetRoot();
+  for( int n=0; n<3; n++ )
+    {
+    if( node->GetPixel() != levels[n] || node->GetAttribute() != sizes[n] )
+      {
+      std::cerr << "Wrong node at depth " << n << ": level " << (int)node->GetPixel()
+                << ", size " << node->GetAttribute() << " instead of level " << (int)levels[n]
+                << ", size " << sizes[n] << std::endl;
+      errors++;
+      }
+    const unsigned long expectedChildren = n < 2 ? 1 : 0;
+    if( node->GetChildren().size() != expectedChildren )
+      {
+      std::cerr << "The node at depth " << n << " has " << node->GetChildren().size()
+                << " children instead of " << expectedChildren << std::endl;
+      errors++;
+      break;
+      }
+    if( n < 2 )
+      {
+      node = node->GetChildren().front();
+      }
+    }
+
+  // the tree is self-dual: the inverted image gives the same tree, with the
+  // inverted levels. The upper level sets of the inverted image are the
+  // lower level sets of the image, so the connectivity is swapped.
+  TreeOfShapesType::Pointer invertedTos = TreeOfShapesType::New();
+  invertedTos->SetInput( inverted );
+  invertedTos->SetFullyConnected( !fullyConnected );
+  invertedTos->Update();
+
+  if( DescribeTree( tos->GetOutput(), false ) != DescribeTree( invertedTos->GetOutput(), true ) )
+    {
+    std::cerr << "The tree of the inverted image is not the same." << std::endl;
+    errors++;
+    }
+
+  if( errors != 0 )
+    {
+    return 1;
+    }
+  return 0;
+}